@@ -392,6 +392,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=0.01,
     )
 
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Sample lights using a hierarchy that accounts for their distance and orientation to the shading point, "
+        "reducing noise in scenes with many lights",
+        default=False,
+    )
+
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
         description="Automatically reduce the number of samples per pixel based on estimated noise level",
@@ -672,6 +679,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="Use compact BVH structure (uses less ram but renders slower)",
         default=True,
     )
+    debug_use_compressed_bvh: BoolProperty(
+        name="Use Compressed BVH",
+        description="Quantize BVH node bounds and share vertex locations between triangles (uses less ram but renders slower)",
+        default=False,
+    )
     debug_bvh_time_steps: IntProperty(
         name="BVH Time Steps",
         description="Split BVH primitives by this number of time steps to speed up render time in cost of memory",
@@ -809,6 +821,18 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="",
         min=8, max=8192,
     )
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Read image textures from disk on demand, only loading the tiles and mipmap levels used by the render. "
+        "Works best with tiled and mipmapped image files, such as .tx files. Only supported for CPU rendering",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache, in megabytes",
+        default=4096,
+        min=64, max=1048576,
+    )
 
     # Various fine-tuning debug flags
 
@@ -827,6 +851,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Render paths in batches, executing one integrator kernel at a time for all paths of the batch and "
+        "sorting surface shading by shader, instead of tracing one path at a time",
+        default=False,
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
 
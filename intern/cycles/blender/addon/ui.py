@@ -314,6 +314,7 @@ class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
         col.prop(cscene, "min_light_bounces")
         col.prop(cscene, "min_transparent_bounces")
         col.prop(cscene, "light_sampling_threshold", text="Light Threshold")
+        col.prop(cscene, "use_light_tree")
 
         for view_layer in scene.view_layers:
             if view_layer.samples > 0:
@@ -662,6 +663,13 @@ class CYCLES_RENDER_PT_performance_memory(CyclesButtonsPanel, Panel):
         sub.active = cscene.use_auto_tile
         sub.prop(cscene, "tile_size")
 
+        col = layout.column()
+        col.active = use_cpu(context)
+        col.prop(cscene, "use_texture_cache")
+        sub = col.column()
+        sub.active = cscene.use_texture_cache
+        sub.prop(cscene, "texture_cache_size")
+
 
 class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Panel):
     bl_label = "Acceleration Structure"
@@ -695,6 +703,7 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
                 sub.prop(cscene, "debug_bvh_time_steps")
 
                 col.prop(cscene, "debug_use_hair_bvh")
+                col.prop(cscene, "debug_use_compressed_bvh")
 
                 sub = col.column(align=True)
                 sub.label(text="Cycles built without Embree support")
@@ -706,6 +715,7 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
             sub.prop(cscene, "debug_bvh_time_steps")
 
             col.prop(cscene, "debug_use_hair_bvh")
+            col.prop(cscene, "debug_use_compressed_bvh")
 
             # CPU is used in addition to a GPU
             if use_multi_device(context) and use_embree:
@@ -1882,6 +1892,7 @@ class CYCLES_RENDER_PT_debug(CyclesDebugButtonsPanel, Panel):
         row.prop(cscene, "debug_use_cpu_avx", toggle=True)
         row.prop(cscene, "debug_use_cpu_avx2", toggle=True)
         col.prop(cscene, "debug_bvh_layout", text="BVH")
+        col.prop(cscene, "debug_use_cpu_wavefront")
 
         col.separator()
 
@@ -83,10 +83,24 @@ BVHLayout BVHParams::best_bvh_layout(BVHLayout requested_layout, BVHLayoutMask s
 BVH::BVH(const BVHParams &params_,
          const vector<Geometry *> &geometry_,
          const vector<Object *> &objects_)
-    : params(params_), geometry(geometry_), objects(objects_)
+    : params(params_),
+      geometry(geometry_),
+      objects(objects_),
+      build_sah_cost(0.0f),
+      sah_cost(0.0f),
+      num_refits(0)
 {
 }
 
+bool BVH::need_rebuild() const
+{
+  if (build_sah_cost > 0.0f) {
+    return sah_cost > build_sah_cost * params.max_refit_sah_cost_ratio;
+  }
+
+  return num_refits >= params.max_refits;
+}
+
 BVH *BVH::create(const BVHParams &params,
                  const vector<Geometry *> &geometry,
                  const vector<Object *> &objects,
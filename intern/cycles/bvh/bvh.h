@@ -79,6 +79,13 @@ class BVH {
   vector<Geometry *> geometry;
   vector<Object *> objects;
 
+  /* SAH cost after the last build and after the last refit, zero when the layout does not
+   * compute it. */
+  float build_sah_cost;
+  float sah_cost;
+  /* Number of refits since the last build. */
+  int num_refits;
+
   static BVH *create(const BVHParams &params,
                      const vector<Geometry *> &geometry,
                      const vector<Object *> &objects,
@@ -87,6 +94,9 @@ class BVH {
   {
   }
 
+  /* Whether the tree degraded too much from refitting, and should be built again. */
+  bool need_rebuild() const;
+
  protected:
   BVH(const BVHParams &params,
       const vector<Geometry *> &geometry,
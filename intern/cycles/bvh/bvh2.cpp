@@ -68,6 +68,10 @@ void BVH2::build(Progress &progress, Stats *)
     return;
   }
 
+  /* Reference cost to detect when refitting degraded the tree. */
+  build_sah_cost = sah_cost = bvh2_root->computeSubtreeSAHCost(params);
+  num_refits = 0;
+
   /* BVH builder returns tree in a binary mode (with two children per inner
    * node. Need to adopt that for a wider BVH implementations. */
   BVHNode *root = widen_children_nodes(bvh2_root);
@@ -101,14 +105,19 @@ void BVH2::build(Progress &progress, Stats *)
 
 void BVH2::refit(Progress &progress)
 {
-  progress.set_substatus("Packing BVH primitives");
-  pack_primitives();
-
-  if (progress.get_cancel())
-    return;
+  /* The top level BVH also contains the primitives of instances, packed with the visibility of
+   * their geometry BVH. Visibility changes of objects are handled by building it again. */
+  if (!params.top_level) {
+    progress.set_substatus("Packing BVH primitives");
+    pack_primitives();
+
+    if (progress.get_cancel())
+      return;
+  }
 
   progress.set_substatus("Refitting BVH nodes");
   refit_nodes();
+  num_refits++;
 }
 
 BVHNode *BVH2::widen_children_nodes(const BVHNode *root)
@@ -170,6 +179,11 @@ void BVH2::pack_aligned_node(int idx,
                              uint visibility0,
                              uint visibility1)
 {
+  if (params.use_compressed_nodes) {
+    pack_compressed_node(idx, b0, b1, c0, c1, visibility0, visibility1);
+    return;
+  }
+
   assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
   assert(c0 < 0 || c0 < pack.nodes.size());
   assert(c1 < 0 || c1 < pack.nodes.size());
@@ -194,6 +208,75 @@ void BVH2::pack_aligned_node(int idx,
   memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH_NODE_SIZE);
 }
 
+void BVH2::pack_compressed_node(int idx,
+                                const BoundBox &b0,
+                                const BoundBox &b1,
+                                int c0,
+                                int c1,
+                                uint visibility0,
+                                uint visibility1)
+{
+  assert(idx + BVH_COMPRESSED_NODE_SIZE <= pack.nodes.size());
+  assert(c0 < 0 || c0 < pack.nodes.size());
+  assert(c1 < 0 || c1 < pack.nodes.size());
+
+  BoundBox bounds = merge(b0, b1);
+  if (!bounds.valid()) {
+    bounds = BoundBox(zero_float3());
+  }
+
+  /* Child bounds are stored as 8 bit offsets from the lower corner of the node, in units of a
+   * power of two scale per axis. The scale is stored as a biased float exponent, so the kernel can
+   * build it with a shift and the products are exact. */
+  float scale[3];
+  uint exponents = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    int exponent;
+    frexpf((bounds.max[axis] - bounds.min[axis]) / 255.0f, &exponent);
+    uint biased = (uint)clamp(exponent + 127, 1, 254);
+    while (biased < 254 &&
+           bounds.min[axis] + 255.0f * __uint_as_float(biased << 23) < bounds.max[axis]) {
+      biased++;
+    }
+    scale[axis] = __uint_as_float(biased << 23);
+    exponents |= biased << (axis * 8);
+  }
+
+  /* Round child bounds outwards, also accounting for rounding of the addition in the kernel. */
+  const BoundBox *child_bounds[2] = {&b0, &b1};
+  uint quantized[3] = {0, 0, 0};
+  for (int child = 0; child < 2; child++) {
+    const BoundBox &b = *child_bounds[child];
+    for (int axis = 0; axis < 3; axis++) {
+      const float origin = bounds.min[axis];
+      int lo = 0, hi = 255;
+      if (b.valid()) {
+        lo = clamp((int)floorf((b.min[axis] - origin) / scale[axis]), 0, 255);
+        hi = clamp((int)ceilf((b.max[axis] - origin) / scale[axis]), 0, 255);
+        while (lo > 0 && origin + lo * scale[axis] > b.min[axis]) {
+          lo--;
+        }
+        while (hi < 255 && origin + hi * scale[axis] < b.max[axis]) {
+          hi++;
+        }
+      }
+      quantized[axis] |= ((uint)lo << (child * 8)) | ((uint)hi << (16 + child * 8));
+    }
+  }
+
+  int4 data[BVH_COMPRESSED_NODE_SIZE] = {
+      make_int4(
+          visibility0 & ~PATH_RAY_NODE_UNALIGNED, visibility1 & ~PATH_RAY_NODE_UNALIGNED, c0, c1),
+      make_int4(__float_as_int(bounds.min.x),
+                __float_as_int(bounds.min.y),
+                __float_as_int(bounds.min.z),
+                (int)exponents),
+      make_int4((int)quantized[0], (int)quantized[1], (int)quantized[2], 0),
+  };
+
+  memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH_COMPRESSED_NODE_SIZE);
+}
+
 void BVH2::pack_unaligned_inner(const BVHStackEntry &e,
                                 const BVHStackEntry &e0,
                                 const BVHStackEntry &e1)
@@ -251,10 +334,10 @@ void BVH2::pack_nodes(const BVHNode *root)
   if (params.use_unaligned_nodes) {
     const size_t num_unaligned_nodes = root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_COUNT);
     node_size = (num_unaligned_nodes * BVH_UNALIGNED_NODE_SIZE) +
-                (num_inner_nodes - num_unaligned_nodes) * BVH_NODE_SIZE;
+                (num_inner_nodes - num_unaligned_nodes) * aligned_node_size();
   }
   else {
-    node_size = num_inner_nodes * BVH_NODE_SIZE;
+    node_size = num_inner_nodes * aligned_node_size();
   }
   /* Resize arrays */
   pack.nodes.clear();
@@ -277,7 +360,7 @@ void BVH2::pack_nodes(const BVHNode *root)
   }
   else {
     stack.push_back(BVHStackEntry(root, nextNodeIdx));
-    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : BVH_NODE_SIZE;
+    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : aligned_node_size();
   }
 
   while (stack.size()) {
@@ -299,7 +382,7 @@ void BVH2::pack_nodes(const BVHNode *root)
         else {
           idx[i] = nextNodeIdx;
           nextNodeIdx += e.node->get_child(i)->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE :
-                                                                 BVH_NODE_SIZE;
+                                                                 aligned_node_size();
         }
       }
 
@@ -316,11 +399,13 @@ void BVH2::pack_nodes(const BVHNode *root)
 
 void BVH2::refit_nodes()
 {
-  assert(!params.top_level);
-
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
+  sah_cost = 0.0f;
   refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+
+  const float root_area = bbox.safe_area();
+  sah_cost = (root_area > 0.0f) ? sah_cost / root_area : 0.0f;
 }
 
 void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
@@ -332,7 +417,15 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c0 = data[0].x;
     const int c1 = data[0].y;
 
-    refit_primitives(c0, c1, bbox, visibility);
+    if (c0 < 0) {
+      /* Object instance in the top level BVH. */
+      refit_primitives(~c0, ~c0 + 1, bbox, visibility);
+      sah_cost += bbox.safe_area() * params.primitive_cost(1);
+    }
+    else {
+      refit_primitives(c0, c1, bbox, visibility);
+      sah_cost += bbox.safe_area() * params.primitive_cost(c1 - c0);
+    }
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -343,7 +436,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     memcpy(&pack.leaf_nodes[idx], leaf_data, sizeof(float4) * BVH_NODE_LEAF_SIZE);
   }
   else {
-    assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
+    assert(idx + aligned_node_size() <= pack.nodes.size());
 
     const int4 *data = &pack.nodes[idx];
     const bool is_unaligned = (data[0].x & PATH_RAY_NODE_UNALIGNED) != 0;
@@ -368,6 +461,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     bbox.grow(bbox0);
     bbox.grow(bbox1);
     visibility = visibility0 | visibility1;
+    sah_cost += bbox.safe_area() * params.node_cost(2);
   }
 }
 
@@ -628,7 +722,7 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
           nsize_bbox = 0;
         }
         else {
-          nsize = BVH_NODE_SIZE;
+          nsize = aligned_node_size();
           nsize_bbox = 0;
         }
 
@@ -27,6 +27,7 @@
 CCL_NAMESPACE_BEGIN
 
 #define BVH_NODE_SIZE 4
+#define BVH_COMPRESSED_NODE_SIZE 3
 #define BVH_NODE_LEAF_SIZE 1
 #define BVH_UNALIGNED_NODE_SIZE 7
 
@@ -76,6 +77,19 @@ class BVH2 : public BVH {
                          int c1,
                          uint visibility0,
                          uint visibility1);
+  void pack_compressed_node(int idx,
+                            const BoundBox &b0,
+                            const BoundBox &b1,
+                            int c0,
+                            int c1,
+                            uint visibility0,
+                            uint visibility1);
+
+  /* Size of nodes with axis aligned bounds, which are compressed or not. */
+  int aligned_node_size() const
+  {
+    return params.use_compressed_nodes ? BVH_COMPRESSED_NODE_SIZE : BVH_NODE_SIZE;
+  }
 
   void pack_unaligned_inner(const BVHStackEntry &e,
                             const BVHStackEntry &e0,
@@ -439,6 +439,8 @@ void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
 
   rtcSetSceneProgressMonitorFunction(scene, rtc_progress_func, &progress);
   rtcCommitScene(scene);
+
+  num_refits = 0;
 }
 
 void BVHEmbree::add_object(Object *ob, int i)
@@ -470,12 +472,24 @@ void BVHEmbree::add_instance(Object *ob, int i)
   BVHEmbree *instance_bvh = (BVHEmbree *)(ob->get_geometry()->bvh);
   assert(instance_bvh != NULL);
 
+  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
+  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
+  set_instance_transform(geom_id, ob);
+
+  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
+  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
+
+  rtcCommitGeometry(geom_id);
+  rtcAttachGeometryByID(scene, geom_id, i * 2);
+  rtcReleaseGeometry(geom_id);
+}
+
+void BVHEmbree::set_instance_transform(RTCGeometry geom_id, const Object *ob)
+{
   const size_t num_object_motion_steps = ob->use_motion() ? ob->get_motion().size() : 1;
   const size_t num_motion_steps = min(num_object_motion_steps, RTC_MAX_TIME_STEP_COUNT);
   assert(num_object_motion_steps <= RTC_MAX_TIME_STEP_COUNT);
 
-  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
-  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
   if (ob->use_motion()) {
@@ -499,13 +513,6 @@ void BVHEmbree::add_instance(Object *ob, int i)
     rtcSetGeometryTransform(
         geom_id, 0, RTC_FORMAT_FLOAT3X4_ROW_MAJOR, (const float *)&ob->get_tfm());
   }
-
-  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
-  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
-
-  rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
 }
 
 void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
@@ -830,7 +837,9 @@ void BVHEmbree::refit(Progress &progress)
 {
   progress.set_substatus("Refitting BVH nodes");
 
-  /* Update all vertex buffers, then tell Embree to rebuild/-fit the BVHs. */
+  /* Update all vertex buffers and instance transforms, then tell Embree to refit the BVHs.
+   * Refitting keeps the structure of the BVH, which is only supported for triangles, other
+   * geometry is rebuilt with the same quality as before. */
   unsigned geom_id = 0;
   foreach (Object *ob, objects) {
     if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
@@ -842,6 +851,7 @@ void BVHEmbree::refit(Progress &progress)
           RTCGeometry geom = rtcGetGeometry(scene, geom_id);
           set_tri_vertex_buffer(geom, mesh, true);
           rtcSetGeometryUserData(geom, (void *)mesh->prim_offset);
+          rtcSetGeometryBuildQuality(geom, RTC_BUILD_QUALITY_REFIT);
           rtcCommitGeometry(geom);
         }
       }
@@ -863,10 +873,17 @@ void BVHEmbree::refit(Progress &progress)
         }
       }
     }
+    else if (ob->is_traceable()) {
+      /* Instance, its geometry BVH was already refit or rebuilt. */
+      RTCGeometry geom = rtcGetGeometry(scene, geom_id);
+      set_instance_transform(geom, ob);
+      rtcCommitGeometry(geom);
+    }
     geom_id += 2;
   }
 
   rtcCommitScene(scene);
+  num_refits++;
 }
 
 CCL_NAMESPACE_END
@@ -77,6 +77,12 @@ class BVHParams {
   float sah_node_cost;
   float sah_primitive_cost;
 
+  /* Refitting keeps the structure of the tree while primitives move, rebuild once the SAH cost
+   * grew by this factor compared to the last build. Layouts which do not compute the SAH cost
+   * are rebuilt after a fixed number of refits instead. */
+  float max_refit_sah_cost_ratio;
+  int max_refits;
+
   /* number of primitives in leaf */
   int min_leaf_size;
   int max_triangle_leaf_size;
@@ -100,6 +106,10 @@ class BVHParams {
   /* Use compact acceleration structure (Embree)*/
   bool use_compact_structure;
 
+  /* Quantize the bounds of the two children of BVH2 nodes relative to their merged bounds, to use
+   * less memory at the cost of looser bounds. */
+  bool use_compressed_nodes;
+
   /* Split time range to this number of steps and create leaf node for each
    * of this time steps.
    *
@@ -132,6 +142,9 @@ class BVHParams {
     sah_node_cost = 1.0f;
     sah_primitive_cost = 1.0f;
 
+    max_refit_sah_cost_ratio = 1.5f;
+    max_refits = 16;
+
     min_leaf_size = 1;
     max_triangle_leaf_size = 8;
     max_motion_triangle_leaf_size = 8;
@@ -143,6 +156,7 @@ class BVHParams {
     top_level = false;
     bvh_layout = BVH_LAYOUT_BVH2;
     use_unaligned_nodes = false;
+    use_compressed_nodes = false;
 
     num_motion_curve_steps = 0;
     num_motion_triangle_steps = 0;
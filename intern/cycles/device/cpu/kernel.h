@@ -25,6 +25,7 @@ CCL_NAMESPACE_BEGIN
 struct KernelGlobalsCPU;
 struct KernelFilmConvert;
 struct IntegratorStateCPU;
+struct IntegratorShadowStateCPU;
 struct TileInfo;
 
 class CPUKernels {
@@ -35,6 +36,12 @@ class CPUKernels {
       CPUKernelFunction<void (*)(const KernelGlobalsCPU *kg, IntegratorStateCPU *state)>;
   using IntegratorShadeFunction = CPUKernelFunction<void (*)(
       const KernelGlobalsCPU *kg, IntegratorStateCPU *state, ccl_global float *render_buffer)>;
+  using IntegratorShadowFunction =
+      CPUKernelFunction<void (*)(const KernelGlobalsCPU *kg, IntegratorShadowStateCPU *state)>;
+  using IntegratorShadowShadeFunction =
+      CPUKernelFunction<void (*)(const KernelGlobalsCPU *kg,
+                                 IntegratorShadowStateCPU *state,
+                                 ccl_global float *render_buffer)>;
   using IntegratorInitFunction = CPUKernelFunction<bool (*)(const KernelGlobalsCPU *kg,
                                                             IntegratorStateCPU *state,
                                                             KernelWorkTile *tile,
@@ -43,13 +50,14 @@ class CPUKernels {
   IntegratorInitFunction integrator_init_from_camera;
   IntegratorInitFunction integrator_init_from_bake;
   IntegratorShadeFunction integrator_intersect_closest;
-  IntegratorFunction integrator_intersect_shadow;
+  IntegratorShadowFunction integrator_intersect_shadow;
   IntegratorFunction integrator_intersect_subsurface;
   IntegratorFunction integrator_intersect_volume_stack;
   IntegratorShadeFunction integrator_shade_background;
   IntegratorShadeFunction integrator_shade_light;
-  IntegratorShadeFunction integrator_shade_shadow;
+  IntegratorShadowShadeFunction integrator_shade_shadow;
   IntegratorShadeFunction integrator_shade_surface;
+  IntegratorShadeFunction integrator_shade_surface_raytrace;
   IntegratorShadeFunction integrator_shade_volume;
   IntegratorShadeFunction integrator_megakernel;
 
@@ -18,6 +18,7 @@
 
 #include "device/cpu/kernel.h"
 #include "device/device.h"
+#include "device/kernel.h"
 
 #include "kernel/integrator/path_state.h"
 
@@ -27,7 +28,9 @@
 #include "scene/scene.h"
 #include "session/buffers.h"
 
+#include "util/algorithm.h"
 #include "util/atomic.h"
+#include "util/debug.h"
 #include "util/log.h"
 #include "util/tbb.h"
 
@@ -53,6 +56,23 @@ static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
   return &kernel_thread_globals[thread_index];
 }
 
+/* Get the wavefront integrator states for the current thread. */
+static inline array<IntegratorStateCPU> &wavefront_integrator_states_get(
+    vector<array<IntegratorStateCPU>> &wavefront_integrator_states)
+{
+  const int thread_index = tbb::this_task_arena::current_thread_index();
+  DCHECK_GE(thread_index, 0);
+  DCHECK_LE(thread_index, wavefront_integrator_states.size());
+
+  return wavefront_integrator_states[thread_index];
+}
+
+/* Number of pixels rendered together by the wavefront path tracing. Large enough to have many
+ * paths to sort by shader. The states of the paths do not fit into the CPU caches at this size
+ * (every state holds the intersections of its shadow paths), but only a few of their members are
+ * accessed for scheduling, the rest is only touched by the kernel executing the path. */
+static const int64_t wavefront_batch_size = 256;
+
 PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
                                    Film *film,
                                    DeviceScene *device_scene,
@@ -67,6 +87,10 @@ void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  /* States are allocated on first use, only when rendering in wavefront mode. */
+  wavefront_integrator_states_.clear();
+  wavefront_integrator_states_.resize(kernel_thread_globals_.size());
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -85,31 +109,47 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   }
 
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    tbb::parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
+  if (DebugFlags().cpu.use_wavefront) {
+    const int64_t batches_num = divide_up(total_pixels_num, wavefront_batch_size);
+    local_arena.execute([&]() {
+      tbb::parallel_for(int64_t(0), batches_num, [&](int64_t batch_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const int64_t start_work_index = batch_index * wavefront_batch_size;
+        const int work_size = min(wavefront_batch_size, total_pixels_num - start_work_index);
+
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        array<IntegratorStateCPU> &integrator_states = wavefront_integrator_states_get(
+            wavefront_integrator_states_);
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+        render_samples_wavefront(kernel_globals,
+                                 integrator_states,
+                                 start_work_index,
+                                 work_size,
+                                 start_sample,
+                                 samples_num,
+                                 sample_offset);
+      });
+    });
+  }
+  else {
+    local_arena.execute([&]() {
+      tbb::parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+        const KernelWorkTile work_tile = get_pixel_work_tile(
+            work_index, start_sample, sample_offset);
 
-      CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+        render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+      });
     });
-  });
+  }
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
       kernel_globals.stop_profiling();
@@ -119,6 +159,28 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   statistics.occupancy = 1.0f;
 }
 
+KernelWorkTile PathTraceWorkCPU::get_pixel_work_tile(const int64_t work_index,
+                                                     const int start_sample,
+                                                     const int sample_offset) const
+{
+  const int64_t image_width = effective_buffer_params_.width;
+  const int y = work_index / image_width;
+  const int x = work_index - y * image_width;
+
+  KernelWorkTile work_tile;
+  work_tile.x = effective_buffer_params_.full_x + x;
+  work_tile.y = effective_buffer_params_.full_y + y;
+  work_tile.w = 1;
+  work_tile.h = 1;
+  work_tile.start_sample = start_sample;
+  work_tile.sample_offset = sample_offset;
+  work_tile.num_samples = 1;
+  work_tile.offset = effective_buffer_params_.offset;
+  work_tile.stride = effective_buffer_params_.stride;
+
+  return work_tile;
+}
+
 void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_globals,
                                                     const KernelWorkTile &work_tile,
                                                     const int samples_num)
@@ -166,6 +228,183 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_glo
   }
 }
 
+void PathTraceWorkCPU::render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                                array<IntegratorStateCPU> &integrator_states,
+                                                const int64_t start_work_index,
+                                                const int work_size,
+                                                const int start_sample,
+                                                const int samples_num,
+                                                const int sample_offset)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+
+  /* The shadow catcher splits the path into the state which directly follows it. */
+  const int state_stride = (device_scene_->data.integrator.has_shadow_catcher) ? 2 : 1;
+
+  const int num_states = work_size * state_stride;
+
+  /* Only grow the storage, batches at the end of the image are smaller. */
+  const size_t num_states_alloc = wavefront_batch_size * state_stride;
+  if (integrator_states.size() < num_states_alloc) {
+    integrator_states.resize(num_states_alloc);
+  }
+
+  bool pixel_active[wavefront_batch_size];
+  std::fill(pixel_active, pixel_active + work_size, true);
+
+  float *render_buffer = buffers_->buffer.data();
+
+  for (int sample = 0; sample < samples_num; ++sample) {
+    if (is_cancel_requested()) {
+      break;
+    }
+
+    bool has_active_pixels = false;
+
+    for (int i = 0; i < work_size; ++i) {
+      if (!pixel_active[i]) {
+        continue;
+      }
+
+      IntegratorStateCPU *state = &integrator_states[i * state_stride];
+      if (state_stride == 2) {
+        path_state_init_queues(state + 1);
+      }
+
+      KernelWorkTile work_tile = get_pixel_work_tile(
+          start_work_index + i, start_sample + sample, sample_offset);
+
+      if (has_bake) {
+        pixel_active[i] = kernels_.integrator_init_from_bake(
+            kernel_globals, state, &work_tile, render_buffer);
+      }
+      else {
+        pixel_active[i] = kernels_.integrator_init_from_camera(
+            kernel_globals, state, &work_tile, render_buffer);
+      }
+
+      has_active_pixels |= pixel_active[i];
+    }
+
+    if (!has_active_pixels) {
+      break;
+    }
+
+    render_wavefront(kernel_globals, integrator_states.data(), num_states, render_buffer);
+  }
+}
+
+void PathTraceWorkCPU::render_wavefront(KernelGlobalsCPU *kernel_globals,
+                                        IntegratorStateCPU *integrator_states,
+                                        const int num_states,
+                                        float *render_buffer)
+{
+  /* Pairs of sort key and path index, for the paths queued for the kernel being executed. */
+  vector<std::pair<uint32_t, int>> queued_paths;
+  queued_paths.reserve(num_states);
+
+  while (true) {
+    /* Handle all shadow and AO paths before the main paths potentially create more of them, same
+     * as the megakernel. Shadow paths through transparent surfaces alternate between the two
+     * kernels. */
+    bool has_shadow_paths = true;
+    while (has_shadow_paths) {
+      has_shadow_paths = false;
+
+      for (int i = 0; i < num_states; i++) {
+        IntegratorStateCPU &state = integrator_states[i];
+        for (IntegratorShadowStateCPU *shadow_state : {&state.shadow, &state.ao}) {
+          if (shadow_state->shadow_path.queued_kernel ==
+              DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW) {
+            kernels_.integrator_intersect_shadow(kernel_globals, shadow_state);
+          }
+        }
+      }
+
+      for (int i = 0; i < num_states; i++) {
+        IntegratorStateCPU &state = integrator_states[i];
+        for (IntegratorShadowStateCPU *shadow_state : {&state.shadow, &state.ao}) {
+          if (shadow_state->shadow_path.queued_kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW) {
+            kernels_.integrator_shade_shadow(kernel_globals, shadow_state, render_buffer);
+          }
+          has_shadow_paths |= (shadow_state->shadow_path.queued_kernel != 0);
+        }
+      }
+    }
+
+    /* Execute the kernel with the most queued paths, same as the GPU scheduling. */
+    int num_queued[DEVICE_KERNEL_INTEGRATOR_NUM] = {0};
+    for (int i = 0; i < num_states; i++) {
+      num_queued[integrator_states[i].path.queued_kernel]++;
+    }
+
+    DeviceKernel kernel = DEVICE_KERNEL_NUM;
+    int max_num_queued = 0;
+    /* Zero is used for terminated paths. */
+    for (int i = 1; i < DEVICE_KERNEL_INTEGRATOR_NUM; i++) {
+      if (num_queued[i] > max_num_queued) {
+        kernel = (DeviceKernel)i;
+        max_num_queued = num_queued[i];
+      }
+    }
+
+    if (max_num_queued == 0) {
+      break;
+    }
+
+    queued_paths.clear();
+    for (int i = 0; i < num_states; i++) {
+      const IntegratorStateCPU &state = integrator_states[i];
+      if (state.path.queued_kernel == kernel) {
+        queued_paths.emplace_back(state.path.shader_sort_key, i);
+      }
+    }
+
+    /* Sort surface shading by shader, so paths running the same shader nodes are executed
+     * together for better instruction cache and texture access coherence. */
+    if (kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE ||
+        kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE ||
+        kernel == DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE) {
+      std::sort(queued_paths.begin(), queued_paths.end());
+    }
+
+    for (const std::pair<uint32_t, int> &queued_path : queued_paths) {
+      IntegratorStateCPU *state = &integrator_states[queued_path.second];
+
+      switch (kernel) {
+        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+          kernels_.integrator_intersect_closest(kernel_globals, state, render_buffer);
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+          kernels_.integrator_shade_background(kernel_globals, state, render_buffer);
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+          kernels_.integrator_shade_surface(kernel_globals, state, render_buffer);
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+          kernels_.integrator_shade_volume(kernel_globals, state, render_buffer);
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+          kernels_.integrator_shade_surface_raytrace(kernel_globals, state, render_buffer);
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+          kernels_.integrator_shade_light(kernel_globals, state, render_buffer);
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
+          kernels_.integrator_intersect_subsurface(kernel_globals, state);
+          break;
+        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+          kernels_.integrator_intersect_volume_stack(kernel_globals, state);
+          break;
+        default:
+          LOG(FATAL) << "Unhandled kernel " << device_kernel_as_string(kernel)
+                     << " used for path iteration, should never happen.";
+          return;
+      }
+    }
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        int num_samples)
@@ -23,6 +23,7 @@
 
 #include "integrator/path_trace_work.h"
 
+#include "util/array.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -69,6 +70,27 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Render given range of pixels in batches: the integrator kernels are executed for all paths
+   * queued for them at once rather than for one path at a time, with surface shading sorted by
+   * shader. */
+  void render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                array<IntegratorStateCPU> &integrator_states,
+                                const int64_t start_work_index,
+                                const int work_size,
+                                const int start_sample,
+                                const int samples_num,
+                                const int sample_offset);
+  void render_wavefront(KernelGlobalsCPU *kernel_globals,
+                        IntegratorStateCPU *integrator_states,
+                        const int num_states,
+                        float *render_buffer);
+
+  /* Work tile of a single pixel, with the work index being the pixel index within the effective
+   * buffer. */
+  KernelWorkTile get_pixel_work_tile(const int64_t work_index,
+                                     const int start_sample,
+                                     const int sample_offset) const;
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -78,6 +100,12 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Integrator states of the wavefront path tracing, local to each thread in the same way as
+   * `kernel_thread_globals_`. Allocated on first use and kept for all the following batches and
+   * render calls. The memory is not cleared: the integrator initializes the state of every path
+   * of a batch before it is used, the same as the states on the stack of the megakernel. */
+  vector<array<IntegratorStateCPU>> wavefront_integrator_states_;
 };
 
 CCL_NAMESPACE_END
@@ -583,11 +583,41 @@ template<typename T> struct NanoVDBInterpolator {
 
 #undef SET_CUBIC_SPLINE_WEIGHTS
 
+/* Image read on demand through the OpenImageIO texture system. The mipmap level is selected from
+ * the derivatives of the texture coordinates, zero derivatives use the full resolution. */
+ccl_device float4 kernel_tex_image_interp_texture_cache(const TextureInfo &info,
+                                                        float x,
+                                                        float y,
+                                                        const float2 duv_dx,
+                                                        const float2 duv_dy)
+{
+  const TextureCacheInfo *cache_info = (const TextureCacheInfo *)info.data;
+
+  float result[4];
+  if (!cache_info->lookup(cache_info,
+                          info.interpolation,
+                          info.extension,
+                          x,
+                          y,
+                          duv_dx.x,
+                          duv_dx.y,
+                          duv_dy.x,
+                          duv_dy.y,
+                          result)) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return make_float4(result[0], result[1], result[2], result[3]);
+}
+
 ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, float y)
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
 
   switch (info.data_type) {
+    case IMAGE_DATA_TYPE_OIIO:
+      return kernel_tex_image_interp_texture_cache(info, x, y, zero_float2(), zero_float2());
     case IMAGE_DATA_TYPE_HALF:
       return TextureInterpolator<half>::interp(info, x, y);
     case IMAGE_DATA_TYPE_BYTE:
@@ -611,6 +641,19 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
   }
 }
 
+/* Same as above, with the derivatives of the texture coordinates for filtering. */
+ccl_device float4 kernel_tex_image_interp(
+    KernelGlobals kg, int id, float x, float y, const float2 duv_dx, const float2 duv_dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+
+  if (info.data_type == IMAGE_DATA_TYPE_OIIO) {
+    return kernel_tex_image_interp_texture_cache(info, x, y, duv_dx, duv_dy);
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              int id,
                                              float3 P,
@@ -98,16 +98,17 @@ CCL_NAMESPACE_BEGIN
 
 #define DEFINE_INTEGRATOR_SHADOW_KERNEL(name) \
   void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const KernelGlobalsCPU *kg, \
-                                                    IntegratorStateCPU *state) \
+                                                    IntegratorShadowStateCPU *state) \
   { \
-    KERNEL_INVOKE(name, kg, &state->shadow); \
+    KERNEL_INVOKE(name, kg, state); \
   }
 
 #define DEFINE_INTEGRATOR_SHADOW_SHADE_KERNEL(name) \
-  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)( \
-      const KernelGlobalsCPU *kg, IntegratorStateCPU *state, ccl_global float *render_buffer) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const KernelGlobalsCPU *kg, \
+                                                    IntegratorShadowStateCPU *state, \
+                                                    ccl_global float *render_buffer) \
   { \
-    KERNEL_INVOKE(name, kg, &state->shadow, render_buffer); \
+    KERNEL_INVOKE(name, kg, state, render_buffer); \
   }
 
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_camera)
@@ -118,6 +119,7 @@ DEFINE_INTEGRATOR_KERNEL(intersect_volume_stack)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_background)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_light)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface)
+DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface_raytrace)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_volume)
 DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
 DEFINE_INTEGRATOR_SHADOW_KERNEL(intersect_shadow)
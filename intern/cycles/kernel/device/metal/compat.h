@@ -203,6 +203,9 @@ void kernel_gpu_##name::run(thread MetalKernelContext& context, \
 #ifdef make_int4
 #  undef make_int4
 #endif
+#ifdef make_uint3
+#  undef make_uint3
+#endif
 #ifdef make_uchar4
 #  undef make_uchar4
 #endif
@@ -213,6 +216,7 @@ void kernel_gpu_##name::run(thread MetalKernelContext& context, \
 #define make_int2(x, y) int2(x, y)
 #define make_int3(x, y, z) int3(x, y, z)
 #define make_int4(x, y, z, w) int4(x, y, z, w)
+#define make_uint3(x, y, z) uint3(x, y, z)
 #define make_uchar4(x, y, z, w) uchar4(x, y, z, w)
 
 /* Math functions */
@@ -132,10 +132,14 @@ TReturn metalrt_local_hit(constant KernelParamsMetal &launch_params_metal,
   isect->v = barycentrics.x;
 
   /* Record geometric normal */
-  const uint tri_vindex = kernel_tex_fetch(__tri_vindex, isect->prim).w;
-  const float3 tri_a = float3(kernel_tex_fetch(__tri_verts, tri_vindex + 0));
-  const float3 tri_b = float3(kernel_tex_fetch(__tri_verts, tri_vindex + 1));
-  const float3 tri_c = float3(kernel_tex_fetch(__tri_verts, tri_vindex + 2));
+  const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, isect->prim);
+  const uint3 tri_vert_index =
+      (kernel_data.bvh.use_shared_tri_verts) ?
+          make_uint3(tri_vindex.x, tri_vindex.y, tri_vindex.z) :
+          make_uint3(tri_vindex.w + 0, tri_vindex.w + 1, tri_vindex.w + 2);
+  const float3 tri_a = float3(kernel_tex_fetch(__tri_verts, tri_vert_index.x));
+  const float3 tri_b = float3(kernel_tex_fetch(__tri_verts, tri_vert_index.y));
+  const float3 tri_c = float3(kernel_tex_fetch(__tri_verts, tri_vert_index.z));
   payload.local_isect.Ng[hit] = normalize(cross(tri_b - tri_a, tri_c - tri_a));
 
   /* Continue tracing (without this the trace call would return after the first hit) */
@@ -171,10 +171,10 @@ extern "C" __global__ void __anyhit__kernel_optix_local_hit()
   isect->v = barycentrics.x;
 
   /* Record geometric normal. */
-  const uint tri_vindex = kernel_tex_fetch(__tri_vindex, prim).w;
-  const float3 tri_a = kernel_tex_fetch(__tri_verts, tri_vindex + 0);
-  const float3 tri_b = kernel_tex_fetch(__tri_verts, tri_vindex + 1);
-  const float3 tri_c = kernel_tex_fetch(__tri_verts, tri_vindex + 2);
+  const uint3 tri_vert_index = triangle_vert_index(nullptr, kernel_tex_fetch(__tri_vindex, prim));
+  const float3 tri_a = kernel_tex_fetch(__tri_verts, tri_vert_index.x);
+  const float3 tri_b = kernel_tex_fetch(__tri_verts, tri_vert_index.y);
+  const float3 tri_c = kernel_tex_fetch(__tri_verts, tri_vert_index.z);
   local_isect->Ng[hit] = normalize(cross(tri_b - tri_a, tri_c - tri_a));
 
   /* Continue tracing (without this the trace call would return after the first hit). */
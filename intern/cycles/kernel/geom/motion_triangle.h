@@ -43,9 +43,10 @@ ccl_device_inline void motion_triangle_verts_for_step(KernelGlobals kg,
 {
   if (step == numsteps) {
     /* center step: regular vertex location */
-    verts[0] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-    verts[1] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-    verts[2] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+    const uint3 tri_vert_index = triangle_vert_index(kg, tri_vindex);
+    verts[0] = kernel_tex_fetch(__tri_verts, tri_vert_index.x);
+    verts[1] = kernel_tex_fetch(__tri_verts, tri_vert_index.y);
+    verts[2] = kernel_tex_fetch(__tri_verts, tri_vert_index.z);
   }
   else {
     /* center step not store in this array */
@@ -24,14 +24,25 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Indices of the triangle vertex locations. They are either stored for every triangle so they can
+ * be read from contiguous memory, or shared between triangles to use less memory. */
+ccl_device_forceinline uint3 triangle_vert_index(KernelGlobals kg, const uint4 tri_vindex)
+{
+  if (kernel_data.bvh.use_shared_tri_verts) {
+    return make_uint3(tri_vindex.x, tri_vindex.y, tri_vindex.z);
+  }
+  return make_uint3(tri_vindex.w + 0, tri_vindex.w + 1, tri_vindex.w + 2);
+}
+
 /* Normal on triangle. */
 ccl_device_inline float3 triangle_normal(KernelGlobals kg, ccl_private ShaderData *sd)
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, sd->prim);
-  const float3 v0 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  const float3 v1 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  const float3 v2 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  const uint3 tri_vert_index = triangle_vert_index(kg, tri_vindex);
+  const float3 v0 = kernel_tex_fetch(__tri_verts, tri_vert_index.x);
+  const float3 v1 = kernel_tex_fetch(__tri_verts, tri_vert_index.y);
+  const float3 v2 = kernel_tex_fetch(__tri_verts, tri_vert_index.z);
 
   /* return normal */
   if (sd->object_flag & SD_OBJECT_NEGATIVE_SCALE_APPLIED) {
@@ -54,9 +65,10 @@ ccl_device_inline void triangle_point_normal(KernelGlobals kg,
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  float3 v0 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  float3 v1 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  float3 v2 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  const uint3 tri_vert_index = triangle_vert_index(kg, tri_vindex);
+  float3 v0 = kernel_tex_fetch(__tri_verts, tri_vert_index.x);
+  float3 v1 = kernel_tex_fetch(__tri_verts, tri_vert_index.y);
+  float3 v2 = kernel_tex_fetch(__tri_verts, tri_vert_index.z);
   /* compute point */
   float t = 1.0f - u - v;
   *P = (u * v0 + v * v1 + t * v2);
@@ -78,9 +90,10 @@ ccl_device_inline void triangle_point_normal(KernelGlobals kg,
 ccl_device_inline void triangle_vertices(KernelGlobals kg, int prim, float3 P[3])
 {
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  P[0] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  P[1] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  P[2] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  const uint3 tri_vert_index = triangle_vert_index(kg, tri_vindex);
+  P[0] = kernel_tex_fetch(__tri_verts, tri_vert_index.x);
+  P[1] = kernel_tex_fetch(__tri_verts, tri_vert_index.y);
+  P[2] = kernel_tex_fetch(__tri_verts, tri_vert_index.z);
 }
 
 /* Triangle vertex locations and vertex normals */
@@ -91,9 +104,10 @@ ccl_device_inline void triangle_vertices_and_normals(KernelGlobals kg,
                                                      float3 N[3])
 {
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  P[0] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  P[1] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  P[2] = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  const uint3 tri_vert_index = triangle_vert_index(kg, tri_vindex);
+  P[0] = kernel_tex_fetch(__tri_verts, tri_vert_index.x);
+  P[1] = kernel_tex_fetch(__tri_verts, tri_vert_index.y);
+  P[2] = kernel_tex_fetch(__tri_verts, tri_vert_index.z);
   N[0] = kernel_tex_fetch(__tri_vnormal, tri_vindex.x);
   N[1] = kernel_tex_fetch(__tri_vnormal, tri_vindex.y);
   N[2] = kernel_tex_fetch(__tri_vnormal, tri_vindex.z);
@@ -145,9 +159,10 @@ ccl_device_inline void triangle_dPdudv(KernelGlobals kg,
 {
   /* fetch triangle vertex coordinates */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  const float3 p0 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 0);
-  const float3 p1 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 1);
-  const float3 p2 = kernel_tex_fetch(__tri_verts, tri_vindex.w + 2);
+  const uint3 tri_vert_index = triangle_vert_index(kg, tri_vindex);
+  const float3 p0 = kernel_tex_fetch(__tri_verts, tri_vert_index.x);
+  const float3 p1 = kernel_tex_fetch(__tri_verts, tri_vert_index.y);
+  const float3 p2 = kernel_tex_fetch(__tri_verts, tri_vert_index.z);
 
   /* compute derivatives of P w.r.t. uv */
   *dPdu = (p0 - p2);
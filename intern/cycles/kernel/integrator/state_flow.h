@@ -105,12 +105,13 @@ CCL_NAMESPACE_BEGIN
 
 #else
 
+/* The shader sort key is still stored, for the wavefront mode of the CPU path tracer. */
 #  define INTEGRATOR_PATH_INIT(next_kernel) \
     INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
 #  define INTEGRATOR_PATH_INIT_SORTED(next_kernel, key) \
     { \
       INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel; \
-      (void)key; \
+      INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = key; \
     }
 #  define INTEGRATOR_PATH_NEXT(current_kernel, next_kernel) \
     { \
@@ -125,7 +126,7 @@ CCL_NAMESPACE_BEGIN
 #  define INTEGRATOR_PATH_NEXT_SORTED(current_kernel, next_kernel, key) \
     { \
       INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel; \
-      (void)key; \
+      INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = key; \
       (void)current_kernel; \
     }
 
@@ -18,6 +18,7 @@
 
 #include "kernel/geom/geom.h"
 #include "kernel/light/background.h"
+#include "kernel/light/tree.h"
 #include "kernel/sample/mapping.h"
 
 CCL_NAMESPACE_BEGIN
@@ -518,6 +519,13 @@ ccl_device bool light_sample_from_intersection(KernelGlobals kg,
 
   ls->pdf *= kernel_data.integrator.pdf_lights;
 
+  if (kernel_data.integrator.use_light_tree) {
+    /* Lights are stored after the emissive triangles in the light distribution. */
+    const int distribution_index = kernel_data.integrator.num_distribution -
+                                   kernel_data.integrator.num_all_lights + lamp;
+    ls->pdf *= light_tree_pdf_factor(kg, ray_P, distribution_index);
+  }
+
   return true;
 }
 
@@ -575,6 +583,14 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals kg,
    * and simple area sampling, comparing the distance to the triangle plane
    * to the length of the edges of the triangle. */
 
+  float pdf_factor = 1.0f;
+  if (kernel_data.integrator.use_light_tree) {
+    pdf_factor = light_tree_triangle_pdf_factor(kg, sd->P + sd->I * t, sd->object, sd->prim);
+    if (pdf_factor == 0.0f) {
+      return 0.0f;
+    }
+  }
+
   float3 V[3];
   bool has_motion = triangle_world_space_vertices(kg, sd->object, sd->prim, sd->time, V);
 
@@ -617,7 +633,7 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals kg,
         area = 0.5f * len(N);
       }
       const float pdf = area * kernel_data.integrator.pdf_triangles;
-      return pdf / solid_angle;
+      return pdf_factor * pdf / solid_angle;
     }
   }
   else {
@@ -634,7 +650,7 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals kg,
       const float area_pre = triangle_area(V[0], V[1], V[2]);
       pdf = pdf * area_pre / area;
     }
-    return pdf;
+    return pdf_factor * pdf;
   }
 }
 
@@ -849,8 +865,19 @@ ccl_device_noinline bool light_distribution_sample(KernelGlobals kg,
                                                    const uint32_t path_flag,
                                                    ccl_private LightSample *ls)
 {
-  /* Sample light index from distribution. */
-  const int index = light_distribution_sample(kg, &randu);
+  /* Sample light index from distribution, or from the light tree. */
+  int index;
+  float pdf_factor = 1.0f;
+  if (kernel_data.integrator.use_light_tree) {
+    index = light_tree_sample(kg, P, &randu, &pdf_factor);
+    if (index < 0) {
+      return false;
+    }
+  }
+  else {
+    index = light_distribution_sample(kg, &randu);
+  }
+
   ccl_global const KernelLightDistribution *kdistribution = &kernel_tex_fetch(__light_distribution,
                                                                               index);
   const int prim = kdistribution->prim;
@@ -868,6 +895,7 @@ ccl_device_noinline bool light_distribution_sample(KernelGlobals kg,
     const int shader_flag = kdistribution->mesh_light.shader_flag;
     triangle_light_sample<in_volume_segment>(kg, prim, object, randu, randv, time, ls, P);
     ls->shader |= shader_flag;
+    ls->pdf *= pdf_factor;
     return (ls->pdf > 0.0f);
   }
 
@@ -877,7 +905,12 @@ ccl_device_noinline bool light_distribution_sample(KernelGlobals kg,
     return false;
   }
 
-  return light_sample<in_volume_segment>(kg, lamp, randu, randv, P, path_flag, ls);
+  if (!light_sample<in_volume_segment>(kg, lamp, randu, randv, P, path_flag, ls)) {
+    return false;
+  }
+
+  ls->pdf *= pdf_factor;
+  return true;
 }
 
 ccl_device_inline bool light_distribution_sample_from_volume_segment(KernelGlobals kg,
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Bounding volume hierarchy over emissive triangles and point, spot and area lights, used to pick
+ * emitters proportional to an estimate of their contribution to the shading point. Based on
+ * "Importance Sampling of Many Lights with Adaptive Tree Splitting" by Conty Estevez and Kulla.
+ *
+ * Distant and background lights are not in the tree, they are picked with the same probability
+ * as from the light distribution. The estimate only depends on the shading position, so that the
+ * probability to pick an emitter can be computed again for multiple importance sampling of rays
+ * hitting the emitter, which only know the position the ray was traced from.
+ *
+ * Light samples compute their pdf from the probability of the light distribution, so the tree
+ * functions return the ratio of the tree probability to the distribution one. */
+
+/* Estimate of the contribution of emitters with the given bounds to the shading point. */
+ccl_device float light_tree_importance(const float3 P,
+                                       const float3 bbox_min,
+                                       const float3 bbox_max,
+                                       const float3 axis,
+                                       const float theta_o,
+                                       const float theta_e,
+                                       const float energy)
+{
+  if (energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius_sq = 0.25f * len_squared(bbox_max - bbox_min);
+  const float3 V = P - centroid;
+  const float distance_sq = len_squared(V);
+
+  /* Smallest angle between the emission axis and the directions from the emitters to the shading
+   * point, taking the spread of the normals into account. Zero when inside the bounds. */
+  float cos_theta_prime = 1.0f;
+  if (distance_sq > radius_sq) {
+    const float distance = sqrtf(distance_sq);
+    const float theta = fast_acosf(clamp(dot(axis, V) / distance, -1.0f, 1.0f));
+    const float theta_u = fast_asinf(sqrtf(radius_sq) / distance);
+    const float theta_prime = fmaxf(theta - theta_o - theta_u, 0.0f);
+    if (theta_prime > theta_e) {
+      return 0.0f;
+    }
+    cos_theta_prime = fmaxf(fast_cosf(theta_prime), 0.0f);
+  }
+
+  /* Clamp the distance to the size of the bounds, to not let emitters close to the shading point
+   * take all the samples. */
+  return energy * cos_theta_prime / fmaxf(fmaxf(distance_sq, radius_sq), 1e-8f);
+}
+
+ccl_device_inline float light_tree_node_importance(KernelGlobals kg,
+                                                   const float3 P,
+                                                   const int node_index)
+{
+  ccl_global const KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes,
+                                                                  node_index);
+  return light_tree_importance(
+      P,
+      make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]),
+      make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]),
+      make_float3(knode->axis[0], knode->axis[1], knode->axis[2]),
+      knode->theta_o,
+      knode->theta_e,
+      knode->energy);
+}
+
+ccl_device_inline float light_tree_emitter_importance(KernelGlobals kg,
+                                                      const float3 P,
+                                                      const int emitter_index)
+{
+  ccl_global const KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                        emitter_index);
+  return light_tree_importance(
+      P,
+      make_float3(kemitter->bbox_min[0], kemitter->bbox_min[1], kemitter->bbox_min[2]),
+      make_float3(kemitter->bbox_max[0], kemitter->bbox_max[1], kemitter->bbox_max[2]),
+      make_float3(kemitter->axis[0], kemitter->axis[1], kemitter->axis[2]),
+      kemitter->theta_o,
+      kemitter->theta_e,
+      kemitter->energy);
+}
+
+ccl_device float light_tree_leaf_importance(KernelGlobals kg,
+                                            const float3 P,
+                                            ccl_global const KernelLightTreeNode *knode)
+{
+  float importance = 0.0f;
+  for (int i = 0; i < knode->num_emitters; i++) {
+    importance += light_tree_emitter_importance(kg, P, knode->child_index + i);
+  }
+  return importance;
+}
+
+/* Pick an emitter, returning its index in the light distribution or -1 when no emitter
+ * contributes to the shading point. The random number is rescaled for reuse when sampling a
+ * position on the emitter. */
+ccl_device int light_tree_sample(KernelGlobals kg,
+                                 const float3 P,
+                                 ccl_private float *randu,
+                                 ccl_private float *pdf_factor)
+{
+  const int num_emitters = kernel_data.integrator.num_light_tree_emitters;
+  const float pdf_light_tree = kernel_data.integrator.pdf_light_tree;
+  float r = *randu;
+
+  if (r >= pdf_light_tree) {
+    /* Distant light, picked with the same probability as from the light distribution. */
+    r = (r - pdf_light_tree) / kernel_data.integrator.pdf_lights;
+    const int distant = clamp((int)r, 0, kernel_data.integrator.num_distant_lights - 1);
+    *randu = saturatef(r - distant);
+    *pdf_factor = 1.0f;
+    return kernel_tex_fetch(__light_tree_emitters, num_emitters + distant).distribution_index;
+  }
+
+  r /= pdf_light_tree;
+  float pdf = pdf_light_tree;
+
+  /* Traverse the tree, picking children proportional to their importance. */
+  int node_index = 0;
+  ccl_global const KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, 0);
+  while (knode->num_emitters == 0) {
+    const int left_index = node_index + 1;
+    const int right_index = knode->child_index;
+    const float importance_left = light_tree_node_importance(kg, P, left_index);
+    const float importance_right = light_tree_node_importance(kg, P, right_index);
+    const float importance_total = importance_left + importance_right;
+    if (importance_total == 0.0f) {
+      return -1;
+    }
+
+    const float prob_left = importance_left / importance_total;
+    if (r < prob_left || importance_right == 0.0f) {
+      node_index = left_index;
+      r = saturatef(r / prob_left);
+      pdf *= prob_left;
+    }
+    else {
+      const float prob_right = importance_right / importance_total;
+      node_index = right_index;
+      r = saturatef((r - prob_left) / prob_right);
+      pdf *= prob_right;
+    }
+    knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  }
+
+  /* Pick an emitter of the leaf. */
+  const float importance_total = light_tree_leaf_importance(kg, P, knode);
+  if (importance_total == 0.0f) {
+    return -1;
+  }
+
+  r *= importance_total;
+  int emitter_index = -1;
+  float importance = 0.0f;
+  for (int i = 0; i < knode->num_emitters; i++) {
+    const float importance_emitter = light_tree_emitter_importance(
+        kg, P, knode->child_index + i);
+    if (importance_emitter > 0.0f) {
+      emitter_index = knode->child_index + i;
+      importance = importance_emitter;
+      if (r < importance_emitter) {
+        break;
+      }
+      r -= importance_emitter;
+    }
+  }
+
+  ccl_global const KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                        emitter_index);
+  if (kemitter->pdf_distribution == 0.0f) {
+    return -1;
+  }
+
+  *randu = saturatef(r / importance);
+  *pdf_factor = pdf * (importance / importance_total) / kemitter->pdf_distribution;
+  return kemitter->distribution_index;
+}
+
+/* Ratio of the probability to pick the emitter from the tree to the one of the light
+ * distribution, for multiple importance sampling. */
+ccl_device float light_tree_pdf_factor(KernelGlobals kg,
+                                       const float3 P,
+                                       const int distribution_index)
+{
+  const int emitter_index = (int)kernel_tex_fetch(__light_tree_emitter_index,
+                                                  distribution_index);
+  if (emitter_index < 0) {
+    /* Emitters which are not in the tree are never picked. */
+    return 0.0f;
+  }
+  if (emitter_index >= kernel_data.integrator.num_light_tree_emitters) {
+    /* Distant light. */
+    return 1.0f;
+  }
+
+  ccl_global const KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                        emitter_index);
+  const float importance = light_tree_emitter_importance(kg, P, emitter_index);
+  if (importance == 0.0f || kemitter->pdf_distribution == 0.0f) {
+    return 0.0f;
+  }
+
+  /* Probability to pick the emitter in its leaf. */
+  int node_index = kemitter->parent_index;
+  ccl_global const KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes,
+                                                                  node_index);
+  float pdf = importance / light_tree_leaf_importance(kg, P, knode);
+
+  /* Probability to reach the leaf from the root. */
+  while (node_index != 0) {
+    const int parent_index = knode->parent_index;
+    knode = &kernel_tex_fetch(__light_tree_nodes, parent_index);
+
+    const float importance_left = light_tree_node_importance(kg, P, parent_index + 1);
+    const float importance_right = light_tree_node_importance(kg, P, knode->child_index);
+    const float importance_total = importance_left + importance_right;
+    if (importance_total == 0.0f) {
+      return 0.0f;
+    }
+
+    pdf *= ((node_index == parent_index + 1) ? importance_left : importance_right) /
+           importance_total;
+    node_index = parent_index;
+  }
+
+  return pdf * kernel_data.integrator.pdf_light_tree / kemitter->pdf_distribution;
+}
+
+/* Same as above, for an emissive triangle. */
+ccl_device float light_tree_triangle_pdf_factor(KernelGlobals kg,
+                                                const float3 P,
+                                                const int object,
+                                                const int prim)
+{
+  /* Emissive triangles of an object are stored in the light distribution in increasing order of
+   * their primitive index. */
+  int first = kernel_tex_fetch(__light_tree_object_offset, object);
+  int last = kernel_tex_fetch(__light_tree_object_offset, object + 1);
+  const int end = last;
+
+  while (first < last) {
+    const int middle = (first + last) >> 1;
+    if (kernel_tex_fetch(__light_distribution, middle).prim < prim) {
+      first = middle + 1;
+    }
+    else {
+      last = middle;
+    }
+  }
+
+  if (first == end || kernel_tex_fetch(__light_distribution, first).prim != prim) {
+    return 0.0f;
+  }
+
+  return light_tree_pdf_factor(kg, P, first);
+}
+
+CCL_NAMESPACE_END
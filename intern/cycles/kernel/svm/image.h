@@ -18,14 +18,25 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y, uint flags)
+ccl_device float4 svm_image_texture(KernelGlobals kg,
+                                    int id,
+                                    float x,
+                                    float y,
+                                    const float2 duv_dx,
+                                    const float2 duv_dy,
+                                    uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
+  /* Derivatives are only used by the texture cache, which is CPU only. */
+#ifdef __KERNEL_CPU__
+  float4 r = kernel_tex_image_interp(kg, id, x, y, duv_dx, duv_dy);
+#else
   float4 r = kernel_tex_image_interp(kg, id, x, y);
+#endif
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -40,6 +51,41 @@ ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y,
   return r;
 }
 
+ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y, uint flags)
+{
+  return svm_image_texture(kg, id, x, y, zero_float2(), zero_float2(), flags);
+}
+
+/* Derivatives of the UV map, for the texture coordinates of image textures. */
+ccl_device_inline void svm_image_uv_derivatives(KernelGlobals kg,
+                                                ccl_private ShaderData *sd,
+                                                uint attr,
+                                                ccl_private float2 *duv_dx,
+                                                ccl_private float2 *duv_dy)
+{
+  *duv_dx = zero_float2();
+  *duv_dy = zero_float2();
+
+  if (sd->object == OBJECT_NONE) {
+    return;
+  }
+
+  const AttributeDescriptor desc = find_attribute(kg, sd, attr);
+  if (desc.offset == ATTR_STD_NOT_FOUND) {
+    return;
+  }
+
+  if (desc.type == NODE_ATTR_FLOAT2) {
+    primitive_surface_attribute_float2(kg, sd, desc, duv_dx, duv_dy);
+  }
+  else if (desc.type == NODE_ATTR_FLOAT3) {
+    float3 dx, dy;
+    primitive_surface_attribute_float3(kg, sd, desc, &dx, &dy);
+    *duv_dx = make_float2(dx.x, dx.y);
+    *duv_dy = make_float2(dy.x, dy.y);
+  }
+}
+
 /* Remap coordinate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
@@ -67,6 +113,12 @@ ccl_device_noinline int svm_node_tex_image(
     tex_co = make_float2(co.x, co.y);
   }
 
+  float2 duv_dx = zero_float2(), duv_dy = zero_float2();
+  if (flags & NODE_IMAGE_UV_DERIVATIVES) {
+    const uint4 uv_node = read_node(kg, &offset);
+    svm_image_uv_derivatives(kg, sd, uv_node.x, &duv_dx, &duv_dy);
+  }
+
   /* TODO(lukas): Consider moving tile information out of the SVM node.
    * TextureInfo seems a reasonable candidate. */
   int id = -1;
@@ -110,7 +162,7 @@ ccl_device_noinline int svm_node_tex_image(
     id = -num_nodes;
   }
 
-  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, duv_dx, duv_dy, flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
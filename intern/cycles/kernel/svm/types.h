@@ -461,6 +461,9 @@ typedef enum NodeImageProjection {
 typedef enum NodeImageFlags {
   NODE_IMAGE_COMPRESS_AS_SRGB = 1,
   NODE_IMAGE_ALPHA_UNASSOCIATE = 2,
+  /* Followed by a node with the UV map attribute that the texture coordinates are read from,
+   * to filter images from the texture cache. */
+  NODE_IMAGE_UV_DERIVATIVES = 4,
 } NodeImageFlags;
 
 typedef enum NodeEnvironmentProjection {
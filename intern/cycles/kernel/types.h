@@ -1231,6 +1231,12 @@ typedef struct KernelIntegrator {
   /* MIS debugging. */
   int direct_light_sampling_type;
 
+  /* light tree */
+  int use_light_tree;
+  int num_light_tree_emitters;
+  int num_distant_lights;
+  float pdf_light_tree;
+
   /* padding */
   int pad1, pad2;
 } KernelIntegrator;
@@ -1261,6 +1267,9 @@ typedef struct KernelBVH {
   int bvh_layout;
   int use_bvh_steps;
   int curve_subdivisions;
+  int use_compressed_nodes;
+  int use_shared_tri_verts;
+  int pad0, pad1;
 
   /* Custom BVH */
 #ifdef __KERNEL_OPTIX__
@@ -1421,6 +1430,44 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Node of the light tree. The bounds describe the emitters in the node: their bounding box, the
+ * spread theta_o of their normals around the axis, the spread theta_e of the emission around the
+ * normals, and their total energy. */
+typedef struct KernelLightTreeNode {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  /* Inner nodes: index of the second child, the first child directly follows the node.
+   * Leaf nodes: index of the first emitter. */
+  int child_index;
+  /* Number of emitters of leaf nodes, zero for inner nodes. */
+  int num_emitters;
+  int parent_index;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+typedef struct KernelLightTreeEmitter {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  /* Index of the emitter in the light distribution. */
+  int distribution_index;
+  /* Leaf node of the emitter, -1 for distant lights which are not in the tree. */
+  int parent_index;
+  /* Probability to pick the emitter from the light distribution, which the pdf of light samples
+   * is computed with. */
+  float pdf_distribution;
+  float pad;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
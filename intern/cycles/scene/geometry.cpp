@@ -223,7 +223,7 @@ void Geometry::compute_bvh(
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild) {
+    if (bvh && !need_update_rebuild && !bvh->need_rebuild()) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->geometry = geometry;
@@ -237,6 +237,7 @@ void Geometry::compute_bvh(
       BVHParams bparams;
       bparams.use_spatial_split = params->use_bvh_spatial_split;
       bparams.use_compact_structure = params->use_bvh_compact_structure;
+      bparams.use_compressed_nodes = params->use_bvh_compression;
       bparams.bvh_layout = bvh_layout;
       bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                     params->use_bvh_unaligned_nodes;
@@ -1138,7 +1139,13 @@ void GeometryManager::device_update_mesh(Device *,
     /* normals */
     progress.set_status("Updating Mesh", "Computing normals");
 
-    packed_float3 *tri_verts = dscene->tri_verts.alloc(tri_size * 3);
+    /* Triangle vertex locations are shared between triangles when compressing the BVH, instead of
+     * being stored for every triangle. */
+    const bool use_shared_tri_verts = scene->params.use_bvh_compression;
+    dscene->data.bvh.use_shared_tri_verts = use_shared_tri_verts;
+
+    packed_float3 *tri_verts = dscene->tri_verts.alloc(use_shared_tri_verts ? vert_size :
+                                                                              tri_size * 3);
     uint *tri_shader = dscene->tri_shader.alloc(tri_size);
     packed_float3 *vnormal = dscene->tri_vnormal.alloc(vert_size);
     uint4 *tri_vindex = dscene->tri_vindex.alloc(tri_size);
@@ -1166,10 +1173,12 @@ void GeometryManager::device_update_mesh(Device *,
 
         if (mesh->verts_is_modified() || mesh->triangles_is_modified() ||
             mesh->vert_patch_uv_is_modified() || copy_all_data) {
-          mesh->pack_verts(&tri_verts[mesh->prim_offset * 3],
+          mesh->pack_verts(use_shared_tri_verts ? &tri_verts[mesh->vert_offset] :
+                                                  &tri_verts[mesh->prim_offset * 3],
                            &tri_vindex[mesh->prim_offset],
                            &tri_patch[mesh->prim_offset],
-                           &tri_patch_uv[mesh->vert_offset]);
+                           &tri_patch_uv[mesh->vert_offset],
+                           use_shared_tri_verts);
         }
 
         if (progress.get_cancel())
@@ -1273,6 +1282,7 @@ void GeometryManager::device_update_mesh(Device *,
 void GeometryManager::device_update_bvh(Device *device,
                                         DeviceScene *dscene,
                                         Scene *scene,
+                                        bool can_refit_scene_bvh,
                                         Progress &progress)
 {
   /* bvh build */
@@ -1283,6 +1293,7 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.bvh_layout = BVHParams::best_bvh_layout(scene->params.bvh_layout,
                                                   device->get_bvh_layout_mask());
   bparams.use_spatial_split = scene->params.use_bvh_spatial_split;
+  bparams.use_compressed_nodes = scene->params.use_bvh_compression;
   bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                 scene->params.use_bvh_unaligned_nodes;
   bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
@@ -1293,9 +1304,19 @@ void GeometryManager::device_update_bvh(Device *device,
 
   VLOG(1) << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
-  const bool can_refit = scene->bvh != nullptr &&
-                         (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
-                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL);
+  bool can_refit = false;
+  if (scene->bvh != nullptr) {
+    if (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
+        bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL) {
+      can_refit = true;
+    }
+    else if (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_BVH2 ||
+             bparams.bvh_layout == BVHLayout::BVH_LAYOUT_EMBREE) {
+      can_refit = can_refit_scene_bvh && !scene->bvh->need_rebuild();
+    }
+  }
+
+  VLOG(1) << (can_refit ? "Refitting" : "Building") << " scene BVH.";
 
   BVH *bvh = scene->bvh;
   if (!scene->bvh) {
@@ -1358,6 +1379,7 @@ void GeometryManager::device_update_bvh(Device *device,
   }
 
   dscene->data.bvh.root = pack.root_index;
+  dscene->data.bvh.use_compressed_nodes = bparams.use_compressed_nodes;
   dscene->data.bvh.use_bvh_steps = (scene->params.num_bvh_time_steps != 0);
   dscene->data.bvh.curve_subdivisions = scene->params.curve_subdivisions();
   /* The scene handle is set in 'CPUDevice::const_copy_to' and 'OptiXDevice::const_copy_to' */
@@ -2019,6 +2041,13 @@ void GeometryManager::device_update(Device *device,
    * change. */
   bool need_update_scene_bvh = (scene->bvh == nullptr ||
                                 (update_flags & (TRANSFORM_MODIFIED | VISIBILITY_MODIFIED)) != 0);
+
+  /* Refit the scene BVH when geometry deforms without changing its topology, changes to the
+   * topology free the scene BVH above. It is still built again when the set of primitives in it
+   * changes otherwise, as the refit BVH would not contain them. */
+  bool can_refit_scene_bvh = scene->bvh != nullptr && scene->bvh->objects == scene->objects &&
+                             scene->bvh->geometry == scene->geometry &&
+                             (update_flags & VISIBILITY_MODIFIED) == 0;
   {
     scoped_callback_timer timer([scene](double time) {
       if (scene->update_stats) {
@@ -2029,11 +2058,31 @@ void GeometryManager::device_update(Device *device,
 
     size_t i = 0;
     foreach (Geometry *geom, scene->geometry) {
+      const bool need_build_bvh = geom->need_build_bvh(bvh_layout);
+
+      if (need_build_bvh != (geom->bvh != nullptr)) {
+        /* Geometry became instanced or had its transform applied. */
+        can_refit_scene_bvh = false;
+        if (!need_build_bvh) {
+          delete geom->bvh;
+          geom->bvh = nullptr;
+        }
+      }
+
       if (geom->is_modified() || geom->need_update_bvh_for_offset) {
+        /* Primitive indices in the scene BVH include the offsets. BVH2 copies the nodes of
+         * instanced geometry into the scene BVH, and Embree references the geometry BVH which
+         * is replaced when built again. */
+        if (geom->need_update_bvh_for_offset ||
+            (need_build_bvh && (bvh_layout == BVH_LAYOUT_BVH2 || geom->bvh == nullptr ||
+                                geom->bvh->need_rebuild()))) {
+          can_refit_scene_bvh = false;
+        }
+
         need_update_scene_bvh = true;
         pool.push(function_bind(
             &Geometry::compute_bvh, geom, device, dscene, &scene->params, &progress, i, num_bvh));
-        if (geom->need_build_bvh(bvh_layout)) {
+        if (need_build_bvh) {
           i++;
         }
       }
@@ -2075,7 +2124,7 @@ void GeometryManager::device_update(Device *device,
         scene->update_stats->geometry.times.add_entry({"device_update (build scene BVH)", time});
       }
     });
-    device_update_bvh(device, dscene, scene, progress);
+    device_update_bvh(device, dscene, scene, can_refit_scene_bvh, progress);
     if (progress.get_cancel()) {
       return;
     }
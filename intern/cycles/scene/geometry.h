@@ -253,7 +253,11 @@ class GeometryManager {
                                 Scene *scene,
                                 Progress &progress);
 
-  void device_update_bvh(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
+  void device_update_bvh(Device *device,
+                         DeviceScene *dscene,
+                         Scene *scene,
+                         bool can_refit_scene_bvh,
+                         Progress &progress);
 
   void device_update_displacement_images(Device *device, Scene *scene, Progress &progress);
 
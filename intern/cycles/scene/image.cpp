@@ -32,6 +32,8 @@
 #include "util/texture.h"
 #include "util/unique_ptr.h"
 
+#include <OpenImageIO/texture.h>
+
 #ifdef WITH_OSL
 #  include <OSL/oslexec.h>
 #endif
@@ -77,6 +79,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_float";
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
       return "nanovdb_float3";
+    case IMAGE_DATA_TYPE_OIIO:
+      return "oiio";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -300,16 +304,22 @@ ImageManager::ImageManager(const DeviceInfo &info)
 {
   need_update_ = true;
   osl_texture_system = NULL;
+  texture_cache = NULL;
   animation_frame = 0;
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
+
+  /* Texture cache is read from the kernel on the host. */
+  device_has_texture_cache = (info.type == DEVICE_CPU);
 }
 
 ImageManager::~ImageManager()
 {
   for (size_t slot = 0; slot < images.size(); slot++)
     assert(!images[slot]);
+
+  set_texture_cache(false, 0);
 }
 
 void ImageManager::set_osl_texture_system(void *texture_system)
@@ -317,6 +327,106 @@ void ImageManager::set_osl_texture_system(void *texture_system)
   osl_texture_system = texture_system;
 }
 
+/* Implements TextureCacheInfo::lookup, coordinates have their origin at the bottom left as in
+ * the kernel. Compiled once on the host, so that OpenImageIO stays out of the kernels. */
+static bool texture_cache_lookup(const TextureCacheInfo *cache_info,
+                                 uint interpolation,
+                                 uint extension,
+                                 float x,
+                                 float y,
+                                 float dsdx,
+                                 float dtdx,
+                                 float dsdy,
+                                 float dtdy,
+                                 float result[4])
+{
+  OIIO::TextureSystem *ts = (OIIO::TextureSystem *)cache_info->texture_system;
+
+  OIIO::TextureOpt options;
+  switch (interpolation) {
+    case INTERPOLATION_CLOSEST:
+      options.interpmode = OIIO::TextureOpt::InterpClosest;
+      break;
+    case INTERPOLATION_LINEAR:
+      options.interpmode = OIIO::TextureOpt::InterpBilinear;
+      break;
+    case INTERPOLATION_CUBIC:
+      options.interpmode = OIIO::TextureOpt::InterpBicubic;
+      break;
+    default:
+      options.interpmode = OIIO::TextureOpt::InterpSmartBicubic;
+      break;
+  }
+  switch (extension) {
+    case EXTENSION_EXTEND:
+      options.swrap = options.twrap = OIIO::TextureOpt::WrapClamp;
+      break;
+    case EXTENSION_CLIP:
+      options.swrap = options.twrap = OIIO::TextureOpt::WrapBlack;
+      break;
+    default:
+      options.swrap = options.twrap = OIIO::TextureOpt::WrapPeriodic;
+      break;
+  }
+  /* Opaque alpha for images without alpha channel. */
+  options.fill = 1.0f;
+
+  /* Images have their origin at the top left in the texture system. */
+  return ts->texture((OIIO::TextureSystem::TextureHandle *)cache_info->handle,
+                     NULL,
+                     options,
+                     x,
+                     1.0f - y,
+                     dsdx,
+                     -dtdx,
+                     dsdy,
+                     -dtdy,
+                     4,
+                     result);
+}
+
+void texture_cache_info_init(TextureCacheInfo *cache_info,
+                             void *texture_system,
+                             const ustring &filepath)
+{
+  OIIO::TextureSystem *ts = (OIIO::TextureSystem *)texture_system;
+  cache_info->lookup = texture_cache_lookup;
+  cache_info->texture_system = ts;
+  cache_info->handle = ts->get_texture_handle(filepath);
+}
+
+void ImageManager::set_texture_cache(bool use_texture_cache, int texture_cache_size)
+{
+  if (!device_has_texture_cache) {
+    return;
+  }
+
+  if (!use_texture_cache) {
+    if (texture_cache) {
+      OIIO::TextureSystem::destroy((OIIO::TextureSystem *)texture_cache);
+      texture_cache = NULL;
+    }
+    return;
+  }
+
+  if (!texture_cache) {
+    texture_cache = OIIO::TextureSystem::create(false);
+  }
+
+  /* Generate tiles and mipmaps on the fly for image files which don't have them, same as the
+   * texture system of OSL. Prefer converting to tiled .tx files up front for large textures. */
+  OIIO::TextureSystem *ts = (OIIO::TextureSystem *)texture_cache;
+  ts->attribute("automip", 1);
+  ts->attribute("autotile", 64);
+  ts->attribute("gray_to_rgb", 1);
+  ts->attribute("max_memory_MB", (float)texture_cache_size);
+}
+
+bool ImageManager::use_texture_cache() const
+{
+  return texture_cache != NULL;
+}
+
 bool ImageManager::set_animation_frame_update(int frame)
 {
   if (frame != animation_frame) {
@@ -362,6 +472,35 @@ void ImageManager::load_image_metadata(Image *img)
   img->need_metadata = false;
 }
 
+bool ImageManager::image_use_texture_cache(const Image *img) const
+{
+  if (texture_cache == NULL) {
+    return false;
+  }
+
+  /* Images from Blender are already in memory. */
+  if (img->loader->osl_filepath().empty()) {
+    return false;
+  }
+
+  /* The texture system reads pixels as stored in the file, colorspace conversion and alpha
+   * handling other than associating it are only done when loading the full image. */
+  const ImageMetaData &metadata = img->metadata;
+  if (metadata.depth > 1 || metadata.type == IMAGE_DATA_TYPE_NANOVDB_FLOAT ||
+      metadata.type == IMAGE_DATA_TYPE_NANOVDB_FLOAT3) {
+    return false;
+  }
+  if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+    return false;
+  }
+  if (img->params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED ||
+      img->params.alpha_type == IMAGE_ALPHA_IGNORE) {
+    return false;
+  }
+
+  return true;
+}
+
 ImageHandle ImageManager::add_image(const string &filename, const ImageParams &params)
 {
   const int slot = add_image_slot(new OIIOImageLoader(filename), params, false);
@@ -659,7 +798,8 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   const int texture_limit = scene->params.texture_limit;
 
   load_image_metadata(img);
-  ImageDataType type = img->metadata.type;
+  const bool use_texture_cache = image_use_texture_cache(img);
+  ImageDataType type = (use_texture_cache) ? IMAGE_DATA_TYPE_OIIO : img->metadata.type;
 
   /* Name for debugging. */
   img->mem_name = string_printf("__tex_image_%s_%03d", name_from_type(type), slot);
@@ -677,7 +817,14 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (type == IMAGE_DATA_TYPE_OIIO) {
+    /* Only look up the file, pixels are read on demand by the kernel. */
+    thread_scoped_lock device_lock(device_mutex);
+    TextureCacheInfo *cache_info = (TextureCacheInfo *)img->mem->alloc(sizeof(TextureCacheInfo),
+                                                                       0);
+    texture_cache_info_init(cache_info, texture_cache, img->loader->osl_filepath());
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -798,6 +945,10 @@ void ImageManager::device_free_image(Device *, int slot)
 #endif
   }
 
+  if (img->mem && img->mem->info.data_type == IMAGE_DATA_TYPE_OIIO) {
+    ((OIIO::TextureSystem *)texture_cache)->invalidate(img->loader->osl_filepath());
+  }
+
   if (img->mem) {
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
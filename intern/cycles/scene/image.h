@@ -193,6 +193,11 @@ class ImageManager {
   void set_osl_texture_system(void *texture_system);
   bool set_animation_frame_update(int frame);
 
+  /* Read image files on demand through a tiled and mipmapped texture cache with the given memory
+   * budget in megabytes, instead of loading them fully up front. Only supported on the CPU. */
+  void set_texture_cache(bool use_texture_cache, int texture_cache_size);
+  bool use_texture_cache() const;
+
   void collect_statistics(RenderStats *stats);
 
   void tag_update();
@@ -227,12 +232,15 @@ class ImageManager {
 
   vector<Image *> images;
   void *osl_texture_system;
+  bool device_has_texture_cache;
+  void *texture_cache;
 
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
   void remove_image_user(int slot);
 
   void load_image_metadata(Image *img);
+  bool image_use_texture_cache(const Image *img) const;
 
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
@@ -243,6 +251,12 @@ class ImageManager {
   friend class ImageHandle;
 };
 
+/* Set up reading an image file on demand through an OpenImageIO texture system, for
+ * IMAGE_DATA_TYPE_OIIO textures. */
+void texture_cache_info_init(TextureCacheInfo *cache_info,
+                             void *texture_system,
+                             const ustring &filepath);
+
 CCL_NAMESPACE_END
 
 #endif /* __IMAGE_H__ */
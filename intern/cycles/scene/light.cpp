@@ -20,6 +20,7 @@
 #include "scene/film.h"
 #include "scene/integrator.h"
 #include "scene/light.h"
+#include "scene/light_tree.h"
 #include "scene/mesh.h"
 #include "scene/object.h"
 #include "scene/scene.h"
@@ -243,6 +244,122 @@ void LightManager::test_enabled_lights(Scene *scene)
   }
 }
 
+/* Estimate of the radiance emitted by a shader, for building the light tree. */
+static float shader_emission_estimate(Shader *shader)
+{
+  float3 emission;
+  if (shader->is_constant_emission(&emission)) {
+    return average(fabs(emission));
+  }
+  /* Emission depending on the shading point is unknown until rendering. */
+  return 1.0f;
+}
+
+/* Copy the light tree to the device. Every emitter of the light distribution is either in the
+ * tree or a distant light, which are stored after the emitters of the tree. */
+static void light_tree_device_update(DeviceScene *dscene,
+                                     vector<LightTreePrimitive> &prims,
+                                     const vector<int> &distant_lights,
+                                     const vector<float> &distribution_area,
+                                     const vector<uint> &object_offsets)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+  const int num_distribution = kintegrator->num_distribution;
+  const int num_triangles = num_distribution - kintegrator->num_all_lights;
+  const int num_prims = prims.size();
+  const int num_distant_lights = distant_lights.size();
+
+  /* Probability to pick an emitter from the light distribution, which the pdf of light samples
+   * is computed with. */
+  auto pdf_distribution = [&](const int distribution_index) {
+    return (distribution_index < num_triangles) ?
+               distribution_area[distribution_index] * kintegrator->pdf_triangles :
+               kintegrator->pdf_lights;
+  };
+
+  const LightTree tree(prims, 8);
+  const vector<LightTreeNode> &nodes = tree.get_nodes();
+
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(nodes.size());
+  KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(num_prims +
+                                                                        num_distant_lights);
+  uint *kemitter_index = dscene->light_tree_emitter_index.alloc(num_distribution);
+  uint *kobject_offset = dscene->light_tree_object_offset.alloc(object_offsets.size());
+
+  for (int i = 0; i < nodes.size(); i++) {
+    const LightTreeNode &node = nodes[i];
+    KernelLightTreeNode &knode = knodes[i];
+    knode.bbox_min[0] = node.bbox.min.x;
+    knode.bbox_min[1] = node.bbox.min.y;
+    knode.bbox_min[2] = node.bbox.min.z;
+    knode.bbox_max[0] = node.bbox.max.x;
+    knode.bbox_max[1] = node.bbox.max.y;
+    knode.bbox_max[2] = node.bbox.max.z;
+    knode.energy = node.energy;
+    knode.axis[0] = node.bcone.axis.x;
+    knode.axis[1] = node.bcone.axis.y;
+    knode.axis[2] = node.bcone.axis.z;
+    knode.theta_o = node.bcone.theta_o;
+    knode.theta_e = node.bcone.theta_e;
+    knode.child_index = node.child_index;
+    knode.num_emitters = node.num_prims;
+    knode.parent_index = node.parent_index;
+    knode.pad = 0;
+
+    for (int j = 0; j < node.num_prims; j++) {
+      kemitters[node.child_index + j].parent_index = i;
+    }
+  }
+
+  for (int i = 0; i < num_distribution; i++) {
+    kemitter_index[i] = ~0u;
+  }
+
+  for (int i = 0; i < num_prims; i++) {
+    const LightTreePrimitive &prim = prims[i];
+    KernelLightTreeEmitter &kemitter = kemitters[i];
+    kemitter.bbox_min[0] = prim.bbox.min.x;
+    kemitter.bbox_min[1] = prim.bbox.min.y;
+    kemitter.bbox_min[2] = prim.bbox.min.z;
+    kemitter.bbox_max[0] = prim.bbox.max.x;
+    kemitter.bbox_max[1] = prim.bbox.max.y;
+    kemitter.bbox_max[2] = prim.bbox.max.z;
+    kemitter.energy = prim.energy;
+    kemitter.axis[0] = prim.bcone.axis.x;
+    kemitter.axis[1] = prim.bcone.axis.y;
+    kemitter.axis[2] = prim.bcone.axis.z;
+    kemitter.theta_o = prim.bcone.theta_o;
+    kemitter.theta_e = prim.bcone.theta_e;
+    kemitter.distribution_index = prim.prim_id;
+    kemitter.pdf_distribution = pdf_distribution(prim.prim_id);
+    kemitter.pad = 0.0f;
+    kemitter_index[prim.prim_id] = i;
+  }
+
+  for (int i = 0; i < num_distant_lights; i++) {
+    KernelLightTreeEmitter &kemitter = kemitters[num_prims + i];
+    memset(&kemitter, 0, sizeof(kemitter));
+    kemitter.distribution_index = distant_lights[i];
+    kemitter.parent_index = -1;
+    kemitter.pdf_distribution = kintegrator->pdf_lights;
+    kemitter_index[distant_lights[i]] = num_prims + i;
+  }
+
+  std::copy(object_offsets.begin(), object_offsets.end(), kobject_offset);
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_emitters.copy_to_device();
+  dscene->light_tree_emitter_index.copy_to_device();
+  dscene->light_tree_object_offset.copy_to_device();
+
+  kintegrator->num_light_tree_emitters = num_prims;
+  kintegrator->num_distant_lights = num_distant_lights;
+  kintegrator->pdf_light_tree = 1.0f - num_distant_lights * kintegrator->pdf_lights;
+
+  VLOG(1) << "Light tree built with " << nodes.size() << " nodes for " << num_prims
+          << " emitters.";
+}
+
 bool LightManager::object_usable_as_light(Object *object)
 {
   Geometry *geom = object->get_geometry();
@@ -325,6 +442,19 @@ void LightManager::device_update_distribution(Device *,
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
 
+  /* Emitters of the light tree, and the data needed to find emissive triangles of objects in the
+   * light distribution. */
+  const bool use_light_tree = scene->integrator->get_use_light_tree();
+  vector<LightTreePrimitive> light_tree_prims;
+  vector<int> light_tree_distant_lights;
+  vector<float> distribution_area;
+  vector<uint> object_offsets;
+  if (use_light_tree) {
+    light_tree_prims.reserve(num_distribution);
+    distribution_area.resize(num_triangles, 0.0f);
+    object_offsets.resize(scene->objects.size() + 1, 0);
+  }
+
   /* triangles */
   size_t offset = 0;
   int j = 0;
@@ -333,6 +463,10 @@ void LightManager::device_update_distribution(Device *,
     if (progress.get_cancel())
       return;
 
+    if (use_light_tree) {
+      object_offsets[j] = offset;
+    }
+
     if (!object_usable_as_light(object)) {
       j++;
       continue;
@@ -363,6 +497,13 @@ void LightManager::device_update_distribution(Device *,
       shader_flag |= SHADER_EXCLUDE_SHADOW_CATCHER;
     }
 
+    vector<float> shader_emission;
+    if (use_light_tree) {
+      foreach (Node *node, mesh->get_used_shaders()) {
+        shader_emission.push_back(shader_emission_estimate(static_cast<Shader *>(node)));
+      }
+    }
+
     size_t mesh_num_triangles = mesh->num_triangles();
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->get_shader()[i];
@@ -391,13 +532,33 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          /* Emission of triangles is two-sided, so it is not bounded by the normal. */
+          LightTreePrimitive prim;
+          prim.bbox.grow(p1);
+          prim.bbox.grow(p2);
+          prim.bbox.grow(p3);
+          prim.bcone = {safe_normalize(cross(p2 - p1, p3 - p1)), M_PI_F, M_PI_2_F};
+          prim.energy = area * ((shader_index < shader_emission.size()) ?
+                                    shader_emission[shader_index] :
+                                    1.0f);
+          prim.prim_id = offset - 1;
+          light_tree_prims.push_back(prim);
+          distribution_area[offset - 1] = area;
+        }
       }
     }
 
     j++;
   }
 
+  if (use_light_tree) {
+    object_offsets[j] = offset;
+  }
+
   float trianglearea = totarea;
   /* point lights */
   bool use_lamp_mis = false;
@@ -415,6 +576,40 @@ void LightManager::device_update_distribution(Device *,
       distribution[offset].lamp.size = light->size;
       totarea += lightarea;
 
+      if (use_light_tree) {
+        /* Bounds of the emitting surface, and energy as the radiant intensity towards the
+         * normal, matching the evaluation of the lights in the kernel. */
+        const float strength = average(fabs(light->strength));
+        LightTreePrimitive prim;
+        prim.prim_id = offset;
+
+        if (light->light_type == LIGHT_POINT || light->light_type == LIGHT_SPOT) {
+          prim.bbox.grow(light->co, light->size);
+          prim.energy = strength * (0.25f * M_1_PI_F);
+          if (light->light_type == LIGHT_SPOT) {
+            prim.bcone = {safe_normalize(light->dir), min(light->spot_angle * 0.5f, M_PI_F), 0.0f};
+          }
+          else {
+            prim.bcone = {make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F};
+          }
+          light_tree_prims.push_back(prim);
+        }
+        else if (light->light_type == LIGHT_AREA) {
+          const float3 axisu = light->axisu * (light->sizeu * light->size * 0.5f);
+          const float3 axisv = light->axisv * (light->sizev * light->size * 0.5f);
+          prim.bbox.grow(light->co + axisu + axisv);
+          prim.bbox.grow(light->co + axisu - axisv);
+          prim.bbox.grow(light->co - axisu + axisv);
+          prim.bbox.grow(light->co - axisu - axisv);
+          prim.bcone = {safe_normalize(light->dir), 0.0f, M_PI_2_F};
+          prim.energy = strength * 0.25f;
+          light_tree_prims.push_back(prim);
+        }
+        else {
+          light_tree_distant_lights.push_back(offset);
+        }
+      }
+
       if (light->light_type == LIGHT_DISTANT) {
         use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
       }
@@ -493,6 +688,21 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree, only worth it when there are emitters which are not distant lights. */
+    kintegrator->use_light_tree = use_light_tree && !light_tree_prims.empty();
+    if (kintegrator->use_light_tree) {
+      light_tree_device_update(dscene,
+                               light_tree_prims,
+                               light_tree_distant_lights,
+                               distribution_area,
+                               object_offsets);
+    }
+    else {
+      kintegrator->num_light_tree_emitters = 0;
+      kintegrator->num_distant_lights = 0;
+      kintegrator->pdf_light_tree = 0.0f;
+    }
+
     /* Portals */
     if (num_portals > 0) {
       kbackground->portal_offset = light_index;
@@ -516,6 +726,10 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->pdf_triangles = 0.0f;
     kintegrator->pdf_lights = 0.0f;
     kintegrator->use_lamp_mis = false;
+    kintegrator->use_light_tree = false;
+    kintegrator->num_light_tree_emitters = 0;
+    kintegrator->num_distant_lights = 0;
+    kintegrator->pdf_light_tree = 0.0f;
 
     kbackground->num_portals = 0;
     kbackground->portal_offset = 0;
@@ -1009,6 +1223,10 @@ void LightManager::device_update(Device *device,
 void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_background)
 {
   dscene->light_distribution.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
+  dscene->light_tree_emitter_index.free();
+  dscene->light_tree_object_offset.free();
   dscene->lights.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scene/light_tree.h"
+
+#include "util/algorithm.h"
+#include "util/math.h"
+
+CCL_NAMESPACE_BEGIN
+
+OrientationBounds merge(const OrientationBounds &cone_a, const OrientationBounds &cone_b)
+{
+  /* Smallest cone containing both cones, the wider cone is extended towards the other one. */
+  const bool a_is_wider = (cone_a.theta_o >= cone_b.theta_o);
+  const OrientationBounds &a = (a_is_wider) ? cone_a : cone_b;
+  const OrientationBounds &b = (a_is_wider) ? cone_b : cone_a;
+  const float theta_e = max(a.theta_e, b.theta_e);
+
+  const float theta_d = safe_acosf(dot(a.axis, b.axis));
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    return {a.axis, a.theta_o, theta_e};
+  }
+
+  const float theta_o = (a.theta_o + theta_d + b.theta_o) * 0.5f;
+  const float3 rotation_axis = cross(a.axis, b.axis);
+  if (theta_o >= M_PI_F || len_squared(rotation_axis) == 0.0f) {
+    return {a.axis, M_PI_F, theta_e};
+  }
+
+  const float3 axis = rotate_around_axis(a.axis, normalize(rotation_axis), theta_o - a.theta_o);
+  return {normalize(axis), theta_o, theta_e};
+}
+
+/* Measure of the directions in which the emitters emit, weighting the splits of the tree. */
+static float orientation_measure(const OrientationBounds &bcone)
+{
+  const float theta_w = min(bcone.theta_o + bcone.theta_e, M_PI_F);
+  const float cos_theta_o = cosf(bcone.theta_o);
+  const float sin_theta_o = sinf(bcone.theta_o);
+  return M_2PI_F * (1.0f - cos_theta_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(bcone.theta_o - 2.0f * theta_w) -
+                     2.0f * bcone.theta_o * sin_theta_o + cos_theta_o);
+}
+
+LightTree::LightTree(vector<LightTreePrimitive> &prims, const int max_prims_in_leaf)
+    : prims_(prims), max_prims_in_leaf_(max_prims_in_leaf)
+{
+  if (prims_.empty()) {
+    return;
+  }
+
+  nodes_.reserve(2 * prims_.size() / max_prims_in_leaf_ + 1);
+  build();
+}
+
+void LightTree::build()
+{
+  /* Nodes are built depth first with an explicit stack instead of recursion, since skewed
+   * distributions of emitters can make the tree arbitrarily deep. */
+  struct BuildTask {
+    int parent_index;
+    int start;
+    int end;
+    /* The node is the second child of its parent, which has to point to it. */
+    bool is_second_child;
+  };
+
+  vector<BuildTask> stack;
+  stack.push_back({-1, 0, (int)prims_.size(), false});
+
+  while (!stack.empty()) {
+    const BuildTask task = stack.back();
+    stack.pop_back();
+
+    const int node_index = nodes_.size();
+    if (task.is_second_child) {
+      nodes_[task.parent_index].child_index = node_index;
+    }
+
+    LightTreeNode node;
+    node.parent_index = task.parent_index;
+    node.bcone = prims_[task.start].bcone;
+
+    BoundBox centroid_bbox = BoundBox::empty;
+    for (int i = task.start; i < task.end; i++) {
+      const LightTreePrimitive &prim = prims_[i];
+      node.bbox.grow(prim.bbox);
+      node.bcone = merge(node.bcone, prim.bcone);
+      node.energy += prim.energy;
+      centroid_bbox.grow(prim.bbox.center());
+    }
+
+    if (task.end - task.start <= max_prims_in_leaf_) {
+      node.child_index = task.start;
+      node.num_prims = task.end - task.start;
+    }
+    else {
+      /* The first child is pushed last, so it is built next and directly follows the node. */
+      const int middle = split(task.start, task.end, centroid_bbox);
+      stack.push_back({node_index, middle, task.end, true});
+      stack.push_back({node_index, task.start, middle, false});
+    }
+
+    nodes_.push_back(node);
+  }
+}
+
+int LightTree::split(const int start, const int end, const BoundBox &centroid_bbox)
+{
+  struct Bucket {
+    BoundBox bbox = BoundBox::empty;
+    OrientationBounds bcone;
+    float energy = 0.0f;
+    int count = 0;
+
+    void add(const BoundBox &other_bbox, const OrientationBounds &other_bcone, float other_energy)
+    {
+      bbox.grow(other_bbox);
+      bcone = (count == 0) ? other_bcone : merge(bcone, other_bcone);
+      energy += other_energy;
+      count++;
+    }
+
+    void add(const Bucket &other)
+    {
+      if (other.count > 0) {
+        add(other.bbox, other.bcone, other.energy);
+        count += other.count - 1;
+      }
+    }
+
+    float cost() const
+    {
+      return energy * orientation_measure(bcone) * bbox.area();
+    }
+  };
+
+  const int num_buckets = 12;
+  const float3 extent = centroid_bbox.size();
+  const float max_extent = max3(extent);
+
+  auto bucket_index = [&](const LightTreePrimitive &prim, const int dim) {
+    const float offset = (prim.bbox.center()[dim] - centroid_bbox.min[dim]) / extent[dim];
+    return clamp((int)(offset * num_buckets), 0, num_buckets - 1);
+  };
+
+  /* Find the split with the lowest surface area orientation heuristic cost over the dimensions,
+   * favoring splits along the longest dimension. */
+  float best_cost = FLT_MAX;
+  int best_dim = -1;
+  int best_bucket = 0;
+
+  for (int dim = 0; dim < 3; dim++) {
+    if (extent[dim] == 0.0f) {
+      continue;
+    }
+
+    Bucket buckets[num_buckets];
+    for (int i = start; i < end; i++) {
+      const LightTreePrimitive &prim = prims_[i];
+      buckets[bucket_index(prim, dim)].add(prim.bbox, prim.bcone, prim.energy);
+    }
+
+    float cost_below[num_buckets];
+    Bucket below;
+    for (int i = 0; i < num_buckets - 1; i++) {
+      below.add(buckets[i]);
+      cost_below[i] = (below.count > 0) ? below.cost() : -1.0f;
+    }
+
+    const float regularization = max_extent / extent[dim];
+    Bucket above;
+    for (int i = num_buckets - 1; i > 0; i--) {
+      above.add(buckets[i]);
+      if (above.count == 0 || cost_below[i - 1] < 0.0f) {
+        continue;
+      }
+      const float cost = regularization * (cost_below[i - 1] + above.cost());
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_dim = dim;
+        best_bucket = i;
+      }
+    }
+  }
+
+  if (best_dim != -1) {
+    const LightTreePrimitive *middle = std::partition(
+        &prims_[start], &prims_[end - 1] + 1, [&](const LightTreePrimitive &prim) {
+          return bucket_index(prim, best_dim) < best_bucket;
+        });
+    return middle - &prims_[0];
+  }
+
+  /* All centroids are in the same place, split in the middle. */
+  return (start + end) / 2;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "util/boundbox.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Directions in which emitters emit light: the normals of the emitters are within theta_o of the
+ * axis, and every emitter emits within theta_e of its normal. */
+struct OrientationBounds {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+};
+
+OrientationBounds merge(const OrientationBounds &cone_a, const OrientationBounds &cone_b);
+
+/* Emissive triangle, or point, spot or area light. */
+struct LightTreePrimitive {
+  BoundBox bbox = BoundBox::empty;
+  OrientationBounds bcone;
+  float energy;
+  /* Index of the emitter in the light distribution. */
+  int prim_id;
+};
+
+struct LightTreeNode {
+  BoundBox bbox = BoundBox::empty;
+  OrientationBounds bcone;
+  float energy = 0.0f;
+  int parent_index = -1;
+  /* Inner nodes: index of the second child, the first child directly follows the node.
+   * Leaf nodes: index of the first primitive. */
+  int child_index = -1;
+  /* Number of primitives of leaf nodes, zero for inner nodes. */
+  int num_prims = 0;
+
+  bool is_leaf() const
+  {
+    return num_prims > 0;
+  }
+};
+
+/* Bounding volume hierarchy over emitters, to pick them proportional to an estimate of their
+ * contribution to a shading point. Nodes are split with the surface area orientation heuristic
+ * from "Importance Sampling of Many Lights with Adaptive Tree Splitting" by Conty Estevez and
+ * Kulla. The primitives are reordered so the ones of every leaf are contiguous. */
+class LightTree {
+ public:
+  LightTree(vector<LightTreePrimitive> &prims, const int max_prims_in_leaf);
+
+  const vector<LightTreeNode> &get_nodes() const
+  {
+    return nodes_;
+  }
+
+ protected:
+  void build();
+  int split(const int start, const int end, const BoundBox &centroid_bbox);
+
+  vector<LightTreePrimitive> &prims_;
+  vector<LightTreeNode> nodes_;
+  int max_prims_in_leaf_;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
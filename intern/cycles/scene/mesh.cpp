@@ -748,10 +748,17 @@ void Mesh::pack_normals(packed_float3 *vnormal)
 void Mesh::pack_verts(packed_float3 *tri_verts,
                       uint4 *tri_vindex,
                       uint *tri_patch,
-                      float2 *tri_patch_uv)
+                      float2 *tri_patch_uv,
+                      const bool use_shared_tri_verts)
 {
   size_t verts_size = verts.size();
 
+  if (use_shared_tri_verts) {
+    for (size_t i = 0; i < verts_size; i++) {
+      tri_verts[i] = verts[i];
+    }
+  }
+
   if (verts_size && get_num_subd_faces()) {
     float2 *vert_patch_uv_ptr = vert_patch_uv.data();
 
@@ -769,9 +776,11 @@ void Mesh::pack_verts(packed_float3 *tri_verts,
 
     tri_patch[i] = (!get_num_subd_faces()) ? -1 : (triangle_patch[i] * 8 + patch_offset);
 
-    tri_verts[i * 3] = verts[t.v[0]];
-    tri_verts[i * 3 + 1] = verts[t.v[1]];
-    tri_verts[i * 3 + 2] = verts[t.v[2]];
+    if (!use_shared_tri_verts) {
+      tri_verts[i * 3] = verts[t.v[0]];
+      tri_verts[i * 3 + 1] = verts[t.v[1]];
+      tri_verts[i * 3 + 2] = verts[t.v[2]];
+    }
   }
 }
 
@@ -231,7 +231,8 @@ class Mesh : public Geometry {
   void pack_verts(packed_float3 *tri_verts,
                   uint4 *tri_vindex,
                   uint *tri_patch,
-                  float2 *tri_patch_uv);
+                  float2 *tri_patch_uv,
+                  const bool use_shared_tri_verts);
   void pack_patches(uint *patch_data);
 
   PrimitiveType primitive_type() const override;
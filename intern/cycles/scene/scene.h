@@ -123,6 +123,10 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
+  device_vector<uint> light_tree_emitter_index;
+  device_vector<uint> light_tree_object_offset;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -161,11 +165,14 @@ class SceneParams {
   BVHType bvh_type;
   bool use_bvh_spatial_split;
   bool use_bvh_compact_structure;
+  bool use_bvh_compression;
   bool use_bvh_unaligned_nodes;
   int num_bvh_time_steps;
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
+  bool use_texture_cache;
+  int texture_cache_size;
 
   bool background;
 
@@ -176,11 +183,14 @@ class SceneParams {
     bvh_type = BVH_TYPE_DYNAMIC;
     use_bvh_spatial_split = false;
     use_bvh_compact_structure = true;
+    use_bvh_compression = false;
     use_bvh_unaligned_nodes = true;
     num_bvh_time_steps = 0;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    use_texture_cache = false;
+    texture_cache_size = 4096;
     background = true;
   }
 
@@ -190,10 +200,13 @@ class SceneParams {
              bvh_type == params.bvh_type &&
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_compact_structure == params.use_bvh_compact_structure &&
+             use_bvh_compression == params.use_bvh_compression &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             use_texture_cache == params.use_texture_cache &&
+             texture_cache_size == params.texture_cache_size);
   }
 
   int curve_subdivisions()
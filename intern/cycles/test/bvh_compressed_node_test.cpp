@@ -0,0 +1,144 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "bvh/bvh2.h"
+#include "util/math.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Gives access to the packing of a single compressed node. */
+class CompressedNodeBVH : public BVH2 {
+ public:
+  CompressedNodeBVH() : BVH2(BVHParams(), vector<Geometry *>(), vector<Object *>())
+  {
+    params.use_compressed_nodes = true;
+    pack.nodes.resize(BVH_COMPRESSED_NODE_SIZE);
+  }
+
+  /* Pack the children and decode their bounds the same way the kernel does. */
+  void pack_and_decode(const BoundBox &b0, const BoundBox &b1, BoundBox r_bounds[2])
+  {
+    pack_compressed_node(0, b0, b1, 0, 0, ~0u, ~0u);
+
+    const int4 node0 = pack.nodes[1];
+    const int4 node1 = pack.nodes[2];
+    const float origin[3] = {
+        __int_as_float(node0.x), __int_as_float(node0.y), __int_as_float(node0.z)};
+    const uint exponents = (uint)node0.w;
+    const uint quantized[3] = {(uint)node1.x, (uint)node1.y, (uint)node1.z};
+
+    for (int child = 0; child < 2; child++) {
+      float lo[3], hi[3];
+      for (int axis = 0; axis < 3; axis++) {
+        const float scale = __uint_as_float(((exponents >> (axis * 8)) & 0xff) << 23);
+        lo[axis] = origin[axis] + (float)((quantized[axis] >> (child * 8)) & 0xff) * scale;
+        hi[axis] = origin[axis] + (float)((quantized[axis] >> (16 + child * 8)) & 0xff) * scale;
+      }
+      r_bounds[child] = BoundBox(make_float3(lo[0], lo[1], lo[2]),
+                                 make_float3(hi[0], hi[1], hi[2]));
+    }
+  }
+};
+
+}  // namespace
+
+static void expect_contains(const BoundBox &decoded, const BoundBox &original)
+{
+  EXPECT_TRUE(isfinite_safe(decoded.min.x) && isfinite_safe(decoded.min.y) &&
+              isfinite_safe(decoded.min.z));
+  EXPECT_TRUE(isfinite_safe(decoded.max.x) && isfinite_safe(decoded.max.y) &&
+              isfinite_safe(decoded.max.z));
+  if (!original.valid()) {
+    return;
+  }
+  EXPECT_LE(decoded.min.x, original.min.x);
+  EXPECT_LE(decoded.min.y, original.min.y);
+  EXPECT_LE(decoded.min.z, original.min.z);
+  EXPECT_GE(decoded.max.x, original.max.x);
+  EXPECT_GE(decoded.max.y, original.max.y);
+  EXPECT_GE(decoded.max.z, original.max.z);
+}
+
+static void check_compressed_node(const BoundBox &b0, const BoundBox &b1)
+{
+  CompressedNodeBVH bvh;
+  BoundBox decoded[2];
+  bvh.pack_and_decode(b0, b1, decoded);
+  expect_contains(decoded[0], b0);
+  expect_contains(decoded[1], b1);
+}
+
+TEST(bvh_compressed_node, Regular)
+{
+  check_compressed_node(BoundBox(make_float3(0.0f, 0.0f, 0.0f), make_float3(1.0f, 1.0f, 1.0f)),
+                        BoundBox(make_float3(0.5f, -2.0f, 0.3f), make_float3(3.0f, 0.1f, 0.7f)));
+  check_compressed_node(
+      BoundBox(make_float3(-1e5f, 3.0f, -0.1f), make_float3(-99999.9f, 3.1f, 0.1f)),
+      BoundBox(make_float3(1e5f, -7.0f, 1e-5f), make_float3(1e5f + 0.3f, 7.0f, 2e-5f)));
+}
+
+TEST(bvh_compressed_node, Randomized)
+{
+  /* Deterministic pseudo random boxes over a wide range of scales and offsets. */
+  uint state = 12345;
+  auto random = [&]() {
+    state = state * 1664525u + 1013904223u;
+    return (float)(state >> 8) / (float)(1u << 24);
+  };
+
+  for (int i = 0; i < 10000; i++) {
+    const float offset = (random() - 0.5f) * powf(10.0f, random() * 12.0f - 6.0f);
+    const float size = powf(10.0f, random() * 12.0f - 6.0f);
+    BoundBox b[2];
+    for (int child = 0; child < 2; child++) {
+      const float3 min = make_float3(offset + random() * size,
+                                     offset + random() * size,
+                                     offset + random() * size);
+      const float3 extent = make_float3(random(), random(), random()) * size;
+      b[child] = BoundBox(min, min + extent);
+    }
+    check_compressed_node(b[0], b[1]);
+  }
+}
+
+TEST(bvh_compressed_node, Flat)
+{
+  /* Children with zero extent along an axis, and points. */
+  check_compressed_node(BoundBox(make_float3(0.0f, 0.0f, 2.0f), make_float3(1.0f, 1.0f, 2.0f)),
+                        BoundBox(make_float3(0.0f, 0.0f, 2.0f), make_float3(1.0f, 1.0f, 2.0f)));
+  check_compressed_node(BoundBox(make_float3(0.0f, 5.0f, 0.0f), make_float3(1.0f, 5.0f, 1.0f)),
+                        BoundBox(make_float3(0.3f, 5.0f, -1.0f), make_float3(0.3f, 5.0f, 1.0f)));
+  check_compressed_node(BoundBox(make_float3(1.0f, 2.0f, 3.0f)),
+                        BoundBox(make_float3(1.0f, 2.0f, 3.0f)));
+  check_compressed_node(BoundBox(make_float3(-1e6f, 1e-6f, 0.0f)),
+                        BoundBox(make_float3(1e6f, 2e-6f, 0.0f)));
+}
+
+TEST(bvh_compressed_node, Empty)
+{
+  /* Empty children, for example of nodes that only contain invisible primitives. */
+  check_compressed_node(BoundBox(BoundBox::empty),
+                        BoundBox(make_float3(-1.0f, 0.0f, 4.0f), make_float3(1.0f, 0.5f, 4.5f)));
+  check_compressed_node(BoundBox(make_float3(-1.0f, 0.0f, 4.0f), make_float3(1.0f, 0.5f, 4.5f)),
+                        BoundBox(BoundBox::empty));
+  check_compressed_node(BoundBox(BoundBox::empty), BoundBox(BoundBox::empty));
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "bvh/bvh2.h"
+#include "device/device.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+#include "util/math.h"
+#include "util/progress.h"
+#include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+const int grid_size = 32;
+
+class BVHRefit : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device;
+  DeviceScene *dscene;
+  SceneParams scene_params;
+  Progress progress;
+  Mesh *mesh;
+
+  virtual void SetUp()
+  {
+    device = Device::create(device_info, stats, profiler);
+    dscene = new DeviceScene(device);
+    scene_params.bvh_layout = BVH_LAYOUT_BVH2;
+
+    /* Flat grid of quads, the geometry is not transform applied so it gets its own BVH. */
+    mesh = new Mesh();
+    mesh->reserve_mesh(grid_size * grid_size, (grid_size - 1) * (grid_size - 1) * 2);
+    for (int y = 0; y < grid_size; y++) {
+      for (int x = 0; x < grid_size; x++) {
+        mesh->add_vertex(make_float3((float)x, (float)y, 0.0f));
+      }
+    }
+    for (int y = 0; y < grid_size - 1; y++) {
+      for (int x = 0; x < grid_size - 1; x++) {
+        const int v = y * grid_size + x;
+        mesh->add_triangle(v, v + 1, v + grid_size + 1, 0, false);
+        mesh->add_triangle(v, v + grid_size + 1, v + grid_size, 0, false);
+      }
+    }
+  }
+
+  virtual void TearDown()
+  {
+    delete mesh;
+    delete dscene;
+    delete device;
+  }
+
+  /* Build or refit the BVH the same way the geometry manager does. */
+  BVH2 *update_bvh()
+  {
+    mesh->compute_bvh(device, dscene, &scene_params, &progress, 0, 1);
+    return static_cast<BVH2 *>(mesh->bvh);
+  }
+
+  BoundBox triangle_bounds(const int prim) const
+  {
+    BoundBox bounds = BoundBox::empty;
+    mesh->get_triangle(prim).bounds_grow(&mesh->verts[0], bounds);
+    return bounds;
+  }
+
+  /* Check that the packed bounds of every node contain all primitives below it, and count the
+   * primitives in the leaves. Returns the bounds of the primitives below the node. */
+  BoundBox check_node(const BVH2 *bvh, const int idx, const bool leaf, int &num_prims) const
+  {
+    BoundBox bounds = BoundBox::empty;
+
+    if (leaf) {
+      const int4 data = bvh->pack.leaf_nodes[idx];
+      for (int prim = data.x; prim < data.y; prim++) {
+        bounds.grow(triangle_bounds(bvh->pack.prim_index[prim]));
+        num_prims++;
+      }
+      return bounds;
+    }
+
+    const int4 *data = &bvh->pack.nodes[idx];
+    const int child[2] = {data[0].z, data[0].w};
+    for (int i = 0; i < 2; i++) {
+      const BoundBox child_bounds = check_node(
+          bvh, (child[i] < 0) ? -child[i] - 1 : child[i], child[i] < 0, num_prims);
+      /* Rows of min x, y, z and max x, y, z of both children. */
+      const BoundBox packed_bounds(make_float3(__int_as_float(data[1][i]),
+                                               __int_as_float(data[2][i]),
+                                               __int_as_float(data[3][i])),
+                                   make_float3(__int_as_float(data[1][2 + i]),
+                                               __int_as_float(data[2][2 + i]),
+                                               __int_as_float(data[3][2 + i])));
+      EXPECT_TRUE(packed_bounds.min.x <= child_bounds.min.x &&
+                  packed_bounds.min.y <= child_bounds.min.y &&
+                  packed_bounds.min.z <= child_bounds.min.z &&
+                  packed_bounds.max.x >= child_bounds.max.x &&
+                  packed_bounds.max.y >= child_bounds.max.y &&
+                  packed_bounds.max.z >= child_bounds.max.z);
+      bounds.grow(child_bounds);
+    }
+    return bounds;
+  }
+
+  BoundBox check_bvh(const BVH2 *bvh) const
+  {
+    int num_prims = 0;
+    const BoundBox bounds = check_node(bvh, 0, bvh->pack.root_index == -1, num_prims);
+    EXPECT_EQ(num_prims, (int)mesh->num_triangles());
+    return bounds;
+  }
+};
+
+}  // namespace
+
+TEST_F(BVHRefit, Deform)
+{
+  BVH2 *bvh = update_bvh();
+  ASSERT_NE(bvh, nullptr);
+  EXPECT_EQ(bvh->num_refits, 0);
+  check_bvh(bvh);
+
+  /* Small deformation, keeps the structure of the tree useful. */
+  array<float3> &verts = mesh->get_verts();
+  for (size_t i = 0; i < verts.size(); i++) {
+    verts[i].z = 0.2f * sinf(verts[i].x * 0.5f) * cosf(verts[i].y * 0.5f);
+  }
+
+  bvh = update_bvh();
+  EXPECT_EQ(bvh->num_refits, 1);
+  EXPECT_FALSE(bvh->need_rebuild());
+  const BoundBox refit_bounds = check_bvh(bvh);
+
+  /* A fresh build of the deformed mesh covers the same primitives. */
+  mesh->need_update_rebuild = true;
+  bvh = update_bvh();
+  EXPECT_EQ(bvh->num_refits, 0);
+  const BoundBox build_bounds = check_bvh(bvh);
+
+  EXPECT_FLOAT_EQ(refit_bounds.min.x, build_bounds.min.x);
+  EXPECT_FLOAT_EQ(refit_bounds.min.y, build_bounds.min.y);
+  EXPECT_FLOAT_EQ(refit_bounds.min.z, build_bounds.min.z);
+  EXPECT_FLOAT_EQ(refit_bounds.max.x, build_bounds.max.x);
+  EXPECT_FLOAT_EQ(refit_bounds.max.y, build_bounds.max.y);
+  EXPECT_FLOAT_EQ(refit_bounds.max.z, build_bounds.max.z);
+}
+
+TEST_F(BVHRefit, RebuildAfterSAHIncrease)
+{
+  BVH2 *bvh = update_bvh();
+  ASSERT_NE(bvh, nullptr);
+
+  /* Scatter the vertices over the grid, so that every triangle spans a large part of it and the
+   * bounds of the refit nodes overlap. */
+  array<float3> &verts = mesh->get_verts();
+  array<float3> scattered(verts.size());
+  for (size_t i = 0; i < verts.size(); i++) {
+    scattered[i] = verts[(i * 541) % verts.size()];
+  }
+  for (size_t i = 0; i < verts.size(); i++) {
+    verts[i] = scattered[i];
+  }
+
+  bvh = update_bvh();
+  EXPECT_EQ(bvh->num_refits, 1);
+  EXPECT_GT(bvh->sah_cost, bvh->build_sah_cost * bvh->params.max_refit_sah_cost_ratio);
+  EXPECT_TRUE(bvh->need_rebuild());
+  check_bvh(bvh);
+
+  /* The next update builds the BVH again instead of refitting it. */
+  bvh = update_bvh();
+  EXPECT_EQ(bvh->num_refits, 0);
+  EXPECT_EQ(bvh->sah_cost, bvh->build_sah_cost);
+  EXPECT_FALSE(bvh->need_rebuild());
+  check_bvh(bvh);
+}
+
+CCL_NAMESPACE_END
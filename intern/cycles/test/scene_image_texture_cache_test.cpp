@@ -0,0 +1,159 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "scene/image.h"
+#include "scene/image_oiio.h"
+
+#include "util/path.h"
+#include "util/texture.h"
+
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/imagebuf.h>
+#include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/texture.h>
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+class ImageTextureCacheTest : public testing::Test {
+ protected:
+  static constexpr int width = 64;
+  static constexpr int height = 48;
+
+  string filepath;
+  OIIO::TextureSystem *texture_system = nullptr;
+  TextureCacheInfo cache_info;
+  /* Pixels as loaded into memory when the texture cache is not used. */
+  vector<float> pixels;
+
+  void SetUp() override
+  {
+    filepath = path_join(OIIO::Filesystem::temp_directory_path(),
+                         OIIO::Filesystem::unique_path("cycles_texture_cache_%%%%%%.tx"));
+
+    /* Tiled and mipmapped image, with a different value in every pixel. */
+    OIIO::ImageBuf image(OIIO::ImageSpec(width, height, 4, TypeDesc::FLOAT));
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        const float pixel[4] = {
+            x / float(width), y / float(height), float((x * 7 + y * 13) % 17) / 17.0f, 1.0f};
+        image.setpixel(x, y, pixel);
+      }
+    }
+    OIIO::ImageSpec config;
+    config.tile_width = 16;
+    config.tile_height = 16;
+    ASSERT_TRUE(OIIO::ImageBufAlgo::make_texture(
+        OIIO::ImageBufAlgo::MakeTxTexture, image, filepath, config));
+
+    OIIOImageLoader loader(filepath);
+    ImageDeviceFeatures features;
+    features.has_nanovdb = false;
+    ImageMetaData metadata;
+    ASSERT_TRUE(loader.load_metadata(features, metadata));
+    ASSERT_EQ(metadata.type, IMAGE_DATA_TYPE_FLOAT4);
+    ASSERT_EQ(metadata.width, width);
+    ASSERT_EQ(metadata.height, height);
+    pixels.resize(width * height * 4);
+    ASSERT_TRUE(loader.load_pixels(metadata, pixels.data(), pixels.size(), true));
+
+    texture_system = OIIO::TextureSystem::create(false);
+    texture_cache_info_init(&cache_info, texture_system, ustring(filepath));
+  }
+
+  void TearDown() override
+  {
+    if (texture_system) {
+      OIIO::TextureSystem::destroy(texture_system);
+    }
+    path_remove(filepath);
+  }
+
+  float4 pixel(int x, int y) const
+  {
+    x = (x + width) % width;
+    y = (y + height) % height;
+    const float *p = &pixels[(y * width + x) * 4];
+    return make_float4(p[0], p[1], p[2], p[3]);
+  }
+
+  float4 lookup(const InterpolationType interpolation, const float x, const float y) const
+  {
+    float result[4];
+    EXPECT_TRUE(cache_info.lookup(
+        &cache_info, interpolation, EXTENSION_REPEAT, x, y, 0.0f, 0.0f, 0.0f, 0.0f, result));
+    return make_float4(result[0], result[1], result[2], result[3]);
+  }
+};
+
+#define EXPECT_FLOAT4_NEAR(a, b) \
+  { \
+    const float4 a_ = (a), b_ = (b); \
+    EXPECT_NEAR(a_.x, b_.x, 1e-5f); \
+    EXPECT_NEAR(a_.y, b_.y, 1e-5f); \
+    EXPECT_NEAR(a_.z, b_.z, 1e-5f); \
+    EXPECT_NEAR(a_.w, b_.w, 1e-5f); \
+  } \
+  (void)0
+
+}  // namespace
+
+TEST_F(ImageTextureCacheTest, closest)
+{
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const float u = (x + 0.5f) / width;
+      const float v = (y + 0.5f) / height;
+      EXPECT_FLOAT4_NEAR(lookup(INTERPOLATION_CLOSEST, u, v), pixel(x, y));
+    }
+  }
+}
+
+TEST_F(ImageTextureCacheTest, linear)
+{
+  /* Points between pixel centers, including ones which wrap around the image border. */
+  const float2 points[] = {make_float2(0.3f, 0.6f),
+                           make_float2(0.71f, 0.13f),
+                           make_float2(0.005f, 0.5f),
+                           make_float2(0.5f, 0.995f)};
+  for (const float2 point : points) {
+    const float px = point.x * width - 0.5f;
+    const float py = point.y * height - 0.5f;
+    const int ix = (int)floorf(px);
+    const int iy = (int)floorf(py);
+    const float tx = px - ix;
+    const float ty = py - iy;
+    const float4 expected = (1.0f - ty) * ((1.0f - tx) * pixel(ix, iy) + tx * pixel(ix + 1, iy)) +
+                            ty * ((1.0f - tx) * pixel(ix, iy + 1) + tx * pixel(ix + 1, iy + 1));
+    EXPECT_FLOAT4_NEAR(lookup(INTERPOLATION_LINEAR, point.x, point.y), expected);
+  }
+}
+
+TEST_F(ImageTextureCacheTest, missing_file)
+{
+  TextureCacheInfo missing_info;
+  texture_cache_info_init(
+      &missing_info, texture_system, ustring(path_join(path_dirname(filepath), "missing.tx")));
+
+  float result[4];
+  EXPECT_FALSE(missing_info.lookup(
+      &missing_info, INTERPOLATION_CLOSEST, EXTENSION_REPEAT, 0.5f, 0.5f, 0, 0, 0, 0, result));
+}
+
+CCL_NAMESPACE_END
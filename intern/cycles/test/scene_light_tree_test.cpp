@@ -0,0 +1,153 @@
+/*
+ * Copyright 2011-2022 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "scene/light_tree.h"
+#include "util/math.h"
+
+CCL_NAMESPACE_BEGIN
+
+static LightTreePrimitive make_point_prim(const float3 co, const int prim_id)
+{
+  LightTreePrimitive prim;
+  prim.bbox.grow(co);
+  prim.bcone = {make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F};
+  prim.energy = 1.0f;
+  prim.prim_id = prim_id;
+  return prim;
+}
+
+static bool bbox_contains(const BoundBox &outer, const BoundBox &inner)
+{
+  return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+         outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+/* Check the layout the kernel relies on, and that every primitive is in exactly one leaf. Returns
+ * the depth of the tree. */
+static int check_light_tree(const LightTree &tree,
+                            const vector<LightTreePrimitive> &prims,
+                            const int max_prims_in_leaf)
+{
+  const vector<LightTreeNode> &nodes = tree.get_nodes();
+  EXPECT_FALSE(nodes.empty());
+  EXPECT_EQ(nodes[0].parent_index, -1);
+
+  vector<int> prim_leaf_count(prims.size(), 0);
+  vector<int> depth(nodes.size(), 0);
+  int max_depth = 0;
+
+  for (int i = 0; i < nodes.size(); i++) {
+    const LightTreeNode &node = nodes[i];
+    if (i > 0) {
+      EXPECT_LT(node.parent_index, i);
+      depth[i] = depth[node.parent_index] + 1;
+      max_depth = max(max_depth, depth[i]);
+    }
+
+    if (node.is_leaf()) {
+      EXPECT_LE(node.num_prims, max_prims_in_leaf);
+      for (int j = node.child_index; j < node.child_index + node.num_prims; j++) {
+        EXPECT_TRUE(bbox_contains(node.bbox, prims[j].bbox));
+        prim_leaf_count[j]++;
+      }
+      continue;
+    }
+
+    const int first_child = i + 1;
+    const int second_child = node.child_index;
+    EXPECT_GT(second_child, first_child);
+    EXPECT_LT(second_child, nodes.size());
+    if (second_child <= first_child || second_child >= nodes.size()) {
+      continue;
+    }
+    EXPECT_EQ(nodes[first_child].parent_index, i);
+    EXPECT_EQ(nodes[second_child].parent_index, i);
+    EXPECT_TRUE(bbox_contains(node.bbox, nodes[first_child].bbox));
+    EXPECT_TRUE(bbox_contains(node.bbox, nodes[second_child].bbox));
+    EXPECT_FLOAT_EQ(node.energy, nodes[first_child].energy + nodes[second_child].energy);
+  }
+
+  for (int i = 0; i < prims.size(); i++) {
+    EXPECT_EQ(prim_leaf_count[i], 1) << "primitive " << i;
+  }
+
+  return max_depth;
+}
+
+TEST(LightTree, Empty)
+{
+  vector<LightTreePrimitive> prims;
+  LightTree tree(prims, 1);
+  EXPECT_TRUE(tree.get_nodes().empty());
+}
+
+TEST(LightTree, SinglePrimitive)
+{
+  vector<LightTreePrimitive> prims;
+  prims.push_back(make_point_prim(make_float3(1.0f, 2.0f, 3.0f), 0));
+  LightTree tree(prims, 1);
+
+  ASSERT_EQ(tree.get_nodes().size(), 1);
+  EXPECT_TRUE(tree.get_nodes()[0].is_leaf());
+  check_light_tree(tree, prims, 1);
+}
+
+TEST(LightTree, Grid)
+{
+  vector<LightTreePrimitive> prims;
+  for (int i = 0; i < 1000; i++) {
+    prims.push_back(make_point_prim(make_float3(i % 10, (i / 10) % 10, i / 100), i));
+  }
+  const int max_prims_in_leaf = 4;
+  LightTree tree(prims, max_prims_in_leaf);
+  check_light_tree(tree, prims, max_prims_in_leaf);
+
+  /* The primitives are reordered, not duplicated or lost. */
+  vector<bool> found(prims.size(), false);
+  for (const LightTreePrimitive &prim : prims) {
+    EXPECT_FALSE(found[prim.prim_id]);
+    found[prim.prim_id] = true;
+  }
+}
+
+TEST(LightTree, Coincident)
+{
+  /* All centroids in the same place, split in the middle. */
+  vector<LightTreePrimitive> prims;
+  for (int i = 0; i < 1000; i++) {
+    prims.push_back(make_point_prim(make_float3(1.0f, 1.0f, 1.0f), i));
+  }
+  LightTree tree(prims, 1);
+  const int depth = check_light_tree(tree, prims, 1);
+  EXPECT_LE(depth, 10);
+}
+
+TEST(LightTree, Skewed)
+{
+  /* Exponentially spaced emitters only peel off a few primitives per split, building a tree as
+   * deep as the number of primitives. */
+  vector<LightTreePrimitive> prims;
+  for (int i = 0; i < 120; i++) {
+    prims.push_back(make_point_prim(make_float3(powf(2.0f, i), 0.0f, 0.0f), i));
+  }
+  LightTree tree(prims, 1);
+  const int depth = check_light_tree(tree, prims, 1);
+  EXPECT_GT(depth, 20);
+}
+
+CCL_NAMESPACE_END
@@ -79,6 +79,11 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout;
+
+    /* Render paths in batches, running each integrator kernel over all paths of the batch which
+     * are queued for it, with surface shading sorted by shader. The default is to run the
+     * megakernel for one path at a time. */
+    bool use_wavefront;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
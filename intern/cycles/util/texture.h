@@ -50,6 +50,7 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_USHORT = 7,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT = 8,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
+  IMAGE_DATA_TYPE_OIIO = 10,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
@@ -94,6 +95,30 @@ typedef struct TextureInfo {
   Transform transform_3d;
 } TextureInfo;
 
+#ifndef __KERNEL_GPU__
+/* Data of IMAGE_DATA_TYPE_OIIO textures, which are not loaded into memory but read on demand
+ * through an OpenImageIO texture system on the CPU. */
+typedef struct TextureCacheInfo {
+  /* Look up the RGBA value at the given texture coordinates and their derivatives. This is
+   * implemented on the host, so that OpenImageIO is not part of the kernels which are compiled
+   * for each instruction set. Returns false when the image could not be read. */
+  bool (*lookup)(const struct TextureCacheInfo *cache_info,
+                 uint interpolation,
+                 uint extension,
+                 float x,
+                 float y,
+                 float dsdx,
+                 float dtdx,
+                 float dsdy,
+                 float dtdy,
+                 float result[4]);
+  /* OIIO::TextureSystem. */
+  void *texture_system;
+  /* OIIO::TextureSystem::TextureHandle of the image file. */
+  void *handle;
+} TextureCacheInfo;
+#endif
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_TEXTURE_H__ */
@@ -40,6 +40,7 @@ const UserDef U_default = {
                USER_DUP_ACT | USER_DUP_LIGHTPROBE | USER_DUP_GPENCIL,
     .pref_flag = USER_PREF_FLAG_SAVE,
     .savetime = 2,
+    .file_compression_level = 3,
     .tempdir = "",
     .fontdir = "//",
     .renderdir = "//",
@@ -129,6 +130,7 @@ const UserDef U_default = {
 
     /** Clamped by half the systems memory. */
     .memcachelimit = 4096,
+    .geometry_nodes_cache_limit = 256,
 
     .prefetchframes = 0,
     .pad_rot_angle = 15,
@@ -658,6 +658,11 @@ class USERPREF_PT_system_memory(SystemPanel, CenterAlignMixIn, Panel):
 
         layout.separator()
 
+        col = layout.column()
+        col.prop(system, "geometry_nodes_cache_limit", text="Geometry Nodes Cache Limit")
+
+        layout.separator()
+
         col = layout.column()
         col.prop(system, "texture_time_out", text="Texture Time Out")
         col.prop(system, "texture_collection_rate", text="Garbage Collection Rate")
@@ -1474,6 +1479,11 @@ class USERPREF_PT_saveload_blend(SaveLoadPanel, CenterAlignMixIn, Panel):
         col.prop(paths, "use_file_compression")
         col.prop(paths, "use_load_ui")
 
+        col = layout.column()
+        sub = col.column()
+        sub.active = paths.use_file_compression
+        sub.prop(paths, "file_compression_level")
+
         col = layout.column(heading="Text Files")
         col.prop(paths, "use_tabs_as_spaces")
 
@@ -2298,6 +2308,7 @@ class USERPREF_PT_experimental_prototypes(ExperimentalPanel, Panel):
                 ({"property": "use_new_hair_type"}, "T68981"),
                 ({"property": "use_new_point_cloud_type"}, "T75717"),
                 ({"property": "use_full_frame_compositor"}, "T88150"),
+                ({"property": "use_undo_skip_unchanged_ids"}, None),
             ),
         )
 
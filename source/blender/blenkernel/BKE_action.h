@@ -37,10 +37,12 @@ struct BlendWriter;
 struct bArmature;
 
 /* The following structures are defined in DNA_action_types.h, and DNA_anim_types.h */
+struct ActionEvalProgram;
 struct AnimationEvalContext;
 struct FCurve;
 struct Main;
 struct Object;
+struct SessionUUID;
 struct bAction;
 struct bActionGroup;
 struct bItasc;
@@ -108,6 +110,42 @@ bool action_has_motion(const struct bAction *act);
  */
 bool BKE_action_is_cyclic(const struct bAction *act);
 
+/* Action Evaluation Program ----------------- */
+
+/**
+ * Get the evaluation program of the evaluated action, compiling it when needed.
+ *
+ * The program stores key-frames of the F-Curves with constant, linear and Bezier interpolation
+ * in flat arrays, together with the segment handles already corrected for evaluation. This
+ * avoids going over all F-Curves of the action and their #BezTriple for every evaluation.
+ *
+ * The program is not updated when F-Curves change, so it is only to be used for actions
+ * covered by copy-on-write, which are copied again on change.
+ */
+const struct ActionEvalProgram *BKE_action_eval_program_ensure(struct bAction *act);
+void BKE_action_eval_program_free(struct bAction *act);
+
+/**
+ * Unique identifier of the program within the session. Programs compiled again after the
+ * evaluated action was copied have a different identifier.
+ */
+const struct SessionUUID *BKE_action_eval_program_session_uuid(
+    const struct ActionEvalProgram *program);
+
+/**
+ * F-Curves of the program: all the non-empty F-Curves of the action, in the order of the action.
+ */
+int BKE_action_eval_program_fcurves_num(const struct ActionEvalProgram *program);
+struct FCurve **BKE_action_eval_program_fcurves(const struct ActionEvalProgram *program);
+
+/**
+ * Evaluate all F-Curves of the program at the given time.
+ * Gives the same values as #evaluate_fcurve for every F-Curve of the program.
+ */
+void BKE_action_eval_program_evaluate(const struct ActionEvalProgram *program,
+                                      float evaltime,
+                                      float *r_values);
+
 /* Action Groups API ----------------- */
 
 /**
@@ -372,6 +372,17 @@ void BKE_animsys_eval_driver(struct Depsgraph *depsgraph,
 
 void BKE_animsys_update_driver_array(struct ID *id);
 
+/**
+ * Free the RNA paths of the F-Curves of the active action, resolved for the evaluation of the
+ * animation data of an evaluated ID.
+ */
+void BKE_animsys_eval_rna_cache_free(struct AnimData *adt);
+/**
+ * Free the resolved RNA paths of the evaluated ID, for when the data they point to might have
+ * been changed without the ID being copied again (relations update for example).
+ */
+void BKE_animsys_eval_rna_cache_invalidate(struct ID *id);
+
 /* ************************************* */
 
 #ifdef __cplusplus
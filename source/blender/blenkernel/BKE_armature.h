@@ -587,6 +587,14 @@ void BKE_pose_eval_init_ik(struct Depsgraph *depsgraph,
                            struct Scene *scene,
                            struct Object *object);
 
+/**
+ * Mark the pose matrix of the bone as computed from something else than its channel and the pose
+ * matrix of its parent (rest position, constraints or IK), so it is not kept by the next
+ * evaluation and children of the bone are evaluated again. Solvers call this for every bone they
+ * write the pose matrix of.
+ */
+void BKE_pose_channel_eval_mat_invalidate(struct bPoseChannel *pchan);
+
 void BKE_pose_eval_bone(struct Depsgraph *depsgraph,
                         struct Scene *scene,
                         struct Object *object,
@@ -664,6 +672,11 @@ void BKE_armature_deform_coords_with_editmesh(const struct Object *ob_arm,
                                               const char *defgrp_name,
                                               struct BMEditMesh *em_target);
 
+/**
+ * Free the vertex group weights cached by armature deform on the mesh runtime.
+ */
+void BKE_armature_deform_weights_discard(struct Mesh *mesh);
+
 /** \} */
 
 #ifdef __cplusplus
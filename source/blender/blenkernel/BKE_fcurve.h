@@ -493,6 +493,19 @@ bool test_time_fcurve(struct FCurve *fcu);
  */
 void BKE_fcurve_correct_bezpart(const float v1[2], float v2[2], float v3[2], const float v4[2]);
 
+/**
+ * Evaluate the Bezier segment defined by key-frames (v1, v4) and handles (v2, v3) at the given
+ * time. The handles are expected to be corrected with #BKE_fcurve_correct_bezpart already.
+ *
+ * \return false when there is no point of the segment at the given time.
+ */
+bool BKE_fcurve_bezpart_evaluate(const float v1[2],
+                                 const float v2[2],
+                                 const float v3[2],
+                                 const float v4[2],
+                                 float evaltime,
+                                 float *r_value);
+
 /* -------- Evaluation -------- */
 
 /* evaluate fcurve */
@@ -540,6 +540,14 @@ class MeshComponent : public GeometryComponent {
  private:
   Mesh *mesh_ = nullptr;
   GeometryOwnershipType ownership_ = GeometryOwnershipType::Owned;
+  /**
+   * When the component is copied, the custom data layers of the new mesh reference the layers of
+   * the original mesh (#CD_FLAG_NOFREE) instead of duplicating them. The new component keeps a
+   * user of the component it was copied from, so that the shared layers stay valid and unchanged.
+   * Layers are duplicated when they are modified through the attribute API, or all at once when
+   * the mesh is accessed with #get_for_write.
+   */
+  const MeshComponent *shared_layers_owner_ = nullptr;
 
  public:
   MeshComponent();
@@ -568,6 +576,13 @@ class MeshComponent : public GeometryComponent {
    * i.e. it is not shared. The returned mesh can be modified. No ownership is transferred.
    */
   Mesh *get_for_write();
+  /**
+   * Same as #get_for_write, but the custom data layers of the mesh may still be shared with
+   * another mesh. Every layer has to be made mutable with #CustomData_duplicate_referenced_layer
+   * before it is modified, like the attribute API does. Prefer this over #get_for_write when only
+   * a few layers are changed, to avoid copying the others.
+   */
+  Mesh *get_for_write_with_shared_layers();
 
   int attribute_domain_size(AttributeDomain domain) const final;
 
@@ -579,6 +594,9 @@ class MeshComponent : public GeometryComponent {
   static constexpr inline GeometryComponentType static_type = GEO_COMPONENT_TYPE_MESH;
 
  private:
+  /** Duplicate the layers shared with another mesh and release the other component. */
+  void unshare_layers();
+
   const blender::bke::ComponentAttributeProviders *get_attribute_providers() const final;
 
   blender::fn::GVArray attribute_try_adapt_domain_impl(const blender::fn::GVArray &varray,
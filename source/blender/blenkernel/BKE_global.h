@@ -212,6 +212,8 @@ enum {
   G_DEBUG_XR_TIME = (1 << 20),               /* XR/OpenXR timing messages */
 
   G_DEBUG_GHOST = (1 << 21), /* Debug GHOST module. */
+
+  G_DEBUG_DEPSGRAPH_VERIFY = (1 << 22), /* Verify partial depsgraph relations updates. */
 };
 
 #define G_DEBUG_ALL \
@@ -67,6 +67,14 @@ void BKE_object_workob_calc_parent(struct Depsgraph *depsgraph,
                                    struct Object *workob);
 
 void BKE_object_transform_copy(struct Object *ob_tar, const struct Object *ob_src);
+/**
+ * Copy all the settings which only tag the object for update with #ID_RECALC_TRANSFORM:
+ * the transform channels and their deltas, parenting settings stored in the object itself,
+ * locks, instancing and display settings.
+ *
+ * Is used to update the evaluated object without copying it as a whole.
+ */
+void BKE_object_transform_settings_copy(struct Object *ob_tar, const struct Object *ob_src);
 void BKE_object_copy_softbody(struct Object *ob_dst, const struct Object *ob_src, int flag);
 struct ParticleSystem *BKE_object_copy_particlesystem(struct ParticleSystem *psys, int flag);
 void BKE_object_copy_particlesystems(struct Object *ob_dst, const struct Object *ob_src, int flag);
@@ -151,6 +151,9 @@ static void action_copy_data(Main *UNUSED(bmain), ID *id_dst, const ID *id_src,
   else {
     BKE_previewimg_id_copy(&action_dst->id, &action_src->id);
   }
+
+  /* Program is compiled from the copied F-Curves when the copy is evaluated. */
+  action_dst->runtime.eval_program = NULL;
 }
 
 /** Free (or release) any data used by this action (does not free the action itself). */
@@ -169,6 +172,8 @@ static void action_free_data(struct ID *id)
   BLI_freelistN(&action->markers);
 
   BKE_previewimg_free(&action->preview);
+
+  BKE_action_eval_program_free(action);
 }
 
 static void action_foreach_id(ID *id, LibraryForeachIDData *data)
@@ -230,6 +235,8 @@ static void action_blend_read_data(BlendDataReader *reader, ID *id)
 
   BLO_read_data_address(reader, &act->preview);
   BKE_previewimg_blend_read(reader, act->preview);
+
+  memset(&act->runtime, 0, sizeof(act->runtime));
 }
 
 static void blend_read_lib_constraint_channels(BlendLibReader *reader, ID *id, ListBase *chanbase)
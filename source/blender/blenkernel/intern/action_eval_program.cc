@@ -0,0 +1,416 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup bke
+ *
+ * Compiled evaluation of the F-Curves of an action.
+ *
+ * Key-frames of all F-Curves which can be compiled are stored in flat arrays which are shared by
+ * all the curves, and the curves are evaluated in a single loop over these arrays. F-Curves with
+ * modifiers, samples or interpolation modes other than constant, linear and Bezier are evaluated
+ * with #evaluate_fcurve.
+ */
+
+#include <cmath>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_easing.h"
+#include "BLI_listbase.h"
+#include "BLI_math_vector.h"
+#include "BLI_session_uuid.h"
+#include "BLI_utildefines.h"
+#include "BLI_vector.hh"
+
+#include "DNA_ID.h"
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_curve_types.h"
+#include "DNA_session_uuid_types.h"
+
+#include "BKE_action.h"
+#include "BKE_fcurve.h"
+
+#include "atomic_ops.h"
+
+using blender::Vector;
+
+enum class SegmentType : uint8_t {
+  CONSTANT,
+  LINEAR,
+  BEZIER,
+};
+
+enum eCompiledCurveFlag {
+  /* Round evaluated value to an integer, see #FCURVE_INT_VALUES. */
+  COMPILED_CURVE_INT_VALUES = (1 << 0),
+  /* Extrapolate using the slope before the first and after the last key-frame. */
+  COMPILED_CURVE_EXTRAPOLATE_FIRST = (1 << 1),
+  COMPILED_CURVE_EXTRAPOLATE_LAST = (1 << 2),
+};
+
+struct ActionEvalProgram {
+  /* Identifies the program among all programs compiled during the session, so that data derived
+   * from it can be validated even after the program was freed and another one allocated at the
+   * same address. */
+  SessionUUID session_uuid;
+
+  /* All non-empty F-Curves of the action. */
+  Vector<FCurve *> fcurves;
+  /* F-Curves which are evaluated with #evaluate_fcurve, as indices in #fcurves. */
+  Vector<int> uncompiled_fcurves;
+
+  /* Compiled curves, the index in #fcurves and the range of their key-frames. */
+  Vector<int> curve_fcurve;
+  Vector<int> curve_key_start;
+  Vector<int> curve_key_num;
+  Vector<int> curve_flag;
+  /* Slope of the extrapolation before the first and after the last key-frame. */
+  Vector<float> curve_slope_first;
+  Vector<float> curve_slope_last;
+
+  /* Key-frames of all compiled curves. */
+  Vector<float> key_time;
+  Vector<float> key_value;
+  /* Segment starting at the key-frame, and its corrected handles (x and y of the right handle of
+   * the key-frame, x and y of the left handle of the next key-frame) for Bezier segments. */
+  Vector<SegmentType> segment_type;
+  Vector<float> segment_handles;
+};
+
+/* -------------------------------------------------------------------- */
+/** \name Compilation
+ * \{ */
+
+static bool fcurve_can_compile(const FCurve *fcu)
+{
+  if (fcu->bezt == nullptr || fcu->totvert == 0 || fcu->driver != nullptr) {
+    return false;
+  }
+  if (!BLI_listbase_is_empty(&fcu->modifiers)) {
+    return false;
+  }
+  /* Only interpolation of segments matters, the last key-frame only defines extrapolation. */
+  const int keys_num = fcu->totvert;
+  for (int i = 0; i < keys_num - 1; i++) {
+    if (!ELEM(fcu->bezt[i].ipo, BEZT_IPO_CONST, BEZT_IPO_LIN, BEZT_IPO_BEZ)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Matches #fcurve_eval_keyframes_extrapolate, returns false for constant extrapolation. */
+static bool fcurve_extrapolation_slope(const FCurve *fcu,
+                                       const int endpoint_offset,
+                                       const int direction_to_neighbor,
+                                       float *r_slope)
+{
+  const BezTriple *endpoint_bezt = fcu->bezt + endpoint_offset;
+  const BezTriple *neighbor_bezt = endpoint_bezt + direction_to_neighbor;
+
+  if (endpoint_bezt->ipo == BEZT_IPO_CONST || fcu->extend == FCURVE_EXTRAPOLATE_CONSTANT ||
+      (fcu->flag & FCURVE_DISCRETE_VALUES) != 0) {
+    return false;
+  }
+
+  float fac;
+  if (endpoint_bezt->ipo == BEZT_IPO_LIN) {
+    if (fcu->totvert == 1) {
+      return false;
+    }
+    fac = neighbor_bezt->vec[1][0] - endpoint_bezt->vec[1][0];
+    if (fac == 0.0f) {
+      return false;
+    }
+    *r_slope = (neighbor_bezt->vec[1][1] - endpoint_bezt->vec[1][1]) / fac;
+    return true;
+  }
+
+  const int handle = direction_to_neighbor > 0 ? 0 : 2;
+  fac = endpoint_bezt->vec[1][0] - endpoint_bezt->vec[handle][0];
+  if (fac == 0.0f) {
+    return false;
+  }
+  *r_slope = (endpoint_bezt->vec[1][1] - endpoint_bezt->vec[handle][1]) / fac;
+  return true;
+}
+
+/* Matches the segment handling of #fcurve_eval_keyframes_interpolate. */
+static void fcurve_compile_segment(ActionEvalProgram &program,
+                                   const FCurve *fcu,
+                                   const BezTriple *prevbezt,
+                                   const BezTriple *bezt)
+{
+  const float duration = bezt->vec[1][0] - prevbezt->vec[1][0];
+  if ((prevbezt->ipo == BEZT_IPO_CONST) || (fcu->flag & FCURVE_DISCRETE_VALUES) ||
+      (duration == 0)) {
+    program.segment_type.append(SegmentType::CONSTANT);
+    program.segment_handles.append_n_times(0.0f, 4);
+    return;
+  }
+  if (prevbezt->ipo == BEZT_IPO_LIN) {
+    program.segment_type.append(SegmentType::LINEAR);
+    program.segment_handles.append_n_times(0.0f, 4);
+    return;
+  }
+
+  float v1[2], v2[2], v3[2], v4[2];
+  copy_v2_v2(v1, prevbezt->vec[1]);
+  copy_v2_v2(v2, prevbezt->vec[2]);
+  copy_v2_v2(v3, bezt->vec[0]);
+  copy_v2_v2(v4, bezt->vec[1]);
+
+  if (fabsf(v1[1] - v4[1]) < FLT_EPSILON && fabsf(v2[1] - v3[1]) < FLT_EPSILON &&
+      fabsf(v3[1] - v4[1]) < FLT_EPSILON) {
+    /* All handles are flat, the value is simply the shared value. */
+    program.segment_type.append(SegmentType::CONSTANT);
+    program.segment_handles.append_n_times(0.0f, 4);
+    return;
+  }
+  BKE_fcurve_correct_bezpart(v1, v2, v3, v4);
+
+  program.segment_type.append(SegmentType::BEZIER);
+  program.segment_handles.extend({v2[0], v2[1], v3[0], v3[1]});
+}
+
+static void fcurve_compile(ActionEvalProgram &program, const FCurve *fcu, const int fcurve_index)
+{
+  int flag = 0;
+  float slope_first = 0.0f, slope_last = 0.0f;
+  if (fcu->flag & FCURVE_INT_VALUES) {
+    flag |= COMPILED_CURVE_INT_VALUES;
+  }
+  if (fcurve_extrapolation_slope(fcu, 0, 1, &slope_first)) {
+    flag |= COMPILED_CURVE_EXTRAPOLATE_FIRST;
+  }
+  if (fcurve_extrapolation_slope(fcu, fcu->totvert - 1, -1, &slope_last)) {
+    flag |= COMPILED_CURVE_EXTRAPOLATE_LAST;
+  }
+
+  program.curve_fcurve.append(fcurve_index);
+  program.curve_key_start.append(program.key_time.size());
+  program.curve_key_num.append(fcu->totvert);
+  program.curve_flag.append(flag);
+  program.curve_slope_first.append(slope_first);
+  program.curve_slope_last.append(slope_last);
+
+  const int keys_num = fcu->totvert;
+  for (int i = 0; i < keys_num; i++) {
+    const BezTriple *bezt = fcu->bezt + i;
+    program.key_time.append(bezt->vec[1][0]);
+    program.key_value.append(bezt->vec[1][1]);
+    if (i + 1 < keys_num) {
+      fcurve_compile_segment(program, fcu, bezt, bezt + 1);
+    }
+    else {
+      program.segment_type.append(SegmentType::CONSTANT);
+      program.segment_handles.append_n_times(0.0f, 4);
+    }
+  }
+}
+
+static ActionEvalProgram *action_eval_program_compile(bAction *act)
+{
+  ActionEvalProgram *program = MEM_new<ActionEvalProgram>(__func__);
+  program->session_uuid = BLI_session_uuid_generate();
+  LISTBASE_FOREACH (FCurve *, fcu, &act->curves) {
+    if (BKE_fcurve_is_empty(fcu)) {
+      continue;
+    }
+    const int fcurve_index = program->fcurves.append_and_get_index(fcu);
+    if (fcurve_can_compile(fcu)) {
+      fcurve_compile(*program, fcu, fcurve_index);
+    }
+    else {
+      program->uncompiled_fcurves.append(fcurve_index);
+    }
+  }
+  return program;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Evaluation
+ * \{ */
+
+/* Matches #BKE_fcurve_bezt_binarysearch_index_ex with the threshold used for evaluation. */
+static int keyframe_binarysearch_index(const float *times,
+                                       const float frame,
+                                       const int len,
+                                       bool *r_exact)
+{
+  const float threshold = 0.0001f;
+  *r_exact = false;
+
+  if (IS_EQT(frame, times[0], threshold)) {
+    *r_exact = true;
+    return 0;
+  }
+  if (frame < times[0]) {
+    return 0;
+  }
+  if (IS_EQT(frame, times[len - 1], threshold)) {
+    *r_exact = true;
+    return len - 1;
+  }
+  if (frame > times[len - 1]) {
+    return len;
+  }
+
+  int start = 0, end = len;
+  for (int loopbreaker = 0; (start <= end) && (loopbreaker < len * 2); loopbreaker++) {
+    const int mid = start + ((end - start) / 2);
+    const float midfra = times[mid];
+    if (IS_EQT(frame, midfra, threshold)) {
+      *r_exact = true;
+      return mid;
+    }
+    if (frame > midfra) {
+      start = mid + 1;
+    }
+    else if (frame < midfra) {
+      end = mid - 1;
+    }
+  }
+  return start;
+}
+
+/* Matches #fcurve_eval_keyframes. */
+static float compiled_curve_evaluate(const ActionEvalProgram &program,
+                                     const int curve,
+                                     const float evaltime)
+{
+  const int key_start = program.curve_key_start[curve];
+  const int key_num = program.curve_key_num[curve];
+  const int flag = program.curve_flag[curve];
+  const float *times = program.key_time.data() + key_start;
+  const float *values = program.key_value.data() + key_start;
+
+  if (evaltime <= times[0]) {
+    if (flag & COMPILED_CURVE_EXTRAPOLATE_FIRST) {
+      return values[0] - (program.curve_slope_first[curve] * (times[0] - evaltime));
+    }
+    return values[0];
+  }
+  if (times[key_num - 1] <= evaltime) {
+    if (flag & COMPILED_CURVE_EXTRAPOLATE_LAST) {
+      return values[key_num - 1] -
+             (program.curve_slope_last[curve] * (times[key_num - 1] - evaltime));
+    }
+    return values[key_num - 1];
+  }
+
+  bool exact;
+  const int a = keyframe_binarysearch_index(times, evaltime, key_num, &exact);
+  if (exact) {
+    return values[a];
+  }
+  const int prev = (a > 0) ? (a - 1) : a;
+  if (fabsf(times[a] - evaltime) < 1.e-8f) {
+    return values[a];
+  }
+  if (evaltime < times[prev] || times[a] < evaltime) {
+    return 0.0f;
+  }
+
+  const int segment = key_start + prev;
+  switch (program.segment_type[segment]) {
+    case SegmentType::CONSTANT:
+      return values[prev];
+    case SegmentType::LINEAR:
+      return BLI_easing_linear_ease(
+          evaltime - times[prev], values[prev], values[a] - values[prev], times[a] - times[prev]);
+    case SegmentType::BEZIER: {
+      const float *handles = program.segment_handles.data() + segment * 4;
+      const float v1[2] = {times[prev], values[prev]};
+      const float v4[2] = {times[a], values[a]};
+      float value;
+      if (!BKE_fcurve_bezpart_evaluate(v1, handles, handles + 2, v4, evaltime, &value)) {
+        return 0.0f;
+      }
+      return value;
+    }
+  }
+  return 0.0f;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Public API
+ * \{ */
+
+const ActionEvalProgram *BKE_action_eval_program_ensure(bAction *act)
+{
+  BLI_assert(act->id.tag & LIB_TAG_COPIED_ON_WRITE);
+  /* Same action can be evaluated for multiple IDs from different threads. */
+  if (act->runtime.eval_program != nullptr) {
+    return act->runtime.eval_program;
+  }
+  ActionEvalProgram *program = action_eval_program_compile(act);
+  ActionEvalProgram *existing_program = static_cast<ActionEvalProgram *>(
+      atomic_cas_ptr((void **)&act->runtime.eval_program, nullptr, program));
+  if (existing_program != nullptr) {
+    MEM_delete(program);
+    return existing_program;
+  }
+  return program;
+}
+
+void BKE_action_eval_program_free(bAction *act)
+{
+  MEM_delete(act->runtime.eval_program);
+  act->runtime.eval_program = nullptr;
+}
+
+const SessionUUID *BKE_action_eval_program_session_uuid(const ActionEvalProgram *program)
+{
+  return &program->session_uuid;
+}
+
+int BKE_action_eval_program_fcurves_num(const ActionEvalProgram *program)
+{
+  return program->fcurves.size();
+}
+
+FCurve **BKE_action_eval_program_fcurves(const ActionEvalProgram *program)
+{
+  return const_cast<FCurve **>(program->fcurves.data());
+}
+
+void BKE_action_eval_program_evaluate(const ActionEvalProgram *program,
+                                      const float evaltime,
+                                      float *r_values)
+{
+  for (const int curve : program->curve_fcurve.index_range()) {
+    float value = compiled_curve_evaluate(*program, curve, evaltime);
+    if (program->curve_flag[curve] & COMPILED_CURVE_INT_VALUES) {
+      value = floorf(value + 0.5f);
+    }
+    r_values[program->curve_fcurve[curve]] = value;
+  }
+  for (const int fcurve_index : program->uncompiled_fcurves) {
+    r_values[fcurve_index] = evaluate_fcurve(program->fcurves[fcurve_index], evaltime);
+  }
+}
+
+/** \} */
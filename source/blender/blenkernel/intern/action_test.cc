@@ -18,11 +18,14 @@
  */
 
 #include "BKE_action.h"
+#include "BKE_fcurve.h"
 
 #include "DNA_action_types.h"
 #include "DNA_anim_types.h"
 
 #include "BLI_listbase.h"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "MEM_guardedalloc.h"
 
@@ -236,4 +239,115 @@ TEST(action_assets, BKE_action_has_single_frame)
   }
 }
 
+TEST(action_eval_program, MatchesFCurveEvaluation)
+{
+  FCurve fcu_const = {nullptr};
+  FCurve fcu_linear = {nullptr};
+  FCurve fcu_bezier = {nullptr};
+  FCurve fcu_int = {nullptr};
+  std::unique_ptr<BezTriple[]> bezt_const = allocate_keyframes(&fcu_const, 3);
+  std::unique_ptr<BezTriple[]> bezt_linear = allocate_keyframes(&fcu_linear, 3);
+  std::unique_ptr<BezTriple[]> bezt_bezier = allocate_keyframes(&fcu_bezier, 3);
+  std::unique_ptr<BezTriple[]> bezt_int = allocate_keyframes(&fcu_int, 2);
+  for (FCurve *fcu : {&fcu_const, &fcu_linear, &fcu_bezier}) {
+    add_keyframe(fcu, 1.0f, 2.0f);
+    add_keyframe(fcu, 4.0f, -3.0f);
+    add_keyframe(fcu, 5.0f, 7.0f);
+  }
+  add_keyframe(&fcu_int, 1.0f, 0.0f);
+  add_keyframe(&fcu_int, 10.0f, 5.0f);
+
+  for (int i = 0; i < 3; i++) {
+    fcu_const.bezt[i].ipo = BEZT_IPO_CONST;
+    fcu_linear.bezt[i].ipo = BEZT_IPO_LIN;
+    fcu_bezier.bezt[i].ipo = BEZT_IPO_BEZ;
+  }
+  fcu_linear.extend = FCURVE_EXTRAPOLATE_LINEAR;
+  /* Make the handles long enough to require correction. */
+  fcu_bezier.bezt[0].vec[2][0] = 6.0f;
+  fcu_bezier.bezt[0].vec[2][1] = 9.0f;
+  fcu_bezier.bezt[1].vec[0][1] = -4.0f;
+  fcu_bezier.extend = FCURVE_EXTRAPOLATE_LINEAR;
+  fcu_int.bezt[0].ipo = BEZT_IPO_LIN;
+  fcu_int.flag = FCURVE_INT_VALUES;
+
+  bAction action = {{nullptr}};
+  action.id.tag = LIB_TAG_COPIED_ON_WRITE;
+  BLI_addtail(&action.curves, &fcu_const);
+  BLI_addtail(&action.curves, &fcu_linear);
+  BLI_addtail(&action.curves, &fcu_bezier);
+  BLI_addtail(&action.curves, &fcu_int);
+
+  const ActionEvalProgram *program = BKE_action_eval_program_ensure(&action);
+  EXPECT_EQ(BKE_action_eval_program_ensure(&action), program);
+  ASSERT_EQ(BKE_action_eval_program_fcurves_num(program), 4);
+  FCurve **fcurves = BKE_action_eval_program_fcurves(program);
+
+  for (float frame = -2.0f; frame < 12.0f; frame += 0.125f) {
+    float values[4];
+    BKE_action_eval_program_evaluate(program, frame, values);
+    for (int i = 0; i < 4; i++) {
+      EXPECT_EQ(values[i], evaluate_fcurve(fcurves[i], frame)) << "frame " << frame;
+    }
+  }
+
+  BKE_action_eval_program_free(&action);
+  EXPECT_EQ(action.runtime.eval_program, nullptr);
+}
+
+/**
+ * Set this to 1 to activate the benchmark. It is disabled by default, because it prints a lot.
+ * Compares the evaluation of the F-Curves of an action one by one with #evaluate_fcurve (which is
+ * what happens for original actions) against the evaluation of its compiled program.
+ */
+#if 0
+TEST(action_eval_program, Benchmark)
+{
+  const int fcurves_num = 1000;
+  const int keys_num = 100;
+  const int frames_num = 1000;
+
+  bAction action = {{nullptr}};
+  action.id.tag = LIB_TAG_COPIED_ON_WRITE;
+  Vector<std::unique_ptr<FCurve>> fcurves;
+  Vector<std::unique_ptr<BezTriple[]>> bezts;
+  for (int i = 0; i < fcurves_num; i++) {
+    fcurves.append(std::make_unique<FCurve>());
+    FCurve *fcu = fcurves.last().get();
+    bezts.append(allocate_keyframes(fcu, keys_num));
+    for (int key = 0; key < keys_num; key++) {
+      add_keyframe(fcu, key * 10.0f, float((key * 7 + i) % 13));
+      fcu->bezt[key].ipo = (key % 4 == 0) ? BEZT_IPO_LIN : BEZT_IPO_BEZ;
+    }
+    BLI_addtail(&action.curves, fcu);
+  }
+
+  float values[fcurves_num];
+  for (int i = 0; i < 3; i++) {
+    float sum = 0.0f;
+    {
+      SCOPED_TIMER("evaluate_fcurve     ");
+      for (int frame = 0; frame < frames_num; frame++) {
+        LISTBASE_FOREACH (FCurve *, fcu, &action.curves) {
+          sum += evaluate_fcurve(fcu, float(frame));
+        }
+      }
+    }
+    {
+      SCOPED_TIMER("action eval program");
+      const ActionEvalProgram *program = BKE_action_eval_program_ensure(&action);
+      for (int frame = 0; frame < frames_num; frame++) {
+        BKE_action_eval_program_evaluate(program, float(frame), values);
+        for (const float value : values) {
+          sum -= value;
+        }
+      }
+    }
+    BKE_action_eval_program_free(&action);
+    /* Print the value for simple error checking and to avoid some compiler optimizations. */
+    std::cout << "Difference: " << sum << "\n";
+  }
+}
+#endif
+
 }  // namespace blender::bke::tests
@@ -35,6 +35,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_session_uuid.h"
 #include "BLI_string_utils.h"
 #include "BLI_utildefines.h"
 
@@ -612,6 +613,171 @@ static void animsys_evaluate_fcurves(PointerRNA *ptr,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Resolved RNA Paths Cache
+ *
+ * RNA paths of the F-Curves of the active action of an evaluated ID are resolved once and kept in
+ * the animation data of the ID. The cache is freed together with the animation data on every
+ * copy-on-write update of the ID, and when the relations of the ID are updated.
+ * \{ */
+
+typedef enum eAnimEvalRNAState {
+  /* The path does not resolve to an animatable property. */
+  ANIM_EVAL_RNA_INVALID = 0,
+  /* The path is resolved to a property of the evaluated ID itself. */
+  ANIM_EVAL_RNA_RESOLVED,
+  /* The path leads to another ID, whose data is not covered by the invalidation of the cache, so
+   * it is resolved on every evaluation. */
+  ANIM_EVAL_RNA_UNCACHED,
+} eAnimEvalRNAState;
+
+typedef struct AnimEvalRNACache {
+  /* Action and its evaluation program the paths were resolved for. */
+  const bAction *action;
+  SessionUUID program_session_uuid;
+
+  /* Resolved paths and their #eAnimEvalRNAState, in the order of the F-Curves of the program. */
+  int fcurves_num;
+  PathResolvedRNA *anim_rna;
+  char *state;
+
+  /* Values of the F-Curves, kept to not allocate them on every evaluation. */
+  float *values;
+} AnimEvalRNACache;
+
+void BKE_animsys_eval_rna_cache_free(AnimData *adt)
+{
+  AnimEvalRNACache *cache = adt->eval_rna_cache;
+  if (cache == NULL) {
+    return;
+  }
+  MEM_SAFE_FREE(cache->anim_rna);
+  MEM_SAFE_FREE(cache->state);
+  MEM_SAFE_FREE(cache->values);
+  MEM_freeN(cache);
+  adt->eval_rna_cache = NULL;
+}
+
+void BKE_animsys_eval_rna_cache_invalidate(ID *id)
+{
+  AnimData *adt = BKE_animdata_from_id(id);
+  if (adt != NULL) {
+    BKE_animsys_eval_rna_cache_free(adt);
+  }
+}
+
+/**
+ * Get the cache of resolved paths for evaluating the action of `ptr` with the given program,
+ * resolving the paths if needed. Returns NULL if the paths can not be cached, which is the case
+ * for everything but the active action of an evaluated ID.
+ */
+static AnimEvalRNACache *animsys_eval_rna_cache_ensure(PointerRNA *ptr,
+                                                       bAction *act,
+                                                       const struct ActionEvalProgram *program)
+{
+  ID *id = ptr->owner_id;
+  if (id == NULL || ptr->data != id || (id->tag & LIB_TAG_COPIED_ON_WRITE) == 0) {
+    return NULL;
+  }
+  /* Temporary animation data (Action constraint for example) is never freed with the ID, and
+   * other actions might be evaluated for the ID from outside of the dependency graph. */
+  AnimData *adt = BKE_animdata_from_id(id);
+  if (adt == NULL || adt->action != act) {
+    return NULL;
+  }
+
+  const SessionUUID *program_session_uuid = BKE_action_eval_program_session_uuid(program);
+  AnimEvalRNACache *cache = adt->eval_rna_cache;
+  if (cache != NULL) {
+    if (cache->action == act &&
+        BLI_session_uuid_is_equal(&cache->program_session_uuid, program_session_uuid)) {
+      return cache;
+    }
+    BKE_animsys_eval_rna_cache_free(adt);
+  }
+
+  const int fcurves_num = BKE_action_eval_program_fcurves_num(program);
+  FCurve **fcurves = BKE_action_eval_program_fcurves(program);
+
+  cache = MEM_callocN(sizeof(*cache), __func__);
+  cache->action = act;
+  cache->program_session_uuid = *program_session_uuid;
+  cache->fcurves_num = fcurves_num;
+  cache->anim_rna = MEM_malloc_arrayN(fcurves_num, sizeof(*cache->anim_rna), __func__);
+  cache->state = MEM_malloc_arrayN(fcurves_num, sizeof(*cache->state), __func__);
+  cache->values = MEM_malloc_arrayN(fcurves_num, sizeof(*cache->values), __func__);
+
+  for (int i = 0; i < fcurves_num; i++) {
+    FCurve *fcu = fcurves[i];
+    PathResolvedRNA *anim_rna = &cache->anim_rna[i];
+    if (!BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, anim_rna)) {
+      cache->state[i] = ANIM_EVAL_RNA_INVALID;
+    }
+    else if (anim_rna->ptr.owner_id != id) {
+      cache->state[i] = ANIM_EVAL_RNA_UNCACHED;
+    }
+    else {
+      cache->state[i] = ANIM_EVAL_RNA_RESOLVED;
+    }
+  }
+
+  adt->eval_rna_cache = cache;
+  return cache;
+}
+
+/** \} */
+
+/**
+ * Evaluate all the F-Curves of the evaluated action using its compiled evaluation program.
+ * Gives the same result as #animsys_evaluate_fcurves for the F-Curves of the action.
+ */
+static void animsys_evaluate_action_program(PointerRNA *ptr,
+                                            bAction *act,
+                                            const AnimationEvalContext *anim_eval_context,
+                                            bool flush_to_original)
+{
+  const struct ActionEvalProgram *program = BKE_action_eval_program_ensure(act);
+  const int fcurves_num = BKE_action_eval_program_fcurves_num(program);
+  if (fcurves_num == 0) {
+    return;
+  }
+  FCurve **fcurves = BKE_action_eval_program_fcurves(program);
+
+  AnimEvalRNACache *cache = animsys_eval_rna_cache_ensure(ptr, act, program);
+  float *values = (cache != NULL) ? cache->values :
+                                    MEM_malloc_arrayN(fcurves_num, sizeof(float), __func__);
+  BKE_action_eval_program_evaluate(program, anim_eval_context->eval_time, values);
+
+  for (int i = 0; i < fcurves_num; i++) {
+    FCurve *fcu = fcurves[i];
+    /* Muting does not affect the program, so it is checked here. */
+    if (!is_fcurve_evaluatable(fcu)) {
+      continue;
+    }
+
+    PathResolvedRNA anim_rna_local;
+    PathResolvedRNA *anim_rna = &anim_rna_local;
+    if (cache != NULL && cache->state[i] == ANIM_EVAL_RNA_RESOLVED) {
+      anim_rna = &cache->anim_rna[i];
+    }
+    else if ((cache != NULL && cache->state[i] == ANIM_EVAL_RNA_INVALID) ||
+             !BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, anim_rna)) {
+      continue;
+    }
+
+    const float curval = values[i];
+    fcu->curval = curval; /* Debug display only, not thread safe! */
+    BKE_animsys_write_to_rna_path(anim_rna, curval);
+    if (flush_to_original) {
+      animsys_write_orig_anim_rna(ptr, fcu->rna_path, fcu->array_index, curval);
+    }
+  }
+
+  if (cache == NULL) {
+    MEM_freeN(values);
+  }
+}
+
 /* This function assumes that the quaternion is fully keyed, and is stored in array index order. */
 static void animsys_quaternion_evaluate_fcurves(PathResolvedRNA quat_rna,
                                                 FCurve *first_fcurve,
@@ -863,6 +1029,13 @@ void animsys_evaluate_action(PointerRNA *ptr,
 
   action_idcode_patch_check(ptr->owner_id, act);
 
+  /* Evaluated actions are copied again when their F-Curves change, so they can use the
+   * compiled evaluation program. */
+  if (act->id.tag & LIB_TAG_COPIED_ON_WRITE) {
+    animsys_evaluate_action_program(ptr, act, anim_eval_context, flush_to_original);
+    return;
+  }
+
   /* calculate then execute each curve */
   animsys_evaluate_fcurves(ptr, &act->curves, anim_eval_context, flush_to_original);
 }
@@ -2566,6 +2566,9 @@ void BKE_pose_rebuild(Main *bmain, Object *ob, bArmature *arm, const bool do_id_
   BKE_pose_channels_hash_ensure(pose);
 
   for (pchan = pose->chanbase.first; pchan; pchan = pchan->next) {
+    /* Parent or bone of the channel might have changed, so the pose matrix can not be kept from
+     * the previous evaluation. */
+    pchan->runtime.flag &= ~POSE_RUNTIME_EVAL_CHAN_MAT_VALID;
     /* Find the custom B-Bone handles. */
     BKE_pchan_rebuild_bbone_handles(pose, pchan);
     /* Re-validate that we are still using a valid pchan form custom transform. */
@@ -56,6 +56,8 @@
 
 #include "CLG_log.h"
 
+#include "atomic_ops.h"
+
 static CLG_LogRef LOG = {"bke.armature_deform"};
 
 /* -------------------------------------------------------------------- */
@@ -231,6 +233,102 @@ static void pchan_bone_deform(bPoseChannel *pchan,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Armature Deform Vertex Group Weights
+ *
+ * Vertex group weights of a mesh gathered into flat arrays, so that the influences of a
+ * vertex are read from contiguous memory instead of from the separately allocated
+ * #MDeformWeight arrays. The weights are cached in the runtime data of copy-on-write meshes and
+ * are gathered again only when the geometry of the mesh is updated.
+ * \{ */
+
+typedef struct ArmatureDeformWeights {
+  /** The array the weights were gathered from, used to detect weights which went out of date. */
+  const MDeformVert *dverts;
+  int verts_num;
+
+  /** Influences of the vertex `i` are stored in the `[offsets[i], offsets[i + 1])` range. */
+  int *offsets;
+  int *def_nrs;
+  float *weights;
+} ArmatureDeformWeights;
+
+static ArmatureDeformWeights *armature_deform_weights_create(const MDeformVert *dverts,
+                                                             const int verts_num)
+{
+  ArmatureDeformWeights *deform_weights = MEM_callocN(sizeof(*deform_weights), __func__);
+  deform_weights->dverts = dverts;
+  deform_weights->verts_num = verts_num;
+  deform_weights->offsets = MEM_malloc_arrayN(verts_num + 1, sizeof(int), __func__);
+
+  int weights_num = 0;
+  for (int i = 0; i < verts_num; i++) {
+    deform_weights->offsets[i] = weights_num;
+    weights_num += dverts[i].totweight;
+  }
+  deform_weights->offsets[verts_num] = weights_num;
+
+  deform_weights->def_nrs = MEM_malloc_arrayN(max_ii(weights_num, 1), sizeof(int), __func__);
+  deform_weights->weights = MEM_malloc_arrayN(max_ii(weights_num, 1), sizeof(float), __func__);
+
+  int index = 0;
+  for (int i = 0; i < verts_num; i++) {
+    for (int j = 0; j < dverts[i].totweight; j++) {
+      const MDeformWeight *dw = &dverts[i].dw[j];
+      deform_weights->def_nrs[index] = dw->def_nr;
+      deform_weights->weights[index] = dw->weight;
+      index++;
+    }
+  }
+
+  return deform_weights;
+}
+
+static void armature_deform_weights_free(ArmatureDeformWeights *deform_weights)
+{
+  MEM_freeN(deform_weights->offsets);
+  MEM_freeN(deform_weights->def_nrs);
+  MEM_freeN(deform_weights->weights);
+  MEM_freeN(deform_weights);
+}
+
+/**
+ * Get the cached weights of the mesh, gathering them when needed. Returns NULL when the cached
+ * weights do not match the vertex groups of the mesh anymore.
+ *
+ * \note Multiple objects can share the mesh and be deformed from different threads, so the
+ * weights are installed atomically rather than under a lock.
+ */
+static const ArmatureDeformWeights *armature_deform_weights_ensure(Mesh *mesh)
+{
+  ArmatureDeformWeights *deform_weights = mesh->runtime.deform_weights;
+  if (deform_weights == NULL) {
+    deform_weights = armature_deform_weights_create(mesh->dvert, mesh->totvert);
+    ArmatureDeformWeights *existing = atomic_cas_ptr(
+        (void **)&mesh->runtime.deform_weights, NULL, deform_weights);
+    if (existing != NULL) {
+      /* Another thread was faster. */
+      armature_deform_weights_free(deform_weights);
+      deform_weights = existing;
+    }
+  }
+
+  if (deform_weights->dverts != mesh->dvert || deform_weights->verts_num != mesh->totvert) {
+    return NULL;
+  }
+  return deform_weights;
+}
+
+void BKE_armature_deform_weights_discard(Mesh *mesh)
+{
+  if (mesh->runtime.deform_weights != NULL) {
+    armature_deform_weights_free(mesh->runtime.deform_weights);
+    mesh->runtime.deform_weights = NULL;
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform #BKE_armature_deform_coords API
  *
@@ -258,6 +356,13 @@ typedef struct ArmatureUserdata {
   bPoseChannel **pchan_from_defbase;
   int defbase_len;
 
+  /** Cached weights of `dverts`, NULL when the vertex groups are read from `dverts`. */
+  const ArmatureDeformWeights *deform_weights;
+  /** Deform matrices of #pchan_from_defbase, copied into one array for the cached weights. */
+  float (*defbase_mats)[4][4];
+  /** Whether the bone of a vertex group needs the generic deform, see #armature_vert_task. */
+  bool *defbase_use_generic;
+
   float premat[4][4];
   float postmat[4][4];
 
@@ -267,6 +372,76 @@ typedef struct ArmatureUserdata {
   } bmesh;
 } ArmatureUserdata;
 
+/**
+ * Apply the accumulated influences of the bones to the vertex: `co` is the coordinate in the
+ * armature space, `vec` and `dq` are the accumulated offset and dual quaternion, `summat` is the
+ * accumulated deform matrix (NULL when deform matrices are not requested).
+ */
+static void armature_vert_apply(const ArmatureUserdata *data,
+                                const int i,
+                                float co[3],
+                                const float contrib,
+                                const float armature_weight,
+                                const float prevco_weight,
+                                float vec[3],
+                                DualQuat *dq,
+                                float summat[3][3])
+{
+  float(*const vert_coords)[3] = data->vert_coords;
+  float(*const vert_deform_mats)[3][3] = data->vert_deform_mats;
+  float(*const vert_coords_prev)[3] = data->vert_coords_prev;
+  const bool use_quaternion = data->use_quaternion;
+
+  /* actually should be EPSILON? weight values and contrib can be like 10e-39 small */
+  if (contrib > 0.0001f) {
+    float dco[3];
+
+    if (use_quaternion) {
+      normalize_dq(dq, contrib);
+
+      if (armature_weight != 1.0f) {
+        copy_v3_v3(dco, co);
+        mul_v3m3_dq(dco, summat, dq);
+        sub_v3_v3(dco, co);
+        mul_v3_fl(dco, armature_weight);
+        add_v3_v3(co, dco);
+      }
+      else {
+        mul_v3m3_dq(co, summat, dq);
+      }
+    }
+    else {
+      mul_v3_fl(vec, armature_weight / contrib);
+      add_v3_v3v3(co, vec, co);
+    }
+
+    if (vert_deform_mats) {
+      float pre[3][3], post[3][3], tmpmat[3][3];
+
+      copy_m3_m4(pre, data->premat);
+      copy_m3_m4(post, data->postmat);
+      copy_m3_m3(tmpmat, vert_deform_mats[i]);
+
+      if (!use_quaternion) { /* quaternion already is scale corrected */
+        mul_m3_fl(summat, armature_weight / contrib);
+      }
+
+      mul_m3_series(vert_deform_mats[i], post, summat, pre, tmpmat);
+    }
+  }
+
+  /* always, check above code */
+  mul_m4_v3(data->postmat, co);
+
+  /* interpolate with previous modifier position using weight group */
+  if (vert_coords_prev) {
+    float mw = 1.0f - prevco_weight;
+    vert_coords[i][0] = prevco_weight * vert_coords[i][0] + mw * co[0];
+    vert_coords[i][1] = prevco_weight * vert_coords[i][1] + mw * co[1];
+    vert_coords[i][2] = prevco_weight * vert_coords[i][2] + mw * co[2];
+  }
+}
+
 static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
                                           const int i,
                                           const MDeformVert *dvert)
@@ -281,7 +456,7 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
 
   DualQuat sumdq, *dq = NULL;
   bPoseChannel *pchan;
-  float *co, dco[3];
+  float *co;
   float sumvec[3], summat[3][3];
   float *vec = NULL, (*smat)[3] = NULL;
   float contrib = 0.0f;
@@ -364,54 +539,15 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
     }
   }
 
-  /* actually should be EPSILON? weight values and contrib can be like 10e-39 small */
-  if (contrib > 0.0001f) {
-    if (use_quaternion) {
-      normalize_dq(dq, contrib);
-
-      if (armature_weight != 1.0f) {
-        copy_v3_v3(dco, co);
-        mul_v3m3_dq(dco, (vert_deform_mats) ? summat : NULL, dq);
-        sub_v3_v3(dco, co);
-        mul_v3_fl(dco, armature_weight);
-        add_v3_v3(co, dco);
-      }
-      else {
-        mul_v3m3_dq(co, (vert_deform_mats) ? summat : NULL, dq);
-      }
-
-      smat = summat;
-    }
-    else {
-      mul_v3_fl(vec, armature_weight / contrib);
-      add_v3_v3v3(co, vec, co);
-    }
-
-    if (vert_deform_mats) {
-      float pre[3][3], post[3][3], tmpmat[3][3];
-
-      copy_m3_m4(pre, data->premat);
-      copy_m3_m4(post, data->postmat);
-      copy_m3_m3(tmpmat, vert_deform_mats[i]);
-
-      if (!use_quaternion) { /* quaternion already is scale corrected */
-        mul_m3_fl(smat, armature_weight / contrib);
-      }
-
-      mul_m3_series(vert_deform_mats[i], post, smat, pre, tmpmat);
-    }
-  }
-
-  /* always, check above code */
-  mul_m4_v3(data->postmat, co);
-
-  /* interpolate with previous modifier position using weight group */
-  if (vert_coords_prev) {
-    float mw = 1.0f - prevco_weight;
-    vert_coords[i][0] = prevco_weight * vert_coords[i][0] + mw * co[0];
-    vert_coords[i][1] = prevco_weight * vert_coords[i][1] + mw * co[1];
-    vert_coords[i][2] = prevco_weight * vert_coords[i][2] + mw * co[2];
-  }
+  armature_vert_apply(data,
+                      i,
+                      co,
+                      contrib,
+                      armature_weight,
+                      prevco_weight,
+                      vec,
+                      dq,
+                      (vert_deform_mats) ? summat : NULL);
 }
 
 static void armature_vert_task(void *__restrict userdata,
@@ -444,6 +580,118 @@ static void armature_vert_task(void *__restrict userdata,
   armature_vert_task_with_dvert(data, i, dvert);
 }
 
+/**
+ * Deform a vertex using the cached vertex group weights. Bones with a plain deform matrix are
+ * blended into a single matrix (or dual quaternion) which is applied to the vertex once. Vertices
+ * influenced by B-Bones or by bones which multiply weights with the envelope, and vertices which
+ * fall back to the envelope deform, are deformed by #armature_vert_task_with_dvert.
+ */
+static void armature_vert_task_with_weights(void *__restrict userdata,
+                                            const int i,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ArmatureUserdata *data = userdata;
+  const ArmatureDeformWeights *deform_weights = data->deform_weights;
+  float(*const vert_deform_mats)[3][3] = data->vert_deform_mats;
+  const bool use_quaternion = data->use_quaternion;
+
+  if (i >= deform_weights->verts_num) {
+    armature_vert_task_with_dvert(data, i, NULL);
+    return;
+  }
+
+  const MDeformVert *dvert = &data->dverts[i];
+  float armature_weight = 1.0f;
+
+  if (data->armature_def_nr != -1) {
+    armature_weight = BKE_defvert_find_weight(dvert, data->armature_def_nr);
+
+    if (data->invert_vgroup) {
+      armature_weight = 1.0f - armature_weight;
+    }
+  }
+
+  if (armature_weight == 0.0f) {
+    return;
+  }
+
+  float co[3];
+  mul_v3_m4v3(co, data->premat, data->vert_coords[i]);
+
+  float summat4[4][4];
+  DualQuat sumdq;
+  float contrib = 0.0f;
+  bool deformed = false;
+
+  if (use_quaternion) {
+    memset(&sumdq, 0, sizeof(DualQuat));
+  }
+  else {
+    zero_m4(summat4);
+  }
+
+  const int weights_end = deform_weights->offsets[i + 1];
+  for (int j = deform_weights->offsets[i]; j < weights_end; j++) {
+    const uint index = (uint)deform_weights->def_nrs[j];
+    if (index >= data->defbase_len || data->pchan_from_defbase[index] == NULL) {
+      continue;
+    }
+    if (data->defbase_use_generic[index]) {
+      armature_vert_task_with_dvert(data, i, dvert);
+      return;
+    }
+
+    /* Zero weights of deforming bones still disable the envelope fallback. */
+    deformed = true;
+    const float weight = deform_weights->weights[j];
+    if (weight == 0.0f) {
+      continue;
+    }
+    if (use_quaternion) {
+      add_weighted_dq_dq(
+          &sumdq, &data->pchan_from_defbase[index]->runtime.deform_dual_quat, weight);
+    }
+    else {
+      /* Contiguous loop over all matrix elements, so that it is vectorized by the compiler. */
+      const float *mat = &data->defbase_mats[index][0][0];
+      float *summat_flat = &summat4[0][0];
+      for (int k = 0; k < 16; k++) {
+        summat_flat[k] += mat[k] * weight;
+      }
+    }
+    contrib += weight;
+  }
+
+  if (!deformed && data->use_envelope) {
+    armature_vert_task_with_dvert(data, i, dvert);
+    return;
+  }
+
+  /* The sum of `weight * (mat * co - co)` over the bones, as accumulated by
+   * #pchan_deform_accumulate, computed with the blended matrix. */
+  float sumvec[3], summat[3][3];
+  if (!use_quaternion) {
+    mul_v3_m4v3(sumvec, summat4, co);
+    madd_v3_v3fl(sumvec, co, -contrib);
+
+    if (vert_deform_mats) {
+      copy_m3_m4(summat, summat4);
+    }
+  }
+
+  float *co_dst = data->vert_coords[i];
+  copy_v3_v3(co_dst, co);
+  armature_vert_apply(data,
+                      i,
+                      co_dst,
+                      contrib,
+                      armature_weight,
+                      1.0f,
+                      sumvec,
+                      &sumdq,
+                      (vert_deform_mats) ? summat : NULL);
+}
+
 static void armature_vert_task_editmesh(void *__restrict userdata,
                                         MempoolIterData *iter,
                                         const TaskParallelTLS *__restrict UNUSED(tls))
@@ -563,6 +811,36 @@ static void armature_deform_coords_impl(const Object *ob_arm,
     }
   }
 
+  /* Read the vertex groups of the copy-on-write mesh from the cached weights. Deforming from the
+   * previous coordinates is rare enough to always use the generic deform. */
+  const ArmatureDeformWeights *deform_weights = NULL;
+  if (use_dverts && me_target == NULL && em_target == NULL && vert_coords_prev == NULL &&
+      ob_target->type == OB_MESH) {
+    Mesh *me = ob_target->data;
+    if (me->id.tag & LIB_TAG_COPIED_ON_WRITE) {
+      deform_weights = armature_deform_weights_ensure(me);
+    }
+  }
+
+  float(*defbase_mats)[4][4] = NULL;
+  bool *defbase_use_generic = NULL;
+  if (deform_weights) {
+    defbase_mats = MEM_malloc_arrayN(max_ii(defbase_len, 1), sizeof(*defbase_mats), __func__);
+    defbase_use_generic = MEM_calloc_arrayN(
+        max_ii(defbase_len, 1), sizeof(*defbase_use_generic), __func__);
+    for (i = 0; i < defbase_len; i++) {
+      const bPoseChannel *pchan = pchan_from_defbase[i];
+      if (pchan == NULL) {
+        continue;
+      }
+      const Bone *bone = pchan->bone;
+      copy_m4_m4(defbase_mats[i], pchan->chan_mat);
+      defbase_use_generic[i] = (bone->flag & BONE_MULT_VG_ENV) ||
+                               (bone->segments > 1 &&
+                                pchan->runtime.bbone_segments == bone->segments);
+    }
+  }
+
   ArmatureUserdata data = {
       .ob_arm = ob_arm,
       .ob_target = ob_target,
@@ -579,6 +857,9 @@ static void armature_deform_coords_impl(const Object *ob_arm,
       .dverts_len = dverts_len,
       .pchan_from_defbase = pchan_from_defbase,
       .defbase_len = defbase_len,
+      .deform_weights = deform_weights,
+      .defbase_mats = defbase_mats,
+      .defbase_use_generic = defbase_use_generic,
       .bmesh =
           {
               .cd_dvert_offset = cd_dvert_offset,
@@ -612,12 +893,18 @@ static void armature_deform_coords_impl(const Object *ob_arm,
     TaskParallelSettings settings;
     BLI_parallel_range_settings_defaults(&settings);
     settings.min_iter_per_thread = 32;
-    BLI_task_parallel_range(0, vert_coords_len, &data, armature_vert_task, &settings);
+    BLI_task_parallel_range(0,
+                            vert_coords_len,
+                            &data,
+                            deform_weights ? armature_vert_task_with_weights : armature_vert_task,
+                            &settings);
   }
 
   if (pchan_from_defbase) {
     MEM_freeN(pchan_from_defbase);
   }
+  MEM_SAFE_FREE(defbase_mats);
+  MEM_SAFE_FREE(defbase_use_generic);
 }
 
 void BKE_armature_deform_coords_with_gpencil_stroke(const Object *ob_arm,
@@ -0,0 +1,294 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BKE_action.h"
+#include "BKE_armature.h"
+#include "BKE_customdata.h"
+#include "BKE_deform.h"
+#include "BKE_idtype.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_action_types.h"
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "BLI_listbase.h"
+#include "BLI_math.h"
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+
+namespace blender::bke::tests {
+
+/**
+ * Compares the deform from the cached vertex group weights of copy-on-write meshes with the
+ * generic deform, which reads the weights of the mesh passed as deform target.
+ */
+class ArmatureDeformWeightsTest : public testing::Test {
+ protected:
+  static constexpr int verts_num = 200;
+
+  bArmature armature;
+  Object ob_armature;
+  Mesh mesh;
+  Object ob_mesh;
+  float (*coords)[3];
+
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+
+  void SetUp() override
+  {
+    memset(&armature, 0, sizeof(armature));
+    memset(&ob_armature, 0, sizeof(ob_armature));
+    memset(&mesh, 0, sizeof(mesh));
+    memset(&ob_mesh, 0, sizeof(ob_mesh));
+
+    IDType_ID_AR.init_data(&armature.id);
+    strcpy(armature.id.name, "ARArmature");
+    IDType_ID_OB.init_data(&ob_armature.id);
+    strcpy(ob_armature.id.name, "OBArmature");
+    ob_armature.type = OB_ARMATURE;
+    ob_armature.data = &armature;
+    ob_armature.pose = (bPose *)MEM_callocN(sizeof(bPose), __func__);
+    unit_m4(ob_armature.obmat);
+
+    IDType_ID_ME.init_data(&mesh.id);
+    strcpy(mesh.id.name, "MEMesh");
+    IDType_ID_OB.init_data(&ob_mesh.id);
+    strcpy(ob_mesh.id.name, "OBMesh");
+    ob_mesh.type = OB_MESH;
+    ob_mesh.data = &mesh;
+    unit_m4(ob_mesh.obmat);
+    copy_v3_fl3(ob_mesh.obmat[3], 0.5f, -0.25f, 1.0f);
+
+    RandomNumberGenerator rng;
+    coords = (float(*)[3])MEM_malloc_arrayN(verts_num, sizeof(float[3]), __func__);
+    for (int i = 0; i < verts_num; i++) {
+      coords[i][0] = rng.get_float() * 2.0f - 1.0f;
+      coords[i][1] = rng.get_float() * 3.0f - 0.5f;
+      coords[i][2] = rng.get_float() * 2.0f - 1.0f;
+    }
+    mesh.totvert = verts_num;
+    mesh.dvert = (MDeformVert *)CustomData_add_layer(
+        &mesh.vdata, CD_MDEFORMVERT, CD_CALLOC, nullptr, verts_num);
+  }
+
+  void TearDown() override
+  {
+    MEM_freeN(coords);
+    BKE_armature_deform_weights_discard(&mesh);
+    IDType_ID_OB.free_data(&ob_mesh.id);
+    IDType_ID_ME.free_data(&mesh.id);
+    IDType_ID_OB.free_data(&ob_armature.id);
+    IDType_ID_AR.free_data(&armature.id);
+  }
+
+  /** Add a bone along the Y axis, and a vertex group with the same name to the mesh. */
+  int bone_add(const char *name, const float head_y, const float chan_mat[4][4])
+  {
+    Bone *bone = (Bone *)MEM_callocN(sizeof(Bone), __func__);
+    BLI_strncpy(bone->name, name, sizeof(bone->name));
+    copy_v3_fl3(bone->arm_head, 0.0f, head_y, 0.0f);
+    copy_v3_fl3(bone->arm_tail, 0.0f, head_y + 1.0f, 0.0f);
+    copy_v3_v3(bone->head, bone->arm_head);
+    copy_v3_v3(bone->tail, bone->arm_tail);
+    unit_m4(bone->arm_mat);
+    copy_v3_v3(bone->arm_mat[3], bone->arm_head);
+    bone->rad_head = bone->rad_tail = 0.5f;
+    bone->dist = 1.0f;
+    bone->weight = 1.0f;
+    bone->segments = 1;
+    BLI_addtail(&armature.bonebase, bone);
+
+    bPoseChannel *pchan = BKE_pose_channel_ensure(ob_armature.pose, name);
+    pchan->bone = bone;
+    copy_m4_m4(pchan->chan_mat, chan_mat);
+    mat4_to_dquat(&pchan->runtime.deform_dual_quat, bone->arm_mat, pchan->chan_mat);
+
+    return vertex_group_add(name);
+  }
+
+  int vertex_group_add(const char *name)
+  {
+    BKE_object_defgroup_new(&ob_mesh, name);
+    return BKE_object_defgroup_count(&ob_mesh) - 1;
+  }
+
+  void weight_add(const int vert, const int def_nr, const float weight)
+  {
+    BKE_defvert_add_index_notest(&mesh.dvert[vert], def_nr, weight);
+  }
+
+  /** Deform with the given settings through both code paths, and compare the results. */
+  void expect_deform_matches(const int deformflag, const char *defgrp_name)
+  {
+    for (const bool use_deform_mats : {false, true}) {
+      float(*coords_generic)[3] = (float(*)[3])MEM_dupallocN(coords);
+      float(*coords_cached)[3] = (float(*)[3])MEM_dupallocN(coords);
+      float(*mats_generic)[3][3] = nullptr;
+      float(*mats_cached)[3][3] = nullptr;
+      if (use_deform_mats) {
+        mats_generic = (float(*)[3][3])MEM_malloc_arrayN(verts_num, sizeof(float[3][3]), __func__);
+        mats_cached = (float(*)[3][3])MEM_malloc_arrayN(verts_num, sizeof(float[3][3]), __func__);
+        for (int i = 0; i < verts_num; i++) {
+          unit_m3(mats_generic[i]);
+          unit_m3(mats_cached[i]);
+        }
+      }
+
+      /* Passing the mesh as deform target uses the generic deform. */
+      BKE_armature_deform_coords_with_mesh(&ob_armature,
+                                           &ob_mesh,
+                                           coords_generic,
+                                           mats_generic,
+                                           verts_num,
+                                           deformflag,
+                                           nullptr,
+                                           defgrp_name,
+                                           &mesh);
+
+      /* The weights are only cached for copy-on-write meshes. */
+      mesh.id.tag |= LIB_TAG_COPIED_ON_WRITE;
+      BKE_armature_deform_coords_with_mesh(&ob_armature,
+                                           &ob_mesh,
+                                           coords_cached,
+                                           mats_cached,
+                                           verts_num,
+                                           deformflag,
+                                           nullptr,
+                                           defgrp_name,
+                                           nullptr);
+      mesh.id.tag &= ~LIB_TAG_COPIED_ON_WRITE;
+
+      for (int i = 0; i < verts_num; i++) {
+        EXPECT_V3_NEAR(coords_cached[i], coords_generic[i], 1e-5f);
+        if (use_deform_mats) {
+          EXPECT_M3_NEAR(mats_cached[i], mats_generic[i], 1e-5f);
+        }
+      }
+
+      MEM_freeN(coords_generic);
+      MEM_freeN(coords_cached);
+      MEM_SAFE_FREE(mats_generic);
+      MEM_SAFE_FREE(mats_cached);
+    }
+  }
+
+  /**
+   * Two posed bones, and vertices with different kinds of influences:
+   * - No weights at all.
+   * - A single bone or two bones.
+   * - A zero weight of a bone, which disables the envelope deform.
+   * - Only a weight of a group without a bone, which falls back to the envelope deform.
+   * - Weights in the armature vertex group, including zero weights.
+   */
+  void weights_setup()
+  {
+    float mat_a[4][4], mat_b[4][4];
+    const float rot_a[3] = {0.3f, 0.0f, 0.2f};
+    const float rot_b[3] = {-0.5f, 0.4f, 0.0f};
+    const float loc_a[3] = {0.1f, 0.2f, 0.0f};
+    const float loc_b[3] = {0.0f, -0.3f, 0.4f};
+    const float scale[3] = {1.0f, 1.0f, 1.0f};
+    loc_eul_size_to_mat4(mat_a, loc_a, rot_a, scale);
+    loc_eul_size_to_mat4(mat_b, loc_b, rot_b, scale);
+
+    const int def_a = bone_add("A", 0.0f, mat_a);
+    const int def_b = bone_add("B", 1.0f, mat_b);
+    const int def_other = vertex_group_add("Other");
+    const int def_mask = vertex_group_add("Mask");
+
+    for (int i = 0; i < verts_num; i++) {
+      switch (i % 6) {
+        case 0:
+          break;
+        case 1:
+          weight_add(i, def_a, 0.7f);
+          break;
+        case 2:
+          weight_add(i, def_a, 0.3f);
+          weight_add(i, def_b, 0.6f);
+          break;
+        case 3:
+          weight_add(i, def_b, 0.0f);
+          break;
+        case 4:
+          weight_add(i, def_other, 1.0f);
+          break;
+        case 5:
+          weight_add(i, def_b, 0.5f);
+          weight_add(i, def_other, 0.5f);
+          break;
+      }
+      if (i % 4 != 0) {
+        weight_add(i, def_mask, (i % 4) / 4.0f);
+      }
+    }
+  }
+};
+
+TEST_F(ArmatureDeformWeightsTest, linear_blend)
+{
+  weights_setup();
+  expect_deform_matches(ARM_DEF_VGROUP, "");
+}
+
+TEST_F(ArmatureDeformWeightsTest, dual_quaternion)
+{
+  weights_setup();
+  expect_deform_matches(ARM_DEF_VGROUP | ARM_DEF_QUATERNION, "");
+}
+
+TEST_F(ArmatureDeformWeightsTest, envelope_fallback)
+{
+  weights_setup();
+  expect_deform_matches(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE, "");
+  expect_deform_matches(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE | ARM_DEF_QUATERNION, "");
+}
+
+TEST_F(ArmatureDeformWeightsTest, armature_vertex_group)
+{
+  weights_setup();
+  expect_deform_matches(ARM_DEF_VGROUP, "Mask");
+  expect_deform_matches(ARM_DEF_VGROUP | ARM_DEF_QUATERNION, "Mask");
+  expect_deform_matches(ARM_DEF_VGROUP | ARM_DEF_INVERT_VGROUP, "Mask");
+}
+
+TEST_F(ArmatureDeformWeightsTest, non_uniform_scale)
+{
+  float mat[4][4];
+  const float loc[3] = {0.0f, 0.5f, 0.0f};
+  const float rot[3] = {0.0f, 0.0f, 0.7f};
+  const float scale[3] = {1.5f, 0.5f, 1.0f};
+  loc_eul_size_to_mat4(mat, loc, rot, scale);
+  const int def_nr = bone_add("Bone", 0.0f, mat);
+  for (int i = 0; i < verts_num; i++) {
+    weight_add(i, def_nr, (i % 3) / 2.0f);
+  }
+  expect_deform_matches(ARM_DEF_VGROUP, "");
+  expect_deform_matches(ARM_DEF_VGROUP | ARM_DEF_QUATERNION, "");
+  expect_deform_matches(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE, "");
+}
+
+}  // namespace blender::bke::tests
@@ -432,6 +432,7 @@ static void splineik_evaluate_bone(
     copy_v3_v3(pchan->pose_head, bone_pos);
     copy_v3_v3(pchan->pose_tail, bone_pos);
     pchan->flag |= POSE_DONE;
+    BKE_pose_channel_eval_mat_invalidate(pchan);
     return;
   }
 
@@ -749,6 +750,7 @@ static void splineik_evaluate_bone(
 
   /* Done! */
   pchan->flag |= POSE_DONE;
+  BKE_pose_channel_eval_mat_invalidate(pchan);
 }
 
 /* Evaluate the chain starting from the nominated bone */
@@ -839,10 +841,19 @@ void BKE_pose_eval_init(struct Depsgraph *depsgraph, Scene *UNUSED(scene), Objec
   /* imat is needed for solvers. */
   invert_m4_m4(object->imat, object->obmat);
 
+  /* Pose matrices kept from the previous evaluation only account for the channel transforms, so
+   * they are computed again when the rest pose or the bone settings of the armature changed. */
+  const bArmature *armature = (const bArmature *)object->data;
+  const bool is_armature_changed = (armature->id.recalc != 0);
+
   /* clear flags */
   for (bPoseChannel *pchan = pose->chanbase.first; pchan != NULL; pchan = pchan->next) {
     pchan->flag &= ~(POSE_DONE | POSE_CHAIN | POSE_IKTREE | POSE_IKSPLINE);
 
+    if (is_armature_changed) {
+      pchan->runtime.flag &= ~POSE_RUNTIME_EVAL_CHAN_MAT_VALID;
+    }
+
     /* Free B-Bone shape data cache if it's not a B-Bone. */
     if (pchan->bone == NULL || pchan->bone->segments <= 1) {
       BKE_pose_channel_free_bbone_cache(&pchan->runtime);
@@ -873,6 +884,60 @@ void BKE_pose_eval_init_ik(struct Depsgraph *depsgraph, Scene *scene, Object *ob
   BKE_pose_splineik_init_tree(scene, object, ctime);
 }
 
+void BKE_pose_channel_eval_mat_invalidate(bPoseChannel *pchan)
+{
+  pchan->runtime.flag &= ~POSE_RUNTIME_EVAL_CHAN_MAT_VALID;
+  pchan->runtime.flag |= POSE_RUNTIME_EVAL_CHANGED;
+}
+
+/**
+ * Compute the pose matrix of a bone without constraints which is not a part of an IK chain.
+ *
+ * Such a pose matrix only depends on the channel transform and on the pose matrix of the parent,
+ * so when neither of them changed since the previous evaluation the pose matrix is kept as-is.
+ * Unchanged bones do not mark themselves as changed, so the whole static sub-trees of a rig are
+ * skipped, which avoids most of the matrix math of rigs with many static helper bones.
+ */
+static void pose_channel_eval_mat(struct Depsgraph *depsgraph,
+                                  Scene *scene,
+                                  Object *object,
+                                  bPoseChannel *pchan)
+{
+  bPoseChannel_Runtime *runtime = &pchan->runtime;
+  const bPoseChannel *parent = pchan->parent;
+
+  /* Changes of the cyclic offset are not tracked, so root bones using it are always computed. */
+  const bool use_cyclic_offset = (parent == NULL) &&
+                                 (pchan->bone->flag & BONE_NO_CYCLICOFFSET) == 0 &&
+                                 !is_zero_v3(object->pose->cyclic_offset);
+
+  float chan_mat[4][4];
+  BKE_pchan_to_mat4(pchan, chan_mat);
+
+  if ((runtime->flag & POSE_RUNTIME_EVAL_CHAN_MAT_VALID) && !use_cyclic_offset &&
+      (parent == NULL || (parent->runtime.flag & POSE_RUNTIME_EVAL_CHANGED) == 0) &&
+      equals_m4m4(runtime->eval_chan_mat, chan_mat)) {
+    runtime->flag &= ~POSE_RUNTIME_EVAL_CHANGED;
+    DEG_debug_stats_pose_bone_evaluated(depsgraph, true);
+    return;
+  }
+
+  const bool was_valid = (runtime->flag & POSE_RUNTIME_EVAL_CHAN_MAT_VALID) != 0;
+  float pose_mat_prev[4][4];
+  copy_m4_m4(pose_mat_prev, pchan->pose_mat);
+
+  /* TODO(sergey): Use time source node for time. */
+  float ctime = BKE_scene_ctime_get(scene); /* not accurate... */
+  BKE_pose_where_is_bone(depsgraph, scene, object, pchan, ctime, 1);
+
+  copy_m4_m4(runtime->eval_chan_mat, chan_mat);
+  SET_FLAG_FROM_TEST(runtime->flag, !use_cyclic_offset, POSE_RUNTIME_EVAL_CHAN_MAT_VALID);
+  SET_FLAG_FROM_TEST(runtime->flag,
+                     !was_valid || !equals_m4m4(pose_mat_prev, pchan->pose_mat),
+                     POSE_RUNTIME_EVAL_CHANGED);
+  DEG_debug_stats_pose_bone_evaluated(depsgraph, false);
+}
+
 void BKE_pose_eval_bone(struct Depsgraph *depsgraph, Scene *scene, Object *object, int pchan_index)
 {
   const bArmature *armature = (bArmature *)object->data;
@@ -890,22 +955,24 @@ void BKE_pose_eval_bone(struct Depsgraph *depsgraph, Scene *scene, Object *objec
       copy_v3_v3(pchan->pose_head, bone->arm_head);
       copy_v3_v3(pchan->pose_tail, bone->arm_tail);
     }
+    BKE_pose_channel_eval_mat_invalidate(pchan);
   }
   else {
     /* TODO(sergey): Currently if there are constraints full transform is
      * being evaluated in BKE_pose_constraints_evaluate. */
     if (pchan->constraints.first == NULL) {
       if (pchan->flag & POSE_IKTREE || pchan->flag & POSE_IKSPLINE) {
-        /* pass */
+        BKE_pose_channel_eval_mat_invalidate(pchan);
       }
       else {
         if ((pchan->flag & POSE_DONE) == 0) {
-          /* TODO(sergey): Use time source node for time. */
-          float ctime = BKE_scene_ctime_get(scene); /* not accurate... */
-          BKE_pose_where_is_bone(depsgraph, scene, object, pchan, ctime, 1);
+          pose_channel_eval_mat(depsgraph, scene, object, pchan);
         }
       }
     }
+    else {
+      BKE_pose_channel_eval_mat_invalidate(pchan);
+    }
   }
 }
 
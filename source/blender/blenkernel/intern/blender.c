@@ -56,6 +56,9 @@
 #include "BKE_studiolight.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_debug.h"
+
+#include "MOD_nodes.h"
 
 #include "RE_pipeline.h"
 #include "RE_texture.h"
@@ -84,6 +87,7 @@ void BKE_blender_free(void)
   if (G.log.file != NULL) {
     fclose(G.log.file);
   }
+  DEG_debug_trace_end();
 
   BKE_spacetypes_free(); /* after free main, it uses space callbacks */
 
@@ -98,6 +102,7 @@ void BKE_blender_free(void)
 
   IMB_moviecache_destruct();
 
+  MOD_nodes_output_cache_free();
   BKE_node_system_exit();
 }
 
@@ -66,6 +66,8 @@
 #include "BLO_readfile.h"
 #include "BLO_writefile.h"
 
+#include "MOD_nodes.h"
+
 #include "RNA_access.h"
 
 #include "RE_pipeline.h"
@@ -177,6 +179,11 @@ static void setup_app_data(bContext *C,
     RE_FreeAllRenderResults();
   }
 
+  /* Geometry cached by the geometry nodes evaluator is not likely to be used by another file. */
+  if (mode != LOAD_UNDO) {
+    MOD_nodes_output_cache_free();
+  }
+
   /* Only make filepaths compatible when loading for real (not undo) */
   if (mode != LOAD_UNDO) {
     clean_paths(bfd->main);
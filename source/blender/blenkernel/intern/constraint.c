@@ -6330,11 +6330,72 @@ void BKE_constraint_target_matrix_get(struct Depsgraph *depsgraph,
   }
 }
 
-void BKE_constraint_targets_for_solving_get(struct Depsgraph *depsgraph,
-                                            bConstraint *con,
-                                            bConstraintOb *cob,
-                                            ListBase *targets,
-                                            float ctime)
+/**
+ * Matrix of the last target computed while solving a constraint stack.
+ *
+ * Stacks often have several constraints using the same target in the same way (for example
+ * Copy Location, Copy Rotation and Copy Scale of one bone), so the target matrix is computed once
+ * and reused by the following constraints of the stack.
+ */
+typedef struct ConstraintTargetMatrixCache {
+  bool is_valid;
+
+  Object *tar;
+  char subtarget[64];
+  short space;
+  /** Flags of the constraint affecting the target matrix (B-Bone shape). */
+  short con_flag;
+  float headtail;
+
+  float matrix[4][4];
+} ConstraintTargetMatrixCache;
+
+/* The matrix computed by #default_get_tarmat only depends on the target itself, except for the
+ * custom space which is set up per constraint. */
+static bool constraint_target_matrix_is_cacheable(const bConstraintTypeInfo *cti,
+                                                  const bConstraintTarget *ct)
+{
+  return cti->get_target_matrix == default_get_tarmat && VALID_CONS_TARGET(ct) &&
+         ELEM(ct->space,
+              CONSTRAINT_SPACE_WORLD,
+              CONSTRAINT_SPACE_POSE,
+              CONSTRAINT_SPACE_LOCAL,
+              CONSTRAINT_SPACE_PARLOCAL);
+}
+
+static bool constraint_target_matrix_cache_lookup(const ConstraintTargetMatrixCache *cache,
+                                                  const bConstraint *con,
+                                                  bConstraintTarget *ct)
+{
+  const short con_flag = con->flag & (CONSTRAINT_BBONE_SHAPE | CONSTRAINT_BBONE_SHAPE_FULL);
+  if (!cache->is_valid || cache->tar != ct->tar || cache->space != ct->space ||
+      cache->con_flag != con_flag || cache->headtail != con->headtail ||
+      !STREQ(cache->subtarget, ct->subtarget)) {
+    return false;
+  }
+  copy_m4_m4(ct->matrix, cache->matrix);
+  return true;
+}
+
+static void constraint_target_matrix_cache_store(ConstraintTargetMatrixCache *cache,
+                                                 const bConstraint *con,
+                                                 const bConstraintTarget *ct)
+{
+  cache->is_valid = true;
+  cache->tar = ct->tar;
+  STRNCPY(cache->subtarget, ct->subtarget);
+  cache->space = ct->space;
+  cache->con_flag = con->flag & (CONSTRAINT_BBONE_SHAPE | CONSTRAINT_BBONE_SHAPE_FULL);
+  cache->headtail = con->headtail;
+  copy_m4_m4(cache->matrix, ct->matrix);
+}
+
+static void constraint_targets_for_solving_get(struct Depsgraph *depsgraph,
+                                               bConstraint *con,
+                                               bConstraintOb *cob,
+                                               ListBase *targets,
+                                               float ctime,
+                                               ConstraintTargetMatrixCache *cache)
 {
   const bConstraintTypeInfo *cti = BKE_constraint_typeinfo_get(con);
 
@@ -6357,7 +6418,13 @@ void BKE_constraint_targets_for_solving_get(struct Depsgraph *depsgraph,
      */
     if (cti->get_target_matrix) {
       for (ct = targets->first; ct; ct = ct->next) {
-        cti->get_target_matrix(depsgraph, con, cob, ct, ctime);
+        if (cache == NULL || !constraint_target_matrix_is_cacheable(cti, ct)) {
+          cti->get_target_matrix(depsgraph, con, cob, ct, ctime);
+        }
+        else if (!constraint_target_matrix_cache_lookup(cache, con, ct)) {
+          cti->get_target_matrix(depsgraph, con, cob, ct, ctime);
+          constraint_target_matrix_cache_store(cache, con, ct);
+        }
       }
     }
     else {
@@ -6368,6 +6435,15 @@ void BKE_constraint_targets_for_solving_get(struct Depsgraph *depsgraph,
   }
 }
 
+void BKE_constraint_targets_for_solving_get(struct Depsgraph *depsgraph,
+                                            bConstraint *con,
+                                            bConstraintOb *cob,
+                                            ListBase *targets,
+                                            float ctime)
+{
+  constraint_targets_for_solving_get(depsgraph, con, cob, targets, ctime, NULL);
+}
+
 void BKE_constraint_custom_object_space_get(float r_mat[4][4], bConstraint *con)
 {
   if (!con ||
@@ -6407,12 +6483,15 @@ void BKE_constraints_solve(struct Depsgraph *depsgraph,
   bConstraint *con;
   float oldmat[4][4];
   float enf;
+  ConstraintTargetMatrixCache target_cache;
 
   /* check that there is a valid constraint object to evaluate */
   if (cob == NULL) {
     return;
   }
 
+  target_cache.is_valid = false;
+
   /* loop over available constraints, solving and blending them */
   for (con = conlist->first; con; con = con->next) {
     const bConstraintTypeInfo *cti = BKE_constraint_typeinfo_get(con);
@@ -6450,7 +6529,7 @@ void BKE_constraints_solve(struct Depsgraph *depsgraph,
         cob->ob, cob->pchan, cob, cob->matrix, CONSTRAINT_SPACE_WORLD, con->ownspace, false);
 
     /* prepare targets for constraint solving */
-    BKE_constraint_targets_for_solving_get(depsgraph, con, cob, &targets, ctime);
+    constraint_targets_for_solving_get(depsgraph, con, cob, &targets, ctime, &target_cache);
 
     /* Solve the constraint and put result in cob->matrix */
     cti->evaluate_constraint(con, cob, &targets);
@@ -1678,6 +1678,33 @@ bool BKE_fcurve_bezt_subdivide_handles(struct BezTriple *bezt,
 /** \name F-Curve Evaluation
  * \{ */
 
+bool BKE_fcurve_bezpart_evaluate(const float v1[2],
+                                 const float v2[2],
+                                 const float v3[2],
+                                 const float v4[2],
+                                 const float evaltime,
+                                 float *r_value)
+{
+  float opl[32];
+
+  /* Try to get a value for this position - if failure, try another set of points. */
+  if (!findzero(evaltime, v1[0], v2[0], v3[0], v4[0], opl)) {
+    if (G.debug & G_DEBUG) {
+      printf("    ERROR: findzero() failed at %f with %f %f %f %f\n",
+             evaltime,
+             v1[0],
+             v2[0],
+             v3[0],
+             v4[0]);
+    }
+    return false;
+  }
+
+  berekeny(v1[1], v2[1], v3[1], v4[1], opl, 1);
+  *r_value = opl[0];
+  return true;
+}
+
 static float fcurve_eval_keyframes_extrapolate(
     FCurve *fcu, BezTriple *bezts, float evaltime, int endpoint_offset, int direction_to_neighbor)
 {
@@ -1794,7 +1821,7 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
   switch (prevbezt->ipo) {
     /* Interpolation ...................................... */
     case BEZT_IPO_BEZ: {
-      float v1[2], v2[2], v3[2], v4[2], opl[32];
+      float v1[2], v2[2], v3[2], v4[2];
 
       /* Bezier interpolation. */
       /* (v1, v2) are the first keyframe and its 2nd handle. */
@@ -1818,21 +1845,11 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
       /* Adjust handles so that they don't overlap (forming a loop). */
       BKE_fcurve_correct_bezpart(v1, v2, v3, v4);
 
-      /* Try to get a value for this position - if failure, try another set of points. */
-      if (!findzero(evaltime, v1[0], v2[0], v3[0], v4[0], opl)) {
-        if (G.debug & G_DEBUG) {
-          printf("    ERROR: findzero() failed at %f with %f %f %f %f\n",
-                 evaltime,
-                 v1[0],
-                 v2[0],
-                 v3[0],
-                 v4[0]);
-        }
-        return 0.0;
+      float value;
+      if (!BKE_fcurve_bezpart_evaluate(v1, v2, v3, v4, evaltime, &value)) {
+        return 0.0f;
       }
-
-      berekeny(v1[1], v2[1], v3[1], v4[1], opl, 1);
-      return opl[0];
+      return value;
     }
     case BEZT_IPO_LIN:
       /* Linear - simply linearly interpolate between values of the two keyframes. */
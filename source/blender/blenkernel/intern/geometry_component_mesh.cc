@@ -49,7 +49,16 @@ GeometryComponent *MeshComponent::copy() const
 {
   MeshComponent *new_component = new MeshComponent();
   if (mesh_ != nullptr) {
-    new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    if (ownership_ == GeometryOwnershipType::Owned) {
+      /* Reference the custom data layers instead of copying them. Often only a few layers are
+       * modified on the copy, the others are never duplicated. */
+      new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, true);
+      this->user_add();
+      new_component->shared_layers_owner_ = this;
+    }
+    else {
+      new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    }
     new_component->ownership_ = GeometryOwnershipType::Owned;
   }
   return new_component;
@@ -64,6 +73,10 @@ void MeshComponent::clear()
     }
     mesh_ = nullptr;
   }
+  if (shared_layers_owner_ != nullptr) {
+    shared_layers_owner_->user_remove();
+    shared_layers_owner_ = nullptr;
+  }
 }
 
 bool MeshComponent::has_mesh() const
@@ -82,6 +95,8 @@ void MeshComponent::replace(Mesh *mesh, GeometryOwnershipType ownership)
 Mesh *MeshComponent::release()
 {
   BLI_assert(this->is_mutable());
+  /* The caller may keep the mesh longer than the component that owns the shared layers. */
+  this->unshare_layers();
   Mesh *mesh = mesh_;
   mesh_ = nullptr;
   return mesh;
@@ -93,6 +108,13 @@ const Mesh *MeshComponent::get_for_read() const
 }
 
 Mesh *MeshComponent::get_for_write()
+{
+  BLI_assert(this->is_mutable());
+  this->unshare_layers();
+  return this->get_for_write_with_shared_layers();
+}
+
+Mesh *MeshComponent::get_for_write_with_shared_layers()
 {
   BLI_assert(this->is_mutable());
   if (ownership_ == GeometryOwnershipType::ReadOnly) {
@@ -102,6 +124,23 @@ Mesh *MeshComponent::get_for_write()
   return mesh_;
 }
 
+void MeshComponent::unshare_layers()
+{
+  if (shared_layers_owner_ == nullptr) {
+    return;
+  }
+  if (mesh_ != nullptr) {
+    CustomData_duplicate_referenced_layers(&mesh_->vdata, mesh_->totvert);
+    CustomData_duplicate_referenced_layers(&mesh_->edata, mesh_->totedge);
+    CustomData_duplicate_referenced_layers(&mesh_->ldata, mesh_->totloop);
+    CustomData_duplicate_referenced_layers(&mesh_->pdata, mesh_->totpoly);
+    CustomData_duplicate_referenced_layers(&mesh_->fdata, mesh_->totface);
+    BKE_mesh_update_customdata_pointers(mesh_, false);
+  }
+  shared_layers_owner_->user_remove();
+  shared_layers_owner_ = nullptr;
+}
+
 bool MeshComponent::is_empty() const
 {
   return mesh_ == nullptr;
@@ -109,7 +148,7 @@ bool MeshComponent::is_empty() const
 
 bool MeshComponent::owns_direct_data() const
 {
-  return ownership_ == GeometryOwnershipType::Owned;
+  return ownership_ == GeometryOwnershipType::Owned && shared_layers_owner_ == nullptr;
 }
 
 void MeshComponent::ensure_owns_direct_data()
@@ -119,6 +158,7 @@ void MeshComponent::ensure_owns_direct_data()
     mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
     ownership_ = GeometryOwnershipType::Owned;
   }
+  this->unshare_layers();
 }
 
 /** \} */
@@ -839,7 +879,8 @@ static Mesh *get_mesh_from_component_for_write(GeometryComponent &component)
 {
   BLI_assert(component.type() == GEO_COMPONENT_TYPE_MESH);
   MeshComponent &mesh_component = static_cast<MeshComponent &>(component);
-  return mesh_component.get_for_write();
+  /* The attribute providers duplicate shared layers before they are modified. */
+  return mesh_component.get_for_write_with_shared_layers();
 }
 
 static const Mesh *get_mesh_from_component_for_read(const GeometryComponent &component)
@@ -1027,7 +1068,7 @@ class VertexGroupsAttributeProvider final : public DynamicAttributesProvider {
       return {};
     }
     MeshComponent &mesh_component = static_cast<MeshComponent &>(component);
-    Mesh *mesh = mesh_component.get_for_write();
+    Mesh *mesh = mesh_component.get_for_write_with_shared_layers();
     if (mesh == nullptr) {
       return {};
     }
@@ -1058,7 +1099,7 @@ class VertexGroupsAttributeProvider final : public DynamicAttributesProvider {
       return false;
     }
     MeshComponent &mesh_component = static_cast<MeshComponent &>(component);
-    Mesh *mesh = mesh_component.get_for_write();
+    Mesh *mesh = mesh_component.get_for_write_with_shared_layers();
     if (mesh == nullptr) {
       return true;
     }
@@ -1075,6 +1116,9 @@ class VertexGroupsAttributeProvider final : public DynamicAttributesProvider {
     if (mesh->dvert == nullptr) {
       return true;
     }
+    /* Copy the data layer if it is shared with some other mesh. */
+    mesh->dvert = (MDeformVert *)CustomData_duplicate_referenced_layer(
+        &mesh->vdata, CD_MDEFORMVERT, mesh->totvert);
     for (MDeformVert &dvert : MutableSpan(mesh->dvert, mesh->totvert)) {
       MDeformWeight *weight = BKE_defvert_find_index(&dvert, index);
       BKE_defvert_remove_group(&dvert, weight);
@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "BLI_math_vector.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_attribute_access.hh"
+#include "BKE_customdata.h"
+#include "BKE_geometry_set.hh"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+namespace blender::bke::tests {
+
+static const int verts_num = 4;
+
+class MeshComponentSharedLayersTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+
+ protected:
+  MeshComponent *original;
+  MeshComponent *copy;
+
+  void SetUp() override
+  {
+    Mesh *mesh = BKE_mesh_new_nomain(verts_num, 0, 0, 0, 0);
+    float *values = static_cast<float *>(CustomData_add_layer_named(
+        &mesh->vdata, CD_PROP_FLOAT, CD_CALLOC, nullptr, verts_num, "value"));
+    for (const int i : IndexRange(verts_num)) {
+      copy_v3_fl(mesh->mvert[i].co, (float)i);
+      values[i] = (float)i;
+    }
+
+    original = new MeshComponent();
+    original->replace(mesh);
+    copy = static_cast<MeshComponent *>(original->copy());
+  }
+
+  void TearDown() override
+  {
+    /* The copy keeps a user of the original. */
+    delete copy;
+    EXPECT_TRUE(original->is_mutable());
+    delete original;
+  }
+
+  static const float *values_of(const MeshComponent &component)
+  {
+    const Mesh *mesh = component.get_for_read();
+    return static_cast<const float *>(
+        CustomData_get_layer_named(&mesh->vdata, CD_PROP_FLOAT, "value"));
+  }
+
+  /* The original mesh still has the values it was created with. */
+  void expect_original_unchanged()
+  {
+    const Mesh *mesh = original->get_for_read();
+    const float *values = values_of(*original);
+    for (const int i : IndexRange(verts_num)) {
+      EXPECT_EQ(mesh->mvert[i].co[0], (float)i);
+      EXPECT_EQ(values[i], (float)i);
+    }
+  }
+};
+
+TEST_F(MeshComponentSharedLayersTest, CopyReferencesLayers)
+{
+  EXPECT_FALSE(original->is_mutable());
+  EXPECT_FALSE(copy->owns_direct_data());
+  EXPECT_EQ(copy->get_for_read()->mvert, original->get_for_read()->mvert);
+  EXPECT_EQ(values_of(*copy), values_of(*original));
+}
+
+TEST_F(MeshComponentSharedLayersTest, AttributeWriteCopiesLayer)
+{
+  OutputAttribute_Typed<float> attribute = copy->attribute_try_get_for_output_only<float>(
+      "value", ATTR_DOMAIN_POINT);
+  ASSERT_TRUE(attribute);
+  attribute.as_span().fill(10.0f);
+  attribute.save();
+
+  /* Only the written layer is duplicated, the positions are still shared. */
+  EXPECT_NE(values_of(*copy), values_of(*original));
+  EXPECT_EQ(copy->get_for_read()->mvert, original->get_for_read()->mvert);
+  for (const int i : IndexRange(verts_num)) {
+    EXPECT_EQ(values_of(*copy)[i], 10.0f);
+  }
+  expect_original_unchanged();
+}
+
+TEST_F(MeshComponentSharedLayersTest, PositionWriteCopiesLayer)
+{
+  OutputAttribute_Typed<float3> positions = copy->attribute_try_get_for_output<float3>(
+      "position", ATTR_DOMAIN_POINT, float3(0.0f));
+  ASSERT_TRUE(positions);
+  positions.as_span().fill(float3(10.0f));
+  positions.save();
+
+  EXPECT_NE(copy->get_for_read()->mvert, original->get_for_read()->mvert);
+  EXPECT_EQ(values_of(*copy), values_of(*original));
+  for (const int i : IndexRange(verts_num)) {
+    EXPECT_EQ(copy->get_for_read()->mvert[i].co[0], 10.0f);
+  }
+  expect_original_unchanged();
+}
+
+TEST_F(MeshComponentSharedLayersTest, GetForWriteCopiesAllLayers)
+{
+  Mesh *mesh = copy->get_for_write();
+  EXPECT_TRUE(copy->owns_direct_data());
+  EXPECT_TRUE(original->is_mutable());
+  EXPECT_NE(mesh->mvert, original->get_for_read()->mvert);
+  EXPECT_NE(values_of(*copy), values_of(*original));
+
+  float *values = static_cast<float *>(
+      CustomData_get_layer_named(&mesh->vdata, CD_PROP_FLOAT, "value"));
+  for (const int i : IndexRange(verts_num)) {
+    EXPECT_EQ(values[i], (float)i);
+    mesh->mvert[i].co[0] = 10.0f;
+    values[i] = 10.0f;
+  }
+  expect_original_unchanged();
+}
+
+TEST_F(MeshComponentSharedLayersTest, ReleaseCopiesAllLayers)
+{
+  Mesh *mesh = copy->release();
+  EXPECT_TRUE(original->is_mutable());
+  EXPECT_NE(mesh->mvert, original->get_for_read()->mvert);
+
+  /* The released mesh stays valid after the original is freed. */
+  original->clear();
+  for (const int i : IndexRange(verts_num)) {
+    EXPECT_EQ(mesh->mvert[i].co[0], (float)i);
+  }
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshComponentSharedLayersTest, CopyOfCopy)
+{
+  /* Writing to a copy of the copy leaves both of the other meshes unchanged. */
+  MeshComponent *copy_2 = static_cast<MeshComponent *>(copy->copy());
+  Mesh *mesh = copy_2->get_for_write();
+  mesh->mvert[0].co[0] = 10.0f;
+  EXPECT_EQ(copy->get_for_read()->mvert[0].co[0], 0.0f);
+  expect_original_unchanged();
+  delete copy_2;
+}
+
+}  // namespace blender::bke::tests
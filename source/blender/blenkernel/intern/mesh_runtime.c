@@ -33,6 +33,7 @@
 #include "BLI_task.h"
 #include "BLI_threads.h"
 
+#include "BKE_armature.h"
 #include "BKE_bvhutils.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
@@ -103,6 +104,7 @@ void BKE_mesh_runtime_reset_on_copy(Mesh *mesh, const int UNUSED(flag))
   memset(&runtime->looptris, 0, sizeof(runtime->looptris));
   runtime->bvh_cache = NULL;
   runtime->shrinkwrap_data = NULL;
+  runtime->deform_weights = NULL;
 
   mesh_runtime_init_mutexes(mesh);
 }
@@ -270,6 +272,7 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
     mesh->runtime.subdiv_ccg = NULL;
   }
   BKE_shrinkwrap_discard_boundary_data(mesh);
+  BKE_armature_deform_weights_discard(mesh);
 }
 
 /** \} */
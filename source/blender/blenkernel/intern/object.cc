@@ -2695,6 +2695,33 @@ void BKE_object_transform_copy(Object *ob_tar, const Object *ob_src)
   copy_v3_v3(ob_tar->scale, ob_src->scale);
 }
 
+void BKE_object_transform_settings_copy(Object *ob_tar, const Object *ob_src)
+{
+  BKE_object_transform_copy(ob_tar, ob_src);
+  copy_v3_v3(ob_tar->dloc, ob_src->dloc);
+  copy_v3_v3(ob_tar->drot, ob_src->drot);
+  copy_v4_v4(ob_tar->dquat, ob_src->dquat);
+  copy_v3_v3(ob_tar->drotAxis, ob_src->drotAxis);
+  ob_tar->drotAngle = ob_src->drotAngle;
+  copy_v3_v3(ob_tar->dscale, ob_src->dscale);
+
+  copy_m4_m4(ob_tar->parentinv, ob_src->parentinv);
+  ob_tar->partype = ob_src->partype;
+  ob_tar->par1 = ob_src->par1;
+  ob_tar->par2 = ob_src->par2;
+  ob_tar->par3 = ob_src->par3;
+
+  ob_tar->transflag = ob_src->transflag;
+  ob_tar->protectflag = ob_src->protectflag;
+  ob_tar->trackflag = ob_src->trackflag;
+  ob_tar->upflag = ob_src->upflag;
+  ob_tar->instance_faces_scale = ob_src->instance_faces_scale;
+
+  ob_tar->dt = ob_src->dt;
+  ob_tar->empty_drawtype = ob_src->empty_drawtype;
+  ob_tar->empty_drawsize = ob_src->empty_drawsize;
+}
+
 Object *BKE_object_duplicate(Main *bmain, Object *ob, uint dupflag, uint duplicate_options)
 {
   const bool is_subprocess = (duplicate_options & LIB_ID_DUPLICATE_IS_SUBPROCESS) != 0;
@@ -46,12 +46,22 @@ struct FileReader;
 typedef ssize_t (*FileReaderReadFn)(struct FileReader *reader, void *buffer, size_t size);
 typedef off64_t (*FileReaderSeekFn)(struct FileReader *reader, off64_t offset, int whence);
 typedef void (*FileReaderCloseFn)(struct FileReader *reader);
+typedef ssize_t (*FileReaderReadAtFn)(struct FileReader *reader,
+                                      void *buffer,
+                                      size_t size,
+                                      off64_t offset);
 
 /** General structure for all #FileReaders, implementations add custom fields at the end. */
 typedef struct FileReader {
   FileReaderReadFn read;
   FileReaderSeekFn seek;
   FileReaderCloseFn close;
+  /**
+   * Optional positional read that leaves #FileReader.offset untouched.
+   * Only set by readers for which it's safe to call from multiple threads at once,
+   * NULL otherwise.
+   */
+  FileReaderReadAtFn read_at;
 
   off64_t offset;
 } FileReader;
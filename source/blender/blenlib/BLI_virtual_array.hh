@@ -1172,4 +1172,45 @@ inline void devirtualize_varray2(const VArray<T1> &varray1,
   func(varray1, varray2);
 }
 
+/**
+ * Same as `devirtualize_varray2`, but for three virtual arrays. Every virtual array is
+ * devirtualized when it is a span or a single value, which results in eight optimized cases.
+ */
+template<typename T1, typename T2, typename T3, typename Func>
+inline void devirtualize_varray3(const VArray<T1> &varray1,
+                                 const VArray<T2> &varray2,
+                                 const VArray<T3> &varray3,
+                                 const Func &func,
+                                 bool enable = true)
+{
+  /* Support disabling the devirtualization to simplify benchmarking. */
+  if (enable) {
+    const bool is_span1 = varray1.is_span();
+    const bool is_span2 = varray2.is_span();
+    const bool is_span3 = varray3.is_span();
+    const bool is_single1 = varray1.is_single();
+    const bool is_single2 = varray2.is_single();
+    const bool is_single3 = varray3.is_single();
+    if ((is_span1 || is_single1) && (is_span2 || is_single2) && (is_span3 || is_single3)) {
+      /* Every virtual array is known to be a span or a single value here. */
+      auto devirtualize_one = [](const auto &varray, const auto &fn) {
+        if (varray.is_span()) {
+          fn(varray.get_internal_span());
+        }
+        else {
+          fn(SingleAsSpan(varray));
+        }
+      };
+      devirtualize_one(varray1, [&](const auto &span1) {
+        devirtualize_one(varray2, [&](const auto &span2) {
+          devirtualize_one(varray3, [&](const auto &span3) { func(span1, span2, span3); });
+        });
+      });
+      return;
+    }
+  }
+  /* See #devirtualize_varray2 for why partially devirtualizing the inputs is not done. */
+  func(varray1, varray2, varray3);
+}
+
 }  // namespace blender
@@ -51,6 +51,20 @@ static ssize_t memory_read_raw(FileReader *reader, void *buffer, size_t size)
   return readsize;
 }
 
+static ssize_t memory_read_at_raw(FileReader *reader, void *buffer, size_t size, off64_t offset)
+{
+  MemoryReader *mem = (MemoryReader *)reader;
+
+  if (offset < 0 || (size_t)offset > mem->length) {
+    return 0;
+  }
+  size_t readsize = MIN2(size, (size_t)(mem->length - (size_t)offset));
+
+  memcpy(buffer, mem->data + offset, readsize);
+
+  return readsize;
+}
+
 static off64_t memory_seek(FileReader *reader, off64_t offset, int whence)
 {
   MemoryReader *mem = (MemoryReader *)reader;
@@ -92,6 +106,7 @@ FileReader *BLI_filereader_new_memory(const void *data, size_t len)
   mem->reader.read = memory_read_raw;
   mem->reader.seek = memory_seek;
   mem->reader.close = memory_close_raw;
+  mem->reader.read_at = memory_read_at_raw;
 
   return (FileReader *)mem;
 }
@@ -118,6 +133,24 @@ static ssize_t memory_read_mmap(FileReader *reader, void *buffer, size_t size)
   return readsize;
 }
 
+static ssize_t memory_read_at_mmap(FileReader *reader, void *buffer, size_t size, off64_t offset)
+{
+  MemoryReader *mem = (MemoryReader *)reader;
+
+  if (offset < 0 || (size_t)offset > mem->length) {
+    return 0;
+  }
+  size_t readsize = MIN2(size, (size_t)(mem->length - (size_t)offset));
+
+  /* #BLI_mmap_read doesn't modify any state besides flagging I/O errors,
+   * so it can be used from multiple threads. */
+  if (!BLI_mmap_read(mem->mmap, buffer, (size_t)offset, readsize)) {
+    return 0;
+  }
+
+  return readsize;
+}
+
 static void memory_close_mmap(FileReader *reader)
 {
   MemoryReader *mem = (MemoryReader *)reader;
@@ -140,6 +173,7 @@ FileReader *BLI_filereader_new_mmap(int filedes)
   mem->reader.read = memory_read_mmap;
   mem->reader.seek = memory_seek;
   mem->reader.close = memory_close_mmap;
+  mem->reader.read_at = memory_read_at_mmap;
 
   return (FileReader *)mem;
 }
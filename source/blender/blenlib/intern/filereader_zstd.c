@@ -28,9 +28,31 @@
 #include "BLI_endian_switch.h"
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
+/**
+ * Number of decompressed frames that are kept around, so that going back and forth between
+ * a few locations in the file (as done when reading data-blocks on demand) doesn't keep
+ * decompressing the same frames. Frames are written with a size of 1 MB by `writefile.c`.
+ */
+#define ZSTD_CACHED_FRAMES_NUM 16
+/**
+ * Maximum number of frames decompressed at once (in parallel) when a frame isn't cached yet,
+ * anticipating that the following frames will be needed next.
+ */
+#define ZSTD_READAHEAD_FRAMES_MAX (ZSTD_CACHED_FRAMES_NUM / 2)
+
+typedef struct ZstdCachedFrame {
+  /** Index of the frame, -1 for unused slots. */
+  int frame;
+  char *content;
+  /** Value of #ZstdReader.seek.cache_clock when the frame was last used. */
+  uint64_t last_used;
+} ZstdCachedFrame;
+
 typedef struct {
   FileReader reader;
 
@@ -45,8 +67,9 @@ typedef struct {
     size_t *compressed_ofs;
     size_t *uncompressed_ofs;
 
-    char *cached_content;
-    int cached_frame;
+    ZstdCachedFrame cache[ZSTD_CACHED_FRAMES_NUM];
+    uint64_t cache_clock;
+    int readahead_frames;
   } seek;
 } ZstdReader;
 
@@ -142,7 +165,10 @@ static bool zstd_read_seek_table(ZstdReader *zstd)
     return false;
   }
 
-  zstd->seek.cached_frame = -1;
+  for (int i = 0; i < ZSTD_CACHED_FRAMES_NUM; i++) {
+    zstd->seek.cache[i].frame = -1;
+  }
+  zstd->seek.readahead_frames = clamp_i(BLI_system_thread_count(), 1, ZSTD_READAHEAD_FRAMES_MAX);
 
   return true;
 }
@@ -170,41 +196,142 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+static ZstdCachedFrame *zstd_cache_lookup(ZstdReader *zstd, int frame)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
+  for (int i = 0; i < ZSTD_CACHED_FRAMES_NUM; i++) {
+    if (zstd->seek.cache[i].frame == frame) {
+      return &zstd->seek.cache[i];
+    }
   }
+  return NULL;
+}
 
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
+/* Store a decompressed frame in the cache, replacing the least recently used one. */
+static ZstdCachedFrame *zstd_cache_insert(ZstdReader *zstd, int frame, char *content)
+{
+  ZstdCachedFrame *slot = &zstd->seek.cache[0];
+  for (int i = 1; i < ZSTD_CACHED_FRAMES_NUM; i++) {
+    if (zstd->seek.cache[i].last_used < slot->last_used) {
+      slot = &zstd->seek.cache[i];
+    }
+  }
+
+  MEM_SAFE_FREE(slot->content);
+  slot->frame = frame;
+  slot->content = content;
+  slot->last_used = ++zstd->seek.cache_clock;
+  return slot;
+}
+
+typedef struct ZstdDecompressData {
+  ZstdReader *zstd;
+  int first_frame;
+  const char *compressed_data;
+  /** Decompressed content of each frame, NULL on failure. */
+  char **contents;
+} ZstdDecompressData;
+
+static void zstd_decompress_frame_cb(void *__restrict userdata,
+                                     const int index,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ZstdDecompressData *data = userdata;
+  const ZstdReader *zstd = data->zstd;
+  const int frame = data->first_frame + index;
 
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
   size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
                              zstd->seek.uncompressed_ofs[frame];
+  size_t compressed_offset = zstd->seek.compressed_ofs[frame] -
+                             zstd->seek.compressed_ofs[data->first_frame];
+  const char *compressed_data = data->compressed_data + compressed_offset;
 
   char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
+  /* #ZSTD_decompress uses its own context, the reader's one can't be shared between threads. */
+  size_t res = ZSTD_decompress(
+      uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+  if (ZSTD_isError(res) || res < uncompressed_size) {
+    MEM_freeN(uncompressed_data);
+    uncompressed_data = NULL;
+  }
+  data->contents[index] = uncompressed_data;
+}
+
+/* Ensure that the given frame is loaded, decompressing it (and the frames following it) if it
+ * isn't cached yet. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  ZstdCachedFrame *cached = zstd_cache_lookup(zstd, frame);
+  if (cached != NULL) {
+    /* Cached frame matches, so just return it. */
+    cached->last_used = ++zstd->seek.cache_clock;
+    return cached->content;
+  }
+
+  /* Read ahead the following frames that aren't cached yet, they are stored next to each other
+   * in the file so they can be read at once and then decompressed in parallel. */
+  int frames_num = 1;
+  while (frames_num < zstd->seek.readahead_frames &&
+         frame + frames_num < zstd->seek.num_frames &&
+         zstd_cache_lookup(zstd, frame + frames_num) == NULL) {
+    frames_num++;
+  }
+
+  size_t compressed_size = zstd->seek.compressed_ofs[frame + frames_num] -
+                           zstd->seek.compressed_ofs[frame];
+
   char *compressed_data = MEM_mallocN(compressed_size, __func__);
   if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
       zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size) {
     MEM_freeN(compressed_data);
-    MEM_freeN(uncompressed_data);
     return NULL;
   }
 
-  size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+  char *contents_stack[ZSTD_READAHEAD_FRAMES_MAX];
+  ZstdDecompressData data = {
+      .zstd = zstd,
+      .first_frame = frame,
+      .compressed_data = compressed_data,
+      .contents = contents_stack,
+  };
+
+  if (frames_num == 1) {
+    /* Common case when reading backwards or going over cached frames,
+     * avoid the threading overhead and re-use the reader's context. */
+    size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
+                               zstd->seek.uncompressed_ofs[frame];
+    char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
+    size_t res = ZSTD_decompressDCtx(
+        zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+    if (ZSTD_isError(res) || res < uncompressed_size) {
+      MEM_freeN(uncompressed_data);
+      uncompressed_data = NULL;
+    }
+    contents_stack[0] = uncompressed_data;
+  }
+  else {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, frames_num, &data, zstd_decompress_frame_cb, &settings);
+  }
   MEM_freeN(compressed_data);
-  if (ZSTD_isError(res) || res < uncompressed_size) {
-    MEM_freeN(uncompressed_data);
+
+  if (contents_stack[0] == NULL) {
+    for (int i = 1; i < frames_num; i++) {
+      MEM_SAFE_FREE(contents_stack[i]);
+    }
     return NULL;
   }
 
-  zstd->seek.cached_frame = frame;
-  zstd->seek.cached_content = uncompressed_data;
-  return uncompressed_data;
+  /* Insert the read-ahead frames first, so the requested one is the most recently used. */
+  for (int i = frames_num - 1; i >= 0; i--) {
+    if (contents_stack[i] != NULL) {
+      cached = zstd_cache_insert(zstd, frame + i, contents_stack[i]);
+    }
+  }
+
+  return cached->content;
 }
 
 static ssize_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
@@ -297,7 +424,9 @@ static void zstd_close(FileReader *reader)
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
-    MEM_freeN(zstd->seek.cached_content);
+    for (int i = 0; i < ZSTD_CACHED_FRAMES_NUM; i++) {
+      MEM_SAFE_FREE(zstd->seek.cache[i].content);
+    }
   }
   else {
     MEM_freeN((void *)zstd->in_buf.src);
@@ -111,6 +111,10 @@ TEST_PARSE_FAIL(Truncated7, "1 and")
 TEST_PARSE_FAIL(Truncated8, "1 or")
 TEST_PARSE_FAIL(Truncated9, "sqrt(1")
 TEST_PARSE_FAIL(Truncated10, "fmod(1,")
+TEST_PARSE_FAIL(Truncated11, "2 **")
+TEST_PARSE_FAIL(Truncated12, "2 //")
+TEST_PARSE_FAIL(Truncated13, "2 %")
+TEST_PARSE_FAIL(BadPow, "2 ***3")
 
 /* Constant expression with working constant folding */
 #define TEST_CONST(name, str, value) \
@@ -145,6 +149,8 @@ TEST_CONST(Half, ".5", 0.5)
 TEST_CONST(Pi, "pi", M_PI)
 TEST_CONST(True, "True", TRUE_VAL)
 TEST_CONST(False, "False", FALSE_VAL)
+TEST_CONST(Tau, "tau", M_PI * 2.0)
+TEST_CONST(E, "e", M_E)
 
 TEST_CONST(Sqrt, "sqrt(4)", 2.0)
 TEST_EVAL(Sqrt, "sqrt(x)", 4.0, 2.0)
@@ -156,6 +162,19 @@ TEST_CONST(Pow, "pow(4, 0.5)", 2.0)
 TEST_EVAL(Pow, "pow(4, x)", 0.5, 2.0)
 
 TEST_CONST(Log2_1, "log(4, 2)", 2.0)
+TEST_CONST(Log2_2, "log2(8)", 3.0)
+TEST_CONST(Log10, "log10(100)", 2.0)
+
+TEST_CONST(Hypot, "hypot(3, 4)", 5.0)
+TEST_EVAL(Hypot, "hypot(x, 4)", 3.0, 5.0)
+
+TEST_CONST(CopySign, "copysign(2, -1)", -2.0)
+TEST_CONST(Tanh, "tanh(0)", 0.0)
+
+TEST_CONST(Float, "float(1)", 1.0)
+TEST_CONST(Bool1, "bool(2)", TRUE_VAL)
+TEST_CONST(Bool2, "bool(0)", FALSE_VAL)
+TEST_EVAL(Bool, "bool(x)", -0.5, TRUE_VAL)
 
 TEST_CONST(Round1, "round(-0.5)", -1.0)
 TEST_CONST(Round2, "round(-0.4)", 0.0)
@@ -212,6 +231,28 @@ TEST_CONST(Arith4, "3 * (-2 + 1)", -3.0)
 
 TEST_EVAL(Arith1, "1 + -x * 3", 2, -5.0)
 
+TEST_CONST(BinaryFloorDiv1, "7 // 2", 3.0)
+TEST_CONST(BinaryFloorDiv2, "-7 // 2", -4.0)
+TEST_CONST(BinaryFloorDiv3, "7 // -2", -4.0)
+TEST_CONST(BinaryFloorDiv4, "7.5 // 2", 3.0)
+TEST_EVAL(BinaryFloorDiv, "x // 2", -7, -4.0)
+
+TEST_CONST(BinaryMod1, "7 % 3", 1.0)
+TEST_CONST(BinaryMod2, "-7 % 3", 2.0)
+TEST_CONST(BinaryMod3, "7 % -3", -2.0)
+TEST_CONST(BinaryMod4, "7.5 % 2", 1.5)
+TEST_EVAL(BinaryMod, "x % 3", -7, 2.0)
+
+TEST_CONST(BinaryPow1, "2 ** 3", 8.0)
+TEST_CONST(BinaryPow2, "-2 ** 2", -4.0)
+TEST_CONST(BinaryPow3, "2 ** -1", 0.5)
+TEST_CONST(BinaryPow4, "2 ** 3 ** 2", 512.0)
+TEST_CONST(BinaryPow5, "(-2) ** 2", 4.0)
+TEST_CONST(BinaryPow6, "2 * 3 ** 2", 18.0)
+TEST_EVAL(BinaryPow, "x ** 2", 3, 9.0)
+
+TEST_CONST(Arith5, "7 // 2 * 2 + 7 % 2", 7.0)
+
 TEST_CONST(Eq1, "1 == 1.0", TRUE_VAL)
 TEST_CONST(Eq2, "1 == 2.0", FALSE_VAL)
 TEST_CONST(Eq3, "True == 1", TRUE_VAL)
@@ -338,6 +379,10 @@ TEST_ERROR(PowDomain1, "pow(-1, 0.5)", 0.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(PowDomain2, "pow(-1, x)", 0.5, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(PowDomain3, "pow(-1, x)", 2.0, EXPR_PYLIKE_SUCCESS)
 
+TEST_ERROR(ModZero, "x % 0", 1.0, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(FloorDivZero, "x // 0", 1.0, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(PowZero, "0 ** x", -1.0, EXPR_PYLIKE_DIV_BY_ZERO)
+
 TEST_ERROR(Mixed1, "sqrt(x) + 1 / max(0, x)", -1.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(Mixed2, "sqrt(x) + 1 / max(0, x)", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 TEST_ERROR(Mixed3, "sqrt(x) + 1 / max(0, x)", 1.0, EXPR_PYLIKE_SUCCESS)
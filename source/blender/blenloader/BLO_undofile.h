@@ -85,6 +85,13 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size);
+/**
+ * Add the chunks written for the given ID in the reference memfile to the written one,
+ * sharing their memory, instead of writing the ID again.
+ *
+ * \return false when the reference memfile has no chunks for that ID (nothing is added then).
+ */
+bool BLO_memfile_chunks_reuse_id(MemFileWriteData *mem_data, uint id_session_uuid);
 
 /* exports */
 
@@ -69,6 +69,7 @@
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "PIL_time.h"
@@ -181,6 +182,34 @@
  */
 #define USE_BHEAD_READ_ON_DEMAND
 
+/**
+ * Read and convert the data blocks of large data-blocks (meshes, images with packed data...)
+ * from multiple threads. Only used for file readers that support thread-safe random access
+ * (uncompressed files via `mmap`, memory buffers).
+ */
+#ifdef USE_BHEAD_READ_ON_DEMAND
+#  define USE_BHEAD_READ_PARALLEL
+/** Minimum amount of data in bytes of a single data-block to justify the threading overhead. */
+#  define BHEAD_READ_PARALLEL_MIN_SIZE (1 << 20)
+#endif
+
+/**
+ * Don't read the data of large blocks into the pointer map up-front, only read them when their
+ * address is first looked up (from the `direct_link` callbacks via #BLO_read_data_address).
+ * Blocks which end up not being used (skipped custom-data layers, deprecated data...) are then
+ * never read nor allocated, and arrays are allocated as late as possible, lowering peak memory.
+ *
+ * \note Reading the data of a data-block in parallel with #USE_BHEAD_READ_PARALLEL takes
+ * precedence, since deferred blocks are read one by one on the main thread. Only the blocks of
+ * data-blocks which are read sequentially (not enough data, or no random access to the file) are
+ * deferred.
+ */
+#ifdef USE_BHEAD_READ_ON_DEMAND
+#  define USE_BHEAD_READ_DEFERRED
+/** Minimum size in bytes of a block for its reading to be deferred. */
+#  define BHEAD_READ_DEFERRED_MIN_SIZE (1 << 12)
+#endif
+
 /* use GHash for BHead name-based lookups (speeds up linking) */
 #define USE_GHASH_BHEAD
 
@@ -214,6 +243,13 @@ typedef struct BHeadN {
  * because ID names are used in lookup tables. */
 #define BHEAD_USE_READ_ON_DEMAND(bhead) ((bhead)->code == DATA)
 
+#ifdef USE_BHEAD_READ_DEFERRED
+/* Only blocks which weren't read yet, otherwise there is nothing to gain. */
+#  define BHEAD_USE_READ_DEFERRED(bhead) \
+    (BHEADN_FROM_BHEAD(bhead)->has_data == false && \
+     (bhead)->len >= BHEAD_READ_DEFERRED_MIN_SIZE)
+#endif
+
 void BLO_reportf_wrap(BlendFileReadReport *reports, eReportType type, const char *format, ...)
 {
   char fixed_buf[1024]; /* should be long enough */
@@ -248,6 +284,11 @@ typedef struct OldNew {
   void *newp;
   /* `nr` is "user count" for data, and ID code for libdata. */
   int nr;
+  /**
+   * Block which hasn't been read yet, `newp` is NULL until the first lookup,
+   * see #USE_BHEAD_READ_DEFERRED.
+   */
+  BHead *bhead_deferred;
 } OldNew;
 
 typedef struct OldNewMap {
@@ -363,9 +404,31 @@ static void oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void *newaddr,
   entry.oldp = oldaddr;
   entry.newp = newaddr;
   entry.nr = nr;
+  entry.bhead_deferred = NULL;
   oldnewmap_insert_or_replace(onm, entry);
 }
 
+#ifdef USE_BHEAD_READ_DEFERRED
+/** Insert a block which is only read on the first lookup of its address. */
+static void oldnewmap_insert_deferred(OldNewMap *onm, const void *oldaddr, BHead *bhead)
+{
+  if (oldaddr == NULL) {
+    return;
+  }
+
+  if (UNLIKELY(onm->nentries == ENTRIES_CAPACITY(onm))) {
+    oldnewmap_increase_size(onm);
+  }
+
+  OldNew entry;
+  entry.oldp = oldaddr;
+  entry.newp = NULL;
+  entry.nr = 0;
+  entry.bhead_deferred = bhead;
+  oldnewmap_insert_or_replace(onm, entry);
+}
+#endif
+
 void blo_do_versions_oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void *newaddr, int nr)
 {
   oldnewmap_insert(onm, oldaddr, newaddr, nr);
@@ -405,7 +468,8 @@ static void oldnewmap_clear(OldNewMap *onm)
   /* Free unused data. */
   for (int i = 0; i < onm->nentries; i++) {
     OldNew *entry = &onm->entries[i];
-    if (entry->nr == 0) {
+    /* Deferred blocks that were never looked up have nothing to free. */
+    if (entry->nr == 0 && entry->newp != NULL) {
       MEM_freeN(entry->newp);
       entry->newp = NULL;
     }
@@ -956,6 +1020,14 @@ static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
   bool success = true;
   BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
   BLI_assert(new_bhead->has_data == false && new_bhead->file_offset != 0);
+  if (fd->file->read_at != NULL) {
+    /* Positional reads don't touch the file offset, this is also what allows
+     * #read_data_into_datamap to read blocks from multiple threads. */
+    return fd->file->read_at(fd->file,
+                             buf,
+                             (size_t)new_bhead->bhead.len,
+                             new_bhead->file_offset) == new_bhead->bhead.len;
+  }
   off64_t offset_backup = fd->file->offset;
   if (UNLIKELY(fd->file->seek(fd->file, new_bhead->file_offset, SEEK_SET) == -1)) {
     success = false;
@@ -1506,16 +1578,39 @@ BlendThumbnail *BLO_thumbnail_from_file(const char *filepath)
 /** \name Old/New Pointer Map
  * \{ */
 
+/* Only direct data-blocks. */
+static void *datamap_lookup(FileData *fd, const void *adr, bool increase_users)
+{
+#ifdef USE_BHEAD_READ_DEFERRED
+  OldNew *entry = oldnewmap_lookup_entry(fd->datamap, adr);
+  if (entry == NULL) {
+    return NULL;
+  }
+  if (entry->bhead_deferred != NULL) {
+    /* First access, read the block now. */
+    BHead *bhead = entry->bhead_deferred;
+    entry->bhead_deferred = NULL;
+    entry->newp = read_struct(fd, bhead, fd->datamap_allocname);
+  }
+  if (increase_users) {
+    entry->nr++;
+  }
+  return entry->newp;
+#else
+  return oldnewmap_lookup_and_inc(fd->datamap, adr, increase_users);
+#endif
+}
+
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  return datamap_lookup(fd, adr, true);
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  return datamap_lookup(fd, adr, false);
 }
 
 void *blo_read_get_new_globaldata_address(FileData *fd, const void *adr)
@@ -1530,7 +1625,7 @@ static void *newpackedadr(FileData *fd, const void *adr)
     return oldnewmap_lookup_and_inc(fd->packedmap, adr, true);
   }
 
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  return newdataadr(fd, adr);
 }
 
 /* only lib data */
@@ -1861,7 +1956,14 @@ static void switch_endian_structs(const struct SDNA *filesdna, BHead *bhead)
   }
 }
 
-static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
+/**
+ * Read and convert the data of a single block.
+ *
+ * \note Doesn't modify `fd`, read errors are returned in `r_read_error` instead,
+ * so this can run from multiple threads as long as `fd->file->read_at` is available
+ * (or the block data has been read already).
+ */
+static void *read_struct_ex(FileData *fd, BHead *bh, const char *blockname, bool *r_read_error)
 {
   void *temp = NULL;
 
@@ -1876,7 +1978,7 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
       if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
         bh = blo_bhead_read_full(fd, bh);
         if (UNLIKELY(bh == NULL)) {
-          fd->flags &= ~FD_FLAGS_FILE_OK;
+          *r_read_error = true;
           return NULL;
         }
       }
@@ -1890,7 +1992,7 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
         if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
           bh = blo_bhead_read_full(fd, bh);
           if (UNLIKELY(bh == NULL)) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
+            *r_read_error = true;
             return NULL;
           }
         }
@@ -1908,7 +2010,7 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
           /* Instead of allocating the bhead, then copying it,
            * read the data from the file directly into the memory. */
           if (UNLIKELY(!blo_bhead_read_data(fd, bh, temp))) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
+            *r_read_error = true;
             MEM_freeN(temp);
             temp = NULL;
           }
@@ -1929,6 +2031,16 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
   return temp;
 }
 
+static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
+{
+  bool read_error = false;
+  void *temp = read_struct_ex(fd, bh, blockname, &read_error);
+  if (UNLIKELY(read_error)) {
+    fd->flags &= ~FD_FLAGS_FILE_OK;
+  }
+  return temp;
+}
+
 /* Like read_struct, but gets a pointer without allocating. Only works for
  * undo since DNA must match. */
 static const void *peek_struct_undo(FileData *fd, BHead *bhead)
@@ -3052,9 +3164,118 @@ static bool direct_link_id(FileData *fd, Main *main, const int tag, ID *id, ID *
   return success;
 }
 
+#ifdef USE_BHEAD_READ_PARALLEL
+typedef struct ReadDataParallelData {
+  FileData *fd;
+  BHead **bheads;
+  void **datas;
+  const char *allocname;
+  bool read_error;
+} ReadDataParallelData;
+
+static void read_data_into_datamap_parallel_cb(void *__restrict userdata,
+                                               const int index,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ReadDataParallelData *data = userdata;
+  bool read_error = false;
+  data->datas[index] = read_struct_ex(data->fd, data->bheads[index], data->allocname, &read_error);
+  if (UNLIKELY(read_error)) {
+    /* Only ever set to true, so no need to synchronize. */
+    data->read_error = true;
+  }
+}
+
+/**
+ * Gather all data blocks of the current datablock, if there is enough data to read
+ * and the file supports random access from multiple threads, read and convert them in parallel.
+ * Large blocks are not deferred in that case (see #USE_BHEAD_READ_DEFERRED), reading them is
+ * what benefits from threading the most. The pointer map is still filled in file order afterwards.
+ *
+ * \return false when the blocks should be read one by one instead, in that case nothing was
+ * added to the pointer map and `r_bhead_end` is left untouched.
+ */
+static bool read_data_into_datamap_parallel(FileData *fd,
+                                            BHead *bhead,
+                                            const char *allocname,
+                                            BHead **r_bhead_end)
+{
+  if (fd->file->read_at == NULL) {
+    return false;
+  }
+
+  int bheads_len = 0;
+  int bheads_alloc = 16;
+  BHead **bheads = MEM_malloc_arrayN(bheads_alloc, sizeof(*bheads), __func__);
+  size_t data_size = 0;
+
+  bhead = blo_bhead_next(fd, bhead);
+  while (bhead && bhead->code == DATA) {
+    if (bheads_len == bheads_alloc) {
+      bheads_alloc *= 2;
+      bheads = MEM_reallocN(bheads, sizeof(*bheads) * bheads_alloc);
+    }
+    bheads[bheads_len++] = bhead;
+    data_size += (size_t)bhead->len;
+    bhead = blo_bhead_next(fd, bhead);
+  }
+
+  /* The blocks are now all scanned, so nothing is lost when falling back to reading them one by
+   * one, the loop in #read_data_into_datamap will only walk over the already loaded #BHeadN. */
+  if (bheads_len < 2 || data_size < BHEAD_READ_PARALLEL_MIN_SIZE) {
+    MEM_freeN(bheads);
+    return false;
+  }
+
+  ReadDataParallelData data = {
+      .fd = fd,
+      .bheads = bheads,
+      .datas = MEM_malloc_arrayN(bheads_len, sizeof(void *), __func__),
+      .allocname = allocname,
+      .read_error = false,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  /* Block sizes vary a lot (a few big arrays and many small structs), let the scheduler balance
+   * them instead of splitting the range in equal chunks. */
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, bheads_len, &data, read_data_into_datamap_parallel_cb, &settings);
+
+  if (UNLIKELY(data.read_error)) {
+    fd->flags &= ~FD_FLAGS_FILE_OK;
+  }
+
+  for (int i = 0; i < bheads_len; i++) {
+    if (data.datas[i]) {
+      oldnewmap_insert(fd->datamap, bheads[i]->old, data.datas[i], 0);
+    }
+  }
+
+  MEM_freeN(data.datas);
+  MEM_freeN(bheads);
+
+  *r_bhead_end = bhead;
+  return true;
+}
+#endif /* USE_BHEAD_READ_PARALLEL */
+
 /* Read all data associated with a datablock into datamap. */
 static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *allocname)
 {
+#ifdef USE_BHEAD_READ_DEFERRED
+  fd->datamap_allocname = allocname;
+#endif
+
+#ifdef USE_BHEAD_READ_PARALLEL
+  {
+    BHead *bhead_end;
+    if (read_data_into_datamap_parallel(fd, bhead, allocname, &bhead_end)) {
+      return bhead_end;
+    }
+  }
+#endif
+
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == DATA) {
@@ -3074,6 +3295,14 @@ static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *all
     }
 #endif
 
+#ifdef USE_BHEAD_READ_DEFERRED
+    if (BHEAD_USE_READ_DEFERRED(bhead)) {
+      oldnewmap_insert_deferred(fd->datamap, bhead->old, bhead);
+      bhead = blo_bhead_next(fd, bhead);
+      continue;
+    }
+#endif
+
     void *data = read_struct(fd, bhead, allocname);
     if (data) {
       oldnewmap_insert(fd->datamap, bhead->old, data, 0);
@@ -103,6 +103,8 @@ typedef struct FileData {
   int id_tag_extra;
 
   struct OldNewMap *datamap;
+  /** Allocation name for the blocks of #datamap which are only read on their first lookup. */
+  const char *datamap_allocname;
   struct OldNewMap *globmap;
   struct OldNewMap *libmap;
   struct OldNewMap *packedmap;
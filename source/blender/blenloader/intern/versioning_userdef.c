@@ -962,6 +962,13 @@ void blo_do_versions_userdef(UserDef *userdef)
     }
   }
 
+  if (!USER_VERSION_ATLEAST(302, 1)) {
+    if (userdef->file_compression_level == 0) {
+      userdef->file_compression_level = 3;
+    }
+    userdef->geometry_nodes_cache_limit = 256;
+  }
+
   /**
    * Versioning code until next subversion bump goes here.
    *
@@ -147,6 +147,7 @@
 #define ZSTD_BUFFER_SIZE (1 << 21) /* 2mb */
 #define ZSTD_CHUNK_SIZE (1 << 20)  /* 1mb */
 
+/** Used when the preferences don't define a level, see #UserDef.file_compression_level. */
 #define ZSTD_COMPRESSION_LEVEL 3
 
 /** Use if we want to store how many bytes have been written to the file. */
@@ -235,8 +236,7 @@ static void *zstd_write_task(void *userdata)
 
   size_t out_buf_len = ZSTD_compressBound(task->size);
   void *out_buf = MEM_mallocN(out_buf_len, "Zstd out buffer");
-  size_t out_size = ZSTD_compress(
-      out_buf, out_buf_len, task->data, task->size, ZSTD_COMPRESSION_LEVEL);
+  size_t out_size = ZSTD_compress(out_buf, out_buf_len, task->data, task->size, ww->zstd.level);
 
   MEM_freeN(task->data);
 
@@ -276,6 +276,8 @@ static bool ww_open_zstd(WriteWrap *ww, const char *filepath)
     return false;
   }
 
+  ww->zstd.level = U.file_compression_level ? U.file_compression_level : ZSTD_COMPRESSION_LEVEL;
+
   /* Leave one thread open for the main writing logic, unless we only have one HW thread. */
   int num_threads = max_ii(1, BLI_system_thread_count() - 1);
   BLI_threadpool_init(&ww->zstd.threadpool, zstd_write_task, num_threads);
@@ -659,6 +661,60 @@ static void mywrite_id_end(WriteData *wd, ID *UNUSED(id))
   }
 }
 
+/**
+ * Whether all changes to data-blocks of that type are expected to go through depsgraph tagging
+ * (RNA updates, operators...), so that #ID.recalc_after_undo_push reliably tells if they changed.
+ * Types like screens, texts or brushes are often edited without tagging.
+ */
+static bool mywrite_id_type_tags_all_changes(const short id_type)
+{
+  return ELEM(id_type,
+              ID_OB,
+              ID_ME,
+              ID_CU,
+              ID_MB,
+              ID_LT,
+              ID_AR,
+              ID_KE,
+              ID_MA,
+              ID_LA,
+              ID_CA,
+              ID_LP,
+              ID_GR,
+              ID_HA,
+              ID_PT,
+              ID_VO);
+}
+
+/**
+ * When storing an undo step, try to re-use the chunks the ID was written to in the previous
+ * undo step instead of writing it again, when it was not tagged as changed since then.
+ *
+ * \return true when the ID doesn't need to be written.
+ */
+static bool mywrite_id_reuse_unchanged(WriteData *wd, ID *id)
+{
+  if (!wd->use_memfile || !USER_EXPERIMENTAL_TEST(&U, use_undo_skip_unchanged_ids)) {
+    return false;
+  }
+  if (!mywrite_id_type_tags_all_changes(GS(id->name))) {
+    return false;
+  }
+  /* The value stored in the previous step must match what would be written now. */
+  if (id->recalc_after_undo_push != 0 || id->recalc_up_to_undo_push != 0) {
+    return false;
+  }
+  bNodeTree *nodetree = ntreeFromID(id);
+  if (nodetree != NULL &&
+      (nodetree->id.recalc_after_undo_push != 0 || nodetree->id.recalc_up_to_undo_push != 0)) {
+    return false;
+  }
+
+  /* Chunks can only be shared as a whole, make sure no data of the previous ID is pending. */
+  mywrite_flush(wd);
+  return BLO_memfile_chunks_reuse_id(&wd->mem, id->session_uuid);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -1162,6 +1218,10 @@ static bool write_file_handle(Main *mainvar,
           continue;
         }
 
+        if (mywrite_id_reuse_unchanged(wd, id)) {
+          continue;
+        }
+
         const bool do_override = !ELEM(override_storage, NULL, bmain) &&
                                  ID_IS_OVERRIDE_LIBRARY_REAL(id);
 
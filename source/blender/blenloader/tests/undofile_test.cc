@@ -0,0 +1,128 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "blendfile_loading_base_test.h"
+
+#include "BLI_listbase.h"
+#include "BLI_vector.hh"
+
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+
+#include "BLO_undofile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_userdef_types.h"
+
+using blender::Vector;
+
+/* Uses the base test for the initialization needed to write a Main database. */
+class MemfileUndoTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Mesh *mesh_unchanged = nullptr;
+  Mesh *mesh_changed = nullptr;
+  MemFile step_1 = {{nullptr}};
+  MemFile step_2 = {{nullptr}};
+  UserDef userdef_backup;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    userdef_backup = U;
+
+    bmain = BKE_main_new();
+    mesh_unchanged = static_cast<Mesh *>(BKE_id_new(bmain, ID_ME, "Unchanged"));
+    mesh_changed = static_cast<Mesh *>(BKE_id_new(bmain, ID_ME, "Changed"));
+  }
+
+  void TearDown() override
+  {
+    BLO_memfile_free(&step_2);
+    BLO_memfile_free(&step_1);
+    BKE_main_free(bmain);
+
+    U = userdef_backup;
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  void set_skip_unchanged_ids(const bool use_skip)
+  {
+    U.flag |= USER_DEVELOPER_UI;
+    U.experimental.use_undo_skip_unchanged_ids = use_skip;
+  }
+
+  /* Write two undo steps, modifying both meshes in between, but only tagging one of them. */
+  void write_undo_steps()
+  {
+    ASSERT_TRUE(BLO_write_file_mem(bmain, nullptr, &step_1, 0));
+
+    mesh_unchanged->smoothresh += 0.1f;
+    mesh_changed->smoothresh += 0.1f;
+    mesh_changed->id.recalc_after_undo_push |= ID_RECALC_GEOMETRY;
+
+    ASSERT_TRUE(BLO_write_file_mem(bmain, &step_1, &step_2, 0));
+  }
+
+  static Vector<const MemFileChunk *> id_chunks(const MemFile &memfile, const ID &id)
+  {
+    Vector<const MemFileChunk *> chunks;
+    LISTBASE_FOREACH (const MemFileChunk *, chunk, &memfile.chunks) {
+      if (chunk->id_session_uuid == id.session_uuid) {
+        chunks.append(chunk);
+      }
+    }
+    return chunks;
+  }
+
+  /* Whether all chunks of the ID in the second step share the memory of the first step. */
+  bool id_chunks_shared(const ID &id)
+  {
+    const Vector<const MemFileChunk *> chunks_1 = id_chunks(step_1, id);
+    const Vector<const MemFileChunk *> chunks_2 = id_chunks(step_2, id);
+    EXPECT_FALSE(chunks_1.is_empty());
+    if (chunks_1.size() != chunks_2.size()) {
+      return false;
+    }
+    for (const int i : chunks_1.index_range()) {
+      if (!chunks_2[i]->is_identical || chunks_2[i]->buf != chunks_1[i]->buf) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+TEST_F(MemfileUndoTest, SkipUnchangedIDs)
+{
+  set_skip_unchanged_ids(true);
+  write_undo_steps();
+
+  /* Chunks of the ID without recalc tags are taken over from the previous step, without being
+   * written again. So even its (untagged) modification is not stored. */
+  EXPECT_TRUE(id_chunks_shared(mesh_unchanged->id));
+  EXPECT_FALSE(id_chunks_shared(mesh_changed->id));
+}
+
+TEST_F(MemfileUndoTest, WriteAllIDs)
+{
+  set_skip_unchanged_ids(false);
+  write_undo_steps();
+
+  /* Without the option, both IDs are written and compared with the previous step. */
+  EXPECT_FALSE(id_chunks_shared(mesh_unchanged->id));
+  EXPECT_FALSE(id_chunks_shared(mesh_changed->id));
+}
@@ -110,6 +110,21 @@ void DEG_graph_replace_owners(struct Depsgraph *depsgraph,
 /** Free graph's contents and graph itself. */
 void DEG_graph_free(Depsgraph *graph);
 
+/**
+ * Create multiple independent Depsgraph instances for the same view layer, which are meant to be
+ * evaluated at different frames at the same time (see #DEG_graphs_evaluate_on_framechange).
+ *
+ * The graphs are to be built by the caller, and freed with #DEG_graphs_free.
+ */
+Depsgraph **DEG_graphs_new(struct Main *bmain,
+                           struct Scene *scene,
+                           struct ViewLayer *view_layer,
+                           eEvaluationMode mode,
+                           int num_graphs);
+
+/** Free graphs created with #DEG_graphs_new, and the array itself. */
+void DEG_graphs_free(Depsgraph **graphs, int num_graphs);
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -197,6 +212,17 @@ void DEG_ids_restore_recalc(Depsgraph *depsgraph);
  */
 void DEG_evaluate_on_framechange(Depsgraph *graph, float frame);
 
+/**
+ * Evaluate every graph at its own frame, with the graphs being evaluated at the same time.
+ *
+ * The graphs are to be independent and not active, so that the evaluation only reads original
+ * data. Relations of the graphs are updated first, one graph at a time.
+ *
+ * \note Unlike #BKE_scene_graph_update_for_newframe, frame change handlers are not run and the
+ * frame of the original scene is not changed.
+ */
+void DEG_graphs_evaluate_on_framechange(Depsgraph **graphs, const float *frames, int num_graphs);
+
 /**
  * Data changed recalculation entry point.
  * Evaluate all nodes tagged for updating.
@@ -281,6 +307,13 @@ void DEG_debug_print_eval_time(struct Depsgraph *depsgraph,
                                const void *object_address,
                                float time);
 
+/**
+ * Count a pose bone in the evaluation statistics of the depsgraph, see #DEG_stats_pose_bones.
+ * Only counted when depsgraph time debugging is enabled (`--debug-depsgraph-time`).
+ * \param reused: The matrices of the bone were kept from the previous evaluation.
+ */
+void DEG_debug_stats_pose_bone_evaluated(struct Depsgraph *depsgraph, bool reused);
+
 /** \} */
 
 #ifdef __cplusplus
@@ -83,6 +83,18 @@ void DEG_graph_relations_update(struct Depsgraph *graph);
 /** Tag all relations in the database for update. */
 void DEG_relations_tag_update(struct Main *bmain);
 
+/**
+ * Tag relations of the given ID for update, in the given graph.
+ *
+ * Is to be used when only the relations of the ID changed (for example, target of a modifier,
+ * a constraint or a driver variable), which allows to update relations of this ID only instead
+ * of rebuilding the whole graph.
+ */
+void DEG_graph_id_tag_relations_update(struct Depsgraph *graph, struct ID *id);
+
+/** Tag relations of the given ID for update, in all graphs of the database. */
+void DEG_id_tag_relations_update(struct Main *bmain, struct ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /**
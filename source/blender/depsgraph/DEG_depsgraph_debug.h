@@ -58,6 +58,13 @@ void DEG_stats_simple(const struct Depsgraph *graph,
                       size_t *r_operations,
                       size_t *r_relations);
 
+/**
+ * Obtain the number of pose bones which matrices were computed, and which matrices were reused
+ * from the previous evaluation, during the last evaluation of the depsgraph.
+ * The bones are only counted when depsgraph time debugging is enabled, otherwise zero.
+ */
+void DEG_stats_pose_bones(const struct Depsgraph *graph, int *r_evaluated, int *r_reused);
+
 /* ************************************************ */
 /* Diagram-Based Graph Debugging */
 
@@ -68,6 +75,18 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Timeline */
+
+/**
+ * Record the start and end time and the thread of every evaluated operation, and write them to
+ * the file in the Chrome trace event format. The trace can be viewed with `chrome://tracing` or
+ * Perfetto. The depsgraph module takes ownership of the file.
+ */
+void DEG_debug_trace_begin(FILE *fp);
+/** Finish the trace started with #DEG_debug_trace_begin and close its file. */
+void DEG_debug_trace_end(void);
+
 /* ************************************************ */
 
 /** Compare two dependency graphs. */
@@ -519,6 +519,10 @@ void DepsgraphNodeBuilder::tag_previously_tagged_nodes()
     /* Since the tag is coming from a saved copy of entry tags, this means
      * that originally node was explicitly tagged for user update. */
     op_node->tag_update(graph_, DEG_UPDATE_SOURCE_USER_EDIT);
+    /* The part of the data-block the copy-on-write was tagged for is not saved. */
+    if (comp_node->type == NodeType::COPY_ON_WRITE) {
+      id_node->copy_on_write_recalc |= ID_RECALC_COPY_ON_WRITE;
+    }
   }
 }
 
@@ -1086,6 +1090,9 @@ void DepsgraphNodeBuilder::build_animdata(ID *id)
   /* Make sure ID node exists. */
   (void)add_id_node(id);
   ID *id_cow = get_cow_id(id);
+  /* RNA paths resolved by the previous evaluation might point to data which is re-allocated
+   * without copy-on-write of the ID when relations are updated (pose rebuild, for example). */
+  BKE_animsys_eval_rna_cache_invalidate(id_cow);
   if (adt->action != nullptr || !BLI_listbase_is_empty(&adt->nla_tracks)) {
     OperationNode *operation_node;
     /* Explicit entry operation. */
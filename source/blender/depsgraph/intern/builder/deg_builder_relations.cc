@@ -247,7 +247,11 @@ bool object_have_geometry_component(const Object *object)
 DepsgraphRelationBuilder::DepsgraphRelationBuilder(Main *bmain,
                                                    Depsgraph *graph,
                                                    DepsgraphBuilderCache *cache)
-    : DepsgraphBuilder(bmain, graph, cache), scene_(nullptr), rna_node_query_(graph, this)
+    : DepsgraphBuilder(bmain, graph, cache),
+      scene_(nullptr),
+      check_existing_relations_(false),
+      has_missing_nodes_(false),
+      rna_node_query_(graph, this)
 {
 }
 
@@ -353,6 +357,9 @@ Relation *DepsgraphRelationBuilder::add_time_relation(TimeSourceNode *timesrc,
                                                       int flags)
 {
   if (timesrc && node_to) {
+    if (check_existing_relations_) {
+      flags |= RELATION_CHECK_BEFORE_ADD;
+    }
     return graph_->add_new_relation(timesrc, node_to, description, flags);
   }
 
@@ -381,6 +388,9 @@ Relation *DepsgraphRelationBuilder::add_operation_relation(OperationNode *node_f
                                                            int flags)
 {
   if (node_from && node_to) {
+    if (check_existing_relations_) {
+      flags |= RELATION_CHECK_BEFORE_ADD;
+    }
     return graph_->add_new_relation(node_from, node_to, description, flags);
   }
 
@@ -2991,20 +3001,34 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
     if (ELEM(comp_node->type, NodeType::PARAMETERS, NodeType::LAYER_COLLECTIONS)) {
       rel_flag &= ~RELATION_FLAG_NO_FLUSH;
     }
+    /* Relations of IDs which relations are not updated already exist when relations of an
+     * existing graph are updated. */
+    const int add_flag = check_existing_relations_ ? RELATION_CHECK_BEFORE_ADD : 0;
     /* All entry operations of each component should wait for a proper
      * copy of ID. */
     OperationNode *op_entry = comp_node->get_entry_operation();
     if (op_entry != nullptr) {
-      Relation *rel = graph_->add_new_relation(op_cow, op_entry, "CoW Dependency");
+      Relation *rel = graph_->add_new_relation(op_cow, op_entry, "CoW Dependency", add_flag);
       rel->flag |= rel_flag;
     }
-    /* All dangling operations should also be executed after copy-on-write. */
-    for (OperationNode *op_node : comp_node->operations_map->values()) {
+    /* All dangling operations should also be executed after copy-on-write.
+     *
+     * NOTE: Operations map is not available when relations are updated in a finalized graph. */
+    Vector<OperationNode *> operations_from_map;
+    if (comp_node->operations_map != nullptr) {
+      for (OperationNode *op_node : comp_node->operations_map->values()) {
+        operations_from_map.append(op_node);
+      }
+    }
+    const Span<OperationNode *> operations = (comp_node->operations_map != nullptr) ?
+                                                 operations_from_map.as_span() :
+                                                 comp_node->operations.as_span();
+    for (OperationNode *op_node : operations) {
       if (op_node == op_entry) {
         continue;
       }
       if (op_node->inlinks.is_empty()) {
-        Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency");
+        Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency", add_flag);
         rel->flag |= rel_flag;
       }
       else {
@@ -3020,7 +3044,7 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
           }
         }
         if (!has_same_comp_dependency) {
-          Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency");
+          Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency", add_flag);
           rel->flag |= rel_flag;
         }
       }
@@ -364,6 +364,17 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   template<typename KeyFrom, typename KeyTo>
   bool is_same_nodetree_node_dependency(const KeyFrom &key_from, const KeyTo &key_to);
 
+  /* State which demotes currently built entities. */
+  Scene *scene_;
+
+  BuilderMap built_map_;
+
+  /* Relations are added to a graph which already has some of them, so relations are only added
+   * when there is no such relation yet. */
+  bool check_existing_relations_;
+  /* Set when relation could not be added because one of its nodes does not exist. */
+  bool has_missing_nodes_;
+
  private:
   struct BuilderWalkUserData {
     DepsgraphRelationBuilder *builder;
@@ -376,10 +387,6 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   static void constraint_walk(bConstraint *con, ID **idpoin, bool is_reference, void *user_data);
 
-  /* State which demotes currently built entities. */
-  Scene *scene_;
-
-  BuilderMap built_map_;
   RNANodeQuery rna_node_query_;
 };
 
@@ -53,6 +53,7 @@ Relation *DepsgraphRelationBuilder::add_relation(const KeyFrom &key_from,
     return add_operation_relation(op_from, op_to, description, flags);
   }
   else {
+    has_missing_nodes_ = true;
     if (!op_from) {
       /* XXX TODO: handle as error or report if needed. */
       fprintf(stderr,
@@ -111,6 +112,7 @@ Relation *DepsgraphRelationBuilder::add_node_handle_relation(const KeyType &key_
     return add_operation_relation(op_from, op_to, description, flags);
   }
   else {
+    has_missing_nodes_ = true;
     if (!op_from) {
       fprintf(stderr,
               "add_node_handle_relation(%s) - Could not find op_from (%s)\n",
@@ -42,17 +42,38 @@ AbstractBuilderPipeline::AbstractBuilderPipeline(::Depsgraph *graph)
 
 void AbstractBuilderPipeline::build()
 {
+  const bool do_time = (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) != 0;
+  /* Per-step timings are only interesting when profiling the graph construction. */
+  const bool do_time_steps = (G.debug & G_DEBUG_DEPSGRAPH_TIME) != 0;
+
   double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+  if (do_time) {
     start_time = PIL_check_seconds_timer();
   }
 
   build_step_sanity_check();
+
+  double step_start_time = start_time;
   build_step_nodes();
+  if (do_time_steps) {
+    const double time = PIL_check_seconds_timer();
+    printf("Depsgraph nodes built in %f seconds.\n", time - step_start_time);
+    step_start_time = time;
+  }
+
   build_step_relations();
+  if (do_time_steps) {
+    const double time = PIL_check_seconds_timer();
+    printf("Depsgraph relations built in %f seconds.\n", time - step_start_time);
+    step_start_time = time;
+  }
+
   build_step_finalize();
+  if (do_time_steps) {
+    printf("Depsgraph finalized in %f seconds.\n", PIL_check_seconds_timer() - step_start_time);
+  }
 
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+  if (do_time) {
     printf("Depsgraph built in %f seconds.\n", PIL_check_seconds_timer() - start_time);
   }
 }
@@ -107,6 +128,7 @@ void AbstractBuilderPipeline::build_step_finalize()
 #endif
   /* Relations are up to date. */
   deg_graph_->need_update = false;
+  deg_graph_->relations_update_ids.clear();
 }
 
 unique_ptr<DepsgraphNodeBuilder> AbstractBuilderPipeline::construct_node_builder()
@@ -0,0 +1,396 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+#include "pipeline_relations_update.h"
+
+#include "PIL_time.h"
+
+#include "BLI_listbase.h"
+
+#include "BKE_global.h"
+
+#include "DNA_collection_types.h"
+#include "DNA_layer_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+
+#include "intern/builder/deg_builder.h"
+#include "intern/builder/deg_builder_cycle.h"
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/builder/deg_builder_transitive.h"
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+#include "intern/node/deg_node_time.h"
+
+namespace blender::deg {
+
+namespace {
+
+/* Node builder which only builds nodes of the updated IDs, treating all other IDs of the existing
+ * graph as already built. */
+class RelationsUpdateNodeBuilder : public DepsgraphNodeBuilder {
+ public:
+  RelationsUpdateNodeBuilder(Main *bmain,
+                             Depsgraph *graph,
+                             DepsgraphBuilderCache *cache,
+                             const Depsgraph *existing_graph,
+                             const Set<ID *> &ids)
+      : DepsgraphNodeBuilder(bmain, graph, cache)
+  {
+    scene_ = existing_graph->scene;
+    view_layer_ = existing_graph->view_layer;
+    /* NOTE: Pass view layer index of 0 since after scene CoW there is
+     * only one view layer in there. */
+    view_layer_index_ = 0;
+    for (const IDNode *id_node : existing_graph->id_nodes) {
+      if (!ids.contains(id_node->id_orig)) {
+        built_map_.tagBuild(id_node->id_orig);
+      }
+    }
+  }
+
+  void build_updated_id(const IDNode *id_node)
+  {
+    ID *id = id_node->id_orig;
+    if (GS(id->name) == ID_OB) {
+      Object *object = (Object *)id;
+      DepsgraphNodeBuilder::build_object(
+          find_base_index(object), object, id_node->linked_state, id_node->is_directly_visible);
+    }
+    else {
+      build_id(id);
+    }
+  }
+
+  /* The IDs which are tagged as built do not have nodes in this graph, so avoid the code paths
+   * which accumulate flags of already built IDs. */
+  void build_object(int base_index,
+                    Object *object,
+                    eDepsNode_LinkedState_Type linked_state,
+                    bool is_visible) override
+  {
+    if (built_map_.checkIsBuilt(object)) {
+      return;
+    }
+    DepsgraphNodeBuilder::build_object(base_index, object, linked_state, is_visible);
+  }
+
+  void build_collection(LayerCollection *from_layer_collection, Collection *collection) override
+  {
+    if (built_map_.checkIsBuilt(collection)) {
+      return;
+    }
+    DepsgraphNodeBuilder::build_collection(from_layer_collection, collection);
+  }
+
+ protected:
+  /* Base index of the object, matching the indexing used by build_view_layer(). */
+  int find_base_index(const Object *object)
+  {
+    int base_index = 0;
+    LISTBASE_FOREACH (Base *, base, &view_layer_->object_bases) {
+      if (need_pull_base_into_graph(base)) {
+        if (base->object == object) {
+          return base_index;
+        }
+        base_index++;
+      }
+    }
+    return -1;
+  }
+};
+
+/* Relation builder which only builds relations of the given IDs, adding relations which do not
+ * exist in the graph yet. */
+class RelationsUpdateRelationBuilder : public DepsgraphRelationBuilder {
+ public:
+  RelationsUpdateRelationBuilder(Main *bmain,
+                                 Depsgraph *graph,
+                                 DepsgraphBuilderCache *cache,
+                                 const VectorSet<ID *> &ids)
+      : DepsgraphRelationBuilder(bmain, graph, cache)
+  {
+    scene_ = graph->scene;
+    check_existing_relations_ = true;
+    for (const IDNode *id_node : graph->id_nodes) {
+      if (!ids.contains(id_node->id_orig)) {
+        built_map_.tagBuild(id_node->id_orig);
+      }
+    }
+  }
+
+  bool has_missing_nodes() const
+  {
+    return has_missing_nodes_;
+  }
+};
+
+/* Check that all nodes of the graph built for the updated IDs exist in the existing graph, and
+ * that the updated IDs have no other nodes there. */
+bool check_nodes_match(const Depsgraph *graph,
+                       const Depsgraph *existing_graph,
+                       const Set<ID *> &ids)
+{
+  for (const IDNode *id_node : graph->id_nodes) {
+    const IDNode *existing_id_node = existing_graph->find_id_node(id_node->id_orig);
+    if (existing_id_node == nullptr) {
+      return false;
+    }
+    /* Other IDs might only have some of their nodes in the graph, for example the ones which were
+     * requested by driver variables. */
+    const bool is_updated_id = ids.contains(id_node->id_orig);
+    if (is_updated_id && id_node->components.size() != existing_id_node->components.size()) {
+      return false;
+    }
+    for (const ComponentNode *comp_node : id_node->components.values()) {
+      const ComponentNode *existing_comp_node = existing_id_node->find_component(
+          comp_node->type, comp_node->name.c_str());
+      if (existing_comp_node == nullptr) {
+        return false;
+      }
+      /* The graph is not finalized, so operations are only available in the map. */
+      if (is_updated_id &&
+          comp_node->operations_map->size() != existing_comp_node->operations.size()) {
+        return false;
+      }
+      for (const OperationNode *op_node : comp_node->operations_map->values()) {
+        if (!existing_comp_node->has_operation(
+                op_node->opcode, op_node->name.c_str(), op_node->name_tag)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+string relation_identifier(const Relation *rel)
+{
+  const string from = (rel->from->type == NodeType::OPERATION) ?
+                          ((OperationNode *)rel->from)->full_identifier() :
+                          rel->from->identifier();
+  const string to = ((OperationNode *)rel->to)->full_identifier();
+  return from + " -> " + to + " (" + rel->name + ")";
+}
+
+}  // namespace
+
+Set<string> deg_graph_relation_identifiers(const Depsgraph *graph)
+{
+  Set<string> identifiers;
+  for (const OperationNode *op_node : graph->operations) {
+    for (const Relation *rel : op_node->inlinks) {
+      identifiers.add(relation_identifier(rel));
+    }
+  }
+  return identifiers;
+}
+
+RelationsUpdateBuilderPipeline::RelationsUpdateBuilderPipeline(::Depsgraph *graph,
+                                                               Span<ID *> ids)
+    : deg_graph_(reinterpret_cast<Depsgraph *>(graph)),
+      bmain_(deg_graph_->bmain),
+      scene_(deg_graph_->scene),
+      view_layer_(deg_graph_->view_layer)
+{
+  ids_.add_multiple(ids);
+}
+
+bool RelationsUpdateBuilderPipeline::build()
+{
+  double start_time = 0.0;
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    start_time = PIL_check_seconds_timer();
+  }
+
+  if (!build_step_sanity_check() || !build_step_check_nodes()) {
+    return false;
+  }
+  build_step_remove_relations();
+  if (!build_step_relations()) {
+    return false;
+  }
+  build_step_finalize();
+
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    printf("Depsgraph relations of %d IDs updated in %f seconds.\n",
+           int(ids_.size()),
+           PIL_check_seconds_timer() - start_time);
+  }
+  return true;
+}
+
+bool RelationsUpdateBuilderPipeline::build_step_sanity_check()
+{
+  BLI_assert(deg_graph_->scene == scene_);
+  BLI_assert(deg_graph_->view_layer == view_layer_);
+  for (ID *id : ids_) {
+    /* Scene relations depend on the whole view layer, and objects from the set scenes are built
+     * in a different context. */
+    if (GS(id->name) == ID_SCE) {
+      return false;
+    }
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    if (id_node == nullptr || id_node->linked_state == DEG_ID_LINKED_VIA_SET) {
+      return false;
+    }
+    id_nodes_.append(id_node);
+  }
+  return true;
+}
+
+bool RelationsUpdateBuilderPipeline::build_step_check_nodes()
+{
+  /* Relations can be updated in place only if the IDs still have the same operations. Build the
+   * nodes of the IDs into a temporary graph, and compare them with the existing ones. */
+  Depsgraph graph(bmain_, scene_, view_layer_, deg_graph_->mode);
+  RelationsUpdateNodeBuilder node_builder(bmain_, &graph, &builder_cache_, deg_graph_, ids_);
+  for (const IDNode *id_node : id_nodes_) {
+    node_builder.build_updated_id(id_node);
+  }
+  return check_nodes_match(&graph, deg_graph_, ids_);
+}
+
+void RelationsUpdateBuilderPipeline::build_step_remove_relations()
+{
+  /* All relations of the operations of the IDs are removed. They are built again by the builders
+   * of the IDs themselves, and by the builders of the IDs on the other side of the relations. */
+  for (ID *id : ids_) {
+    rebuild_ids_.add(id);
+  }
+  for (IDNode *id_node : id_nodes_) {
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->inlinks) {
+          if (rel->from->type == NodeType::OPERATION) {
+            const OperationNode *op_from = (const OperationNode *)rel->from;
+            rebuild_ids_.add(op_from->owner->owner->id_orig);
+          }
+        }
+        for (Relation *rel : op_node->outlinks) {
+          if (rel->to->type == NodeType::OPERATION) {
+            const OperationNode *op_to = (const OperationNode *)rel->to;
+            rebuild_ids_.add(op_to->owner->owner->id_orig);
+          }
+        }
+        while (!op_node->inlinks.is_empty()) {
+          Relation *rel = op_node->inlinks[0];
+          rel->unlink();
+          delete rel;
+        }
+        while (!op_node->outlinks.is_empty()) {
+          Relation *rel = op_node->outlinks[0];
+          rel->unlink();
+          delete rel;
+        }
+      }
+    }
+  }
+  /* Cycles are detected again for the whole graph. */
+  for (OperationNode *op_node : deg_graph_->operations) {
+    for (Relation *rel : op_node->inlinks) {
+      rel->flag &= ~RELATION_FLAG_CYCLIC;
+    }
+  }
+}
+
+bool RelationsUpdateBuilderPipeline::build_step_relations()
+{
+  /* Flags and masks are accumulated on top of the existing ones, changes of them are detected
+   * in the same way as when the graph is built from scratch. */
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+  }
+  RelationsUpdateRelationBuilder relation_builder(
+      bmain_, deg_graph_, &builder_cache_, rebuild_ids_);
+  for (ID *id : rebuild_ids_) {
+    if (id == &scene_->id) {
+      relation_builder.build_view_layer(scene_, view_layer_, DEG_ID_LINKED_DIRECTLY);
+    }
+    else {
+      relation_builder.build_id(id);
+    }
+  }
+  /* Copy-on-write relations between IDs are built by the ID which depends on the other one. */
+  for (ID *id : rebuild_ids_) {
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    if (id_node != nullptr) {
+      relation_builder.build_copy_on_write_relations(id_node);
+    }
+  }
+  for (IDNode *id_node : id_nodes_) {
+    relation_builder.build_driver_relations(id_node);
+  }
+  return !relation_builder.has_missing_nodes();
+}
+
+void RelationsUpdateBuilderPipeline::build_step_finalize()
+{
+  /* Detect and solve cycles. */
+  deg_graph_detect_cycles(deg_graph_);
+  if (G.debug_value == 799) {
+    deg_graph_transitive_reduction(deg_graph_);
+  }
+  /* Flush visibility layer and re-schedule nodes for update. */
+  deg_graph_build_finalize(bmain_, deg_graph_);
+  DEG_graph_tag_on_visible_update(reinterpret_cast<::Depsgraph *>(deg_graph_), false);
+  /* Relations are up to date. */
+  deg_graph_->need_update = false;
+  deg_graph_->relations_update_ids.clear();
+}
+
+void RelationsUpdateBuilderPipeline::verify()
+{
+  ::Depsgraph *graph = DEG_graph_new(bmain_, scene_, view_layer_, deg_graph_->mode);
+  DEG_graph_build_from_view_layer(graph);
+
+  const Set<string> expected_relations = deg_graph_relation_identifiers(
+      reinterpret_cast<Depsgraph *>(graph));
+  const Set<string> relations = deg_graph_relation_identifiers(deg_graph_);
+
+  int num_missing = 0;
+  for (const string &identifier : expected_relations) {
+    if (!relations.contains(identifier)) {
+      printf("Depsgraph relations update is missing relation: %s\n", identifier.c_str());
+      num_missing++;
+    }
+  }
+  int num_extra = 0;
+  for (const string &identifier : relations) {
+    if (!expected_relations.contains(identifier)) {
+      printf("Depsgraph relations update has extra relation: %s\n", identifier.c_str());
+      num_extra++;
+    }
+  }
+  printf("Depsgraph relations update verified: %d missing, %d extra relations.\n",
+         num_missing,
+         num_extra);
+
+  DEG_graph_free(graph);
+}
+
+}  // namespace blender::deg
@@ -0,0 +1,91 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include "deg_builder_cache.h"
+
+#include "intern/depsgraph_type.h"
+
+struct Depsgraph;
+struct ID;
+struct Main;
+struct Scene;
+struct ViewLayer;
+
+namespace blender {
+namespace deg {
+
+struct Depsgraph;
+struct IDNode;
+
+/* Pipeline which updates relations of the given IDs in an already built dependency graph, keeping
+ * the rest of the graph as-is.
+ *
+ * General notes:
+ *
+ * - Update is only possible when the set of operations of the IDs did not change. This is checked
+ *   by building nodes of the IDs into a temporary graph and comparing them with the existing ones.
+ *
+ * - All relations of the operations of the IDs are removed, and built again by the builders of
+ *   the IDs and by the builders of the IDs on the other side of those relations. The builders of
+ *   all other IDs are not invoked, and relations which already exist are not added again.
+ *
+ * - When the update is not possible build() returns false, and the graph is to be built from
+ *   scratch. The graph might have been modified at that point. */
+class RelationsUpdateBuilderPipeline {
+ public:
+  RelationsUpdateBuilderPipeline(::Depsgraph *graph, Span<ID *> ids);
+
+  bool build();
+
+  /* Compare relations of the graph with the ones from a graph built from scratch, and report the
+   * difference. */
+  void verify();
+
+ protected:
+  Depsgraph *deg_graph_;
+  Main *bmain_;
+  Scene *scene_;
+  ViewLayer *view_layer_;
+  DepsgraphBuilderCache builder_cache_;
+
+  /* IDs which relations are being updated. */
+  Set<ID *> ids_;
+  Vector<IDNode *> id_nodes_;
+  /* IDs which relations are to be built again: the updated IDs and the IDs they had relations
+   * with. */
+  VectorSet<ID *> rebuild_ids_;
+
+  bool build_step_sanity_check();
+  bool build_step_check_nodes();
+  void build_step_remove_relations();
+  bool build_step_relations();
+  void build_step_finalize();
+};
+
+/* Identifiers of all relations of the graph, to compare relations of different graphs. */
+Set<string> deg_graph_relation_identifiers(const Depsgraph *graph);
+
+}  // namespace deg
+}  // namespace blender
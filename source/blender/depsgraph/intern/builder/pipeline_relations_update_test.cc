@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/builder/pipeline_relations_update.h"
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_action.h"
+#include "BKE_anim_data.h"
+#include "BKE_collection.h"
+#include "BKE_fcurve.h"
+#include "BKE_layer.h"
+#include "BKE_main.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+
+#include "intern/depsgraph.h"
+
+namespace blender::deg::tests {
+
+class RelationsUpdateTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  ViewLayer *view_layer = nullptr;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    view_layer = BKE_view_layer_default_view(scene);
+  }
+
+  void TearDown() override
+  {
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_main_free(bmain);
+  }
+
+  Object *object_add(const int type, const char *name)
+  {
+    Object *object = BKE_object_add_only_object(bmain, type, name);
+    object->data = BKE_object_obdata_add_from_type(bmain, type, name);
+    BKE_collection_object_add(bmain, scene->master_collection, object);
+    BKE_main_collection_sync(bmain);
+    return object;
+  }
+
+  FCurve *fcurve_add(ID *id, const char *rna_path)
+  {
+    AnimData *adt = BKE_animdata_ensure_id(id);
+    if (adt->action == nullptr) {
+      adt->action = BKE_action_add(bmain, "Action");
+    }
+    FCurve *fcu = BKE_fcurve_create();
+    fcu->rna_path = BLI_strdup(rna_path);
+    BLI_addtail(&adt->action->curves, fcu);
+    return fcu;
+  }
+
+  static void fcurve_path_set(FCurve *fcu, const char *rna_path)
+  {
+    MEM_freeN(fcu->rna_path);
+    fcu->rna_path = BLI_strdup(rna_path);
+  }
+
+  ::Depsgraph *graph_build()
+  {
+    ::Depsgraph *graph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_VIEWPORT);
+    DEG_graph_build_from_view_layer(graph);
+    return graph;
+  }
+
+  /* Update relations of the given IDs in the graph, and compare them with the relations of a graph
+   * built from scratch. */
+  void expect_relations_update_matches_build(::Depsgraph *graph, Span<ID *> ids)
+  {
+    RelationsUpdateBuilderPipeline builder(graph, ids);
+    EXPECT_TRUE(builder.build());
+
+    ::Depsgraph *expected_graph = graph_build();
+    const Set<std::string> expected_relations = deg_graph_relation_identifiers(
+        reinterpret_cast<Depsgraph *>(expected_graph));
+    const Set<std::string> relations = deg_graph_relation_identifiers(
+        reinterpret_cast<Depsgraph *>(graph));
+    for (const std::string &identifier : expected_relations) {
+      EXPECT_TRUE(relations.contains(identifier)) << "Missing relation " << identifier;
+    }
+    for (const std::string &identifier : relations) {
+      EXPECT_TRUE(expected_relations.contains(identifier)) << "Extra relation " << identifier;
+    }
+    DEG_graph_free(expected_graph);
+  }
+};
+
+TEST_F(RelationsUpdateTest, unchanged)
+{
+  Object *object = object_add(OB_CAMERA, "Camera");
+  fcurve_add(&object->id, "location");
+
+  ::Depsgraph *graph = graph_build();
+  expect_relations_update_matches_build(graph, {&object->id});
+  DEG_graph_free(graph);
+}
+
+/* Relation of the object animation to the camera data goes out of the object, and is to be
+ * removed when the object relations are updated. */
+TEST_F(RelationsUpdateTest, outgoing_relation_removed)
+{
+  Object *object = object_add(OB_CAMERA, "Camera");
+  FCurve *fcu = fcurve_add(&object->id, "data.lens");
+
+  ::Depsgraph *graph = graph_build();
+  fcurve_path_set(fcu, "location");
+  expect_relations_update_matches_build(graph, {&object->id});
+  DEG_graph_free(graph);
+}
+
+TEST_F(RelationsUpdateTest, outgoing_relation_added)
+{
+  Object *object = object_add(OB_CAMERA, "Camera");
+  FCurve *fcu = fcurve_add(&object->id, "location");
+
+  ::Depsgraph *graph = graph_build();
+  fcurve_path_set(fcu, "data.lens");
+  expect_relations_update_matches_build(graph, {&object->id});
+  DEG_graph_free(graph);
+}
+
+/* Relation of the object animation to the camera data comes into the camera data, and is to be
+ * built again by the object when the camera data relations are updated. */
+TEST_F(RelationsUpdateTest, incoming_relation_kept)
+{
+  Object *object = object_add(OB_CAMERA, "Camera");
+  fcurve_add(&object->id, "data.lens");
+
+  ::Depsgraph *graph = graph_build();
+  expect_relations_update_matches_build(graph, {static_cast<ID *>(object->data)});
+  DEG_graph_free(graph);
+}
+
+}  // namespace blender::deg::tests
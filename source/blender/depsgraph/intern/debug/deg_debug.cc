@@ -37,6 +37,8 @@ namespace blender::deg {
 DepsgraphDebug::DepsgraphDebug()
     : flags(G.debug), is_ever_evaluated(false), graph_evaluation_start_time_(0)
 {
+  stats.pose_bones_evaluated = 0;
+  stats.pose_bones_reused = 0;
 }
 
 bool DepsgraphDebug::do_time_debug() const
@@ -46,6 +48,9 @@ bool DepsgraphDebug::do_time_debug() const
 
 void DepsgraphDebug::begin_graph_evaluation()
 {
+  stats.pose_bones_evaluated = 0;
+  stats.pose_bones_reused = 0;
+
   if (!do_time_debug()) {
     return;
   }
@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "intern/debug/deg_time_average.h"
 #include "intern/depsgraph_type.h"
 
@@ -53,6 +55,14 @@ class DepsgraphDebug {
    * This is NOT an indication that depsgraph is at its evaluated state. */
   bool is_ever_evaluated;
 
+  /* Statistics of the last evaluation of the graph, reset in begin_graph_evaluation(). */
+  struct {
+    /* Number of pose bones which matrices were computed. */
+    std::atomic<int> pose_bones_evaluated;
+    /* Number of pose bones which matrices were reused from the previous evaluation. */
+    std::atomic<int> pose_bones_reused;
+  } stats;
+
  protected:
   /* Maximum number of counters used to calculate frame rate of depsgraph update. */
   static const constexpr int MAX_FPS_COUNTERS = 64;
@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <mutex>
+#include <string>
+
+#include "DEG_depsgraph_debug.h"
+
+#include "intern/depsgraph.h"
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace deg = blender::deg;
+
+namespace blender::deg {
+
+namespace {
+
+struct DepsgraphTrace {
+  std::mutex mutex;
+  FILE *file = nullptr;
+  bool is_first_event = true;
+};
+
+DepsgraphTrace &get_trace()
+{
+  static DepsgraphTrace trace;
+  return trace;
+}
+
+/** Escape a string so that it can be used as value in JSON. */
+std::string json_escape(const std::string &str)
+{
+  std::string result;
+  result.reserve(str.size());
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          /* Control characters are not expected in names, skip them. */
+          break;
+        }
+        result += c;
+        break;
+    }
+  }
+  return result;
+}
+
+void trace_write_event(DepsgraphTrace &trace,
+                       const std::string &name,
+                       const std::string &category,
+                       const std::string &graph_name,
+                       const int thread_index,
+                       const double start_time,
+                       const double end_time)
+{
+  /* Timestamps and durations are in microseconds. */
+  fprintf(trace.file,
+          "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+          "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depsgraph\":\"%s\"}}",
+          trace.is_first_event ? "\n" : ",\n",
+          json_escape(name).c_str(),
+          category.c_str(),
+          thread_index,
+          start_time * 1e6,
+          (end_time - start_time) * 1e6,
+          json_escape(graph_name).c_str());
+  trace.is_first_event = false;
+}
+
+}  // namespace
+
+bool deg_debug_trace_is_active()
+{
+  DepsgraphTrace &trace = get_trace();
+  std::lock_guard lock{trace.mutex};
+  return trace.file != nullptr;
+}
+
+int deg_debug_trace_thread_index()
+{
+  return threading::enumerable_thread_specific_utils::thread_id;
+}
+
+void deg_debug_trace_write(const Depsgraph *graph,
+                           DepsgraphTraceEvents &events,
+                           const double start_time,
+                           const double end_time)
+{
+  DepsgraphTrace &trace = get_trace();
+  /* Multiple dependency graphs can be evaluated at the same time. */
+  std::lock_guard lock{trace.mutex};
+  if (trace.file == nullptr) {
+    return;
+  }
+  const std::string &graph_name = graph->debug.name;
+  trace_write_event(trace,
+                    "Depsgraph Evaluation",
+                    "depsgraph",
+                    graph_name,
+                    deg_debug_trace_thread_index(),
+                    start_time,
+                    end_time);
+  for (Vector<DepsgraphTraceEvent> &thread_events : events) {
+    for (const DepsgraphTraceEvent &event : thread_events) {
+      const OperationNode *operation_node = event.operation_node;
+      trace_write_event(trace,
+                        operation_node->full_identifier(),
+                        nodeTypeAsString(operation_node->owner->type),
+                        graph_name,
+                        event.thread_index,
+                        event.start_time,
+                        event.end_time);
+    }
+  }
+  fflush(trace.file);
+}
+
+}  // namespace blender::deg
+
+void DEG_debug_trace_begin(FILE *fp)
+{
+  deg::DepsgraphTrace &trace = deg::get_trace();
+  DEG_debug_trace_end();
+  std::lock_guard lock{trace.mutex};
+  trace.file = fp;
+  trace.is_first_event = true;
+  fputs("[", trace.file);
+}
+
+void DEG_debug_trace_end()
+{
+  deg::DepsgraphTrace &trace = deg::get_trace();
+  std::lock_guard lock{trace.mutex};
+  if (trace.file == nullptr) {
+    return;
+  }
+  fputs("\n]\n", trace.file);
+  fclose(trace.file);
+  trace.file = nullptr;
+}
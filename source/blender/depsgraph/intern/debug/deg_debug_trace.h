@@ -0,0 +1,62 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Timeline of evaluated operations in the Chrome trace event format.
+ */
+
+#pragma once
+
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_vector.hh"
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/** Evaluation of a single operation, times are in seconds (see #PIL_check_seconds_timer). */
+struct DepsgraphTraceEvent {
+  const OperationNode *operation_node;
+  int thread_index;
+  double start_time;
+  double end_time;
+};
+
+/** Events are collected per thread during evaluation to avoid synchronization. */
+using DepsgraphTraceEvents = threading::EnumerableThreadSpecific<Vector<DepsgraphTraceEvent>>;
+
+/** True when a trace was started with #DEG_debug_trace_begin. */
+bool deg_debug_trace_is_active();
+
+/** Index of the calling thread, used to group the events of a thread in the timeline. */
+int deg_debug_trace_thread_index();
+
+/**
+ * Write the events of one evaluation of the graph to the trace file. The start and end time of
+ * the whole evaluation are written as a separate event.
+ */
+void deg_debug_trace_write(const Depsgraph *graph,
+                           DepsgraphTraceEvents &events,
+                           double start_time,
+                           double end_time);
+
+}  // namespace blender::deg
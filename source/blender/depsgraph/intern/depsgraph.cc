@@ -317,6 +317,28 @@ void DEG_graph_free(Depsgraph *graph)
   delete deg_depsgraph;
 }
 
+Depsgraph **DEG_graphs_new(
+    Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluationMode mode, int num_graphs)
+{
+  Depsgraph **graphs = static_cast<Depsgraph **>(
+      MEM_malloc_arrayN(num_graphs, sizeof(Depsgraph *), __func__));
+  for (int i = 0; i < num_graphs; i++) {
+    graphs[i] = DEG_graph_new(bmain, scene, view_layer, mode);
+  }
+  return graphs;
+}
+
+void DEG_graphs_free(Depsgraph **graphs, int num_graphs)
+{
+  if (graphs == nullptr) {
+    return;
+  }
+  for (int i = 0; i < num_graphs; i++) {
+    DEG_graph_free(graphs[i]);
+  }
+  MEM_freeN(graphs);
+}
+
 bool DEG_is_evaluating(const struct Depsgraph *depsgraph)
 {
   const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(depsgraph);
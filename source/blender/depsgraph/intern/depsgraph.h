@@ -108,6 +108,10 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update;
 
+  /* IDs which relations are to be updated, while relations of all other IDs are up to date.
+   * When relations needs to be updated and this set is empty the graph is rebuilt entirely. */
+  Set<ID *> relations_update_ids;
+
   /* Indicated whether IDs in this graph are to be tagged as if they first appear visible, with
    * an optional tag for their animation (time) update. */
   bool need_visibility_update;
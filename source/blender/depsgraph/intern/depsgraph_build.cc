@@ -39,6 +39,7 @@
 #include "DNA_simulation_types.h"
 
 #include "BKE_collection.h"
+#include "BKE_global.h"
 #include "BKE_main.h"
 #include "BKE_scene.h"
 
@@ -50,6 +51,7 @@
 #include "builder/pipeline_all_objects.h"
 #include "builder/pipeline_compositor.h"
 #include "builder/pipeline_from_ids.h"
+#include "builder/pipeline_relations_update.h"
 #include "builder/pipeline_render.h"
 #include "builder/pipeline_view_layer.h"
 
@@ -287,6 +289,7 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
   DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations for update.\n", __func__);
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
   deg_graph->need_update = true;
+  deg_graph->relations_update_ids.clear();
   /* NOTE: When relations are updated, it's quite possible that
    * we've got new bases in the scene. This means, we need to
    * re-create flat array of bases in view layer.
@@ -299,6 +302,25 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
   }
 }
 
+void DEG_graph_id_tag_relations_update(Depsgraph *graph, ID *id)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  if (deg_graph->need_update && deg_graph->relations_update_ids.is_empty()) {
+    /* Graph is already tagged for full relations update. */
+    return;
+  }
+  deg::IDNode *id_node = deg_graph->find_id_node(id);
+  if (id_node == nullptr) {
+    /* ID is to be pulled into the graph, which needs a full relations update. */
+    DEG_graph_tag_relations_update(graph);
+    return;
+  }
+  DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  deg_graph->need_update = true;
+  deg_graph->relations_update_ids.add(id);
+  id_node->tag_update(deg_graph, deg::DEG_UPDATE_SOURCE_RELATIONS);
+}
+
 void DEG_graph_relations_update(Depsgraph *graph)
 {
   deg::Depsgraph *deg_graph = (deg::Depsgraph *)graph;
@@ -306,6 +328,19 @@ void DEG_graph_relations_update(Depsgraph *graph)
     /* Graph is up to date, nothing to do. */
     return;
   }
+  if (!deg_graph->relations_update_ids.is_empty()) {
+    /* Try to only update relations of the tagged IDs, falling back to a full rebuild when it is
+     * not possible. */
+    blender::Vector<ID *> ids(deg_graph->relations_update_ids.begin(),
+                              deg_graph->relations_update_ids.end());
+    deg::RelationsUpdateBuilderPipeline builder(graph, ids);
+    if (builder.build()) {
+      if (G.debug & G_DEBUG_DEPSGRAPH_VERIFY) {
+        builder.verify();
+      }
+      return;
+    }
+  }
   DEG_graph_build_from_view_layer(graph);
 }
 
@@ -316,3 +351,11 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+void DEG_id_tag_relations_update(Main *bmain, ID *id)
+{
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    DEG_graph_id_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph), id);
+  }
+}
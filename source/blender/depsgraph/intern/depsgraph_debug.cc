@@ -239,6 +239,13 @@ void DEG_stats_simple(const Depsgraph *graph,
   }
 }
 
+void DEG_stats_pose_bones(const Depsgraph *graph, int *r_evaluated, int *r_reused)
+{
+  const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(graph);
+  *r_evaluated = deg_graph->debug.stats.pose_bones_evaluated;
+  *r_reused = deg_graph->debug.stats.pose_bones_reused;
+}
+
 static deg::string depsgraph_name_for_logging(struct Depsgraph *depsgraph)
 {
   const char *name = DEG_debug_name_get(depsgraph);
@@ -248,6 +255,21 @@ static deg::string depsgraph_name_for_logging(struct Depsgraph *depsgraph)
   return "[" + deg::string(name) + "]: ";
 }
 
+void DEG_debug_stats_pose_bone_evaluated(struct Depsgraph *depsgraph, const bool reused)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  /* Avoid contention on the shared counters from every bone when statistics are not requested. */
+  if (!deg_graph->debug.do_time_debug()) {
+    return;
+  }
+  if (reused) {
+    deg_graph->debug.stats.pose_bones_reused++;
+  }
+  else {
+    deg_graph->debug.stats.pose_bones_evaluated++;
+  }
+}
+
 void DEG_debug_print_begin(struct Depsgraph *depsgraph)
 {
   fprintf(stdout, "%s", depsgraph_name_for_logging(depsgraph).c_str());
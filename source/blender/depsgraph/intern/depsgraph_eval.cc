@@ -25,17 +25,26 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "PIL_time.h"
+
 #include "BLI_listbase.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
+#include "BKE_global.h"
 #include "BKE_scene.h"
 
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
 #include "DEG_depsgraph_query.h"
 
+#ifdef WITH_PYTHON
+#  include "BPY_extern.h"
+#endif
+
 #include "intern/eval/deg_eval.h"
 #include "intern/eval/deg_eval_flush.h"
 
@@ -55,8 +64,15 @@ static void deg_flush_updates_and_refresh(deg::Depsgraph *deg_graph)
     BKE_scene_frame_set(deg_graph->scene_cow, deg_graph->frame);
   }
 
+  const bool do_time = deg_graph->debug.do_time_debug();
+  const double start_time = do_time ? PIL_check_seconds_timer() : 0.0;
+
   deg::graph_tag_ids_for_visible_update(deg_graph);
   deg::deg_graph_flush_updates(deg_graph);
+
+  if (do_time && !deg_graph->entry_tags.is_empty()) {
+    printf("Depsgraph updates flushed in %f seconds.\n", PIL_check_seconds_timer() - start_time);
+  }
   deg::deg_evaluate_on_refresh(deg_graph);
 }
 
@@ -86,3 +102,36 @@ void DEG_evaluate_on_framechange(Depsgraph *graph, float frame)
   deg_graph->ctime = BKE_scene_frame_to_ctime(scene, frame);
   deg_flush_updates_and_refresh(deg_graph);
 }
+
+void DEG_graphs_evaluate_on_framechange(Depsgraph **graphs, const float *frames, int num_graphs)
+{
+  /* Building relations might modify original data, so it is not done concurrently. */
+  for (int i = 0; i < num_graphs; i++) {
+    BLI_assert(!DEG_is_active(graphs[i]));
+    DEG_graph_relations_update(graphs[i]);
+  }
+  if (G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS) {
+    for (int i = 0; i < num_graphs; i++) {
+      DEG_evaluate_on_framechange(graphs[i], frames[i]);
+    }
+    return;
+  }
+#ifdef WITH_PYTHON
+  /* Release the GIL while waiting for the graphs, otherwise graphs evaluated on other threads
+   * would never be able to evaluate their Python drivers. */
+  BPy_BEGIN_ALLOW_THREADS;
+#endif
+
+  /* Every graph evaluates its operations in its own task pool, so use a grain size of 1 to have
+   * all the graphs started right away. */
+  blender::threading::parallel_for(
+      blender::IndexRange(num_graphs), 1, [&](const blender::IndexRange range) {
+        for (const int i : range) {
+          DEG_evaluate_on_framechange(graphs[i], frames[i]);
+        }
+      });
+
+#ifdef WITH_PYTHON
+  BPy_END_ALLOW_THREADS;
+#endif
+}
@@ -0,0 +1,216 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Micro benchmarks of building and evaluating the dependency graph of procedurally generated
+ * scenes. The same measurements as `tests/performance/tests/depsgraph.py`, without the overhead
+ * of Python and the window manager.
+ */
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_anim_types.h"
+#include "DNA_collection_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_anim_data.h"
+#include "BKE_collection.h"
+#include "BKE_fcurve.h"
+#include "BKE_fcurve_driver.h"
+#include "BKE_layer.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BKE_modifier.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+#include "DEG_depsgraph_query.h"
+
+#include "intern/depsgraph.h"
+#include "intern/eval/deg_eval_flush.h"
+
+namespace blender::deg::tests {
+
+class DepsgraphPerformanceTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  ViewLayer *view_layer = nullptr;
+  Mesh *mesh = nullptr;
+  Vector<Object *> objects;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    view_layer = BKE_view_layer_default_view(scene);
+    mesh = BKE_mesh_add(bmain, "Mesh");
+  }
+
+  void TearDown() override
+  {
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_main_free(bmain);
+  }
+
+  Object *object_add(Collection *collection, const char *name)
+  {
+    Object *object = BKE_object_add_only_object(bmain, OB_MESH, name);
+    object->data = mesh;
+    id_us_plus(&mesh->id);
+    BKE_collection_object_add(bmain, collection, object);
+    return object;
+  }
+
+  /* Driver on a location channel of the object, depending on the frame and on the Z location of
+   * another object. The expression is simple enough to be evaluated without Python. */
+  void driver_add(Object *object, const int array_index, Object *target)
+  {
+    AnimData *adt = BKE_animdata_ensure_id(&object->id);
+    FCurve *fcu = BKE_fcurve_create();
+    fcu->rna_path = BLI_strdup("location");
+    fcu->array_index = array_index;
+    BLI_addtail(&adt->drivers, fcu);
+
+    ChannelDriver *driver = static_cast<ChannelDriver *>(
+        MEM_callocN(sizeof(ChannelDriver), __func__));
+    driver->type = DRIVER_TYPE_PYTHON;
+    STRNCPY(driver->expression, "x + frame * 0.01");
+    fcu->driver = driver;
+
+    DriverVar *dvar = driver_add_new_variable(driver);
+    STRNCPY(dvar->name, "x");
+    driver_change_variable_type(dvar, DVAR_TYPE_TRANSFORM_CHAN);
+    dvar->targets[0].id = &target->id;
+    dvar->targets[0].transChan = DTAR_TRANSCHAN_LOCZ;
+  }
+
+  /* Generate the scene the same way as the Python benchmark. */
+  void scene_generate(const int objects_num, const int modifiers_num, const int drivers_num)
+  {
+    /* Fill a collection outside of the scene and link it at the end, to sync the view layer
+     * only once. */
+    Collection *collection = BKE_collection_add(bmain, nullptr, "Objects");
+    for (const int i : IndexRange(objects_num)) {
+      char name[MAX_ID_NAME - 2];
+      BLI_snprintf(name, sizeof(name), "Object%d", i);
+      Object *object = object_add(collection, name);
+      for (int j = 0; j < modifiers_num; j++) {
+        ModifierData *md = BKE_modifier_new(eModifierType_Displace);
+        BLI_addtail(&object->modifiers, md);
+      }
+      objects.append(object);
+    }
+    for (const int i : IndexRange(drivers_num)) {
+      driver_add(objects[i % objects_num], i % 3, objects[(i + 1) % objects_num]);
+    }
+    BKE_collection_child_add(bmain, scene->master_collection, collection);
+  }
+
+  void benchmark(const int objects_num, const int modifiers_num, const int drivers_num)
+  {
+    scene_generate(objects_num, modifiers_num, drivers_num);
+    const std::string name = "objects " + std::to_string(objects_num) + ", modifiers " +
+                             std::to_string(modifiers_num) + ", drivers " +
+                             std::to_string(drivers_num);
+
+    ::Depsgraph *graph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_VIEWPORT);
+    {
+      SCOPED_TIMER(name + ": build");
+      DEG_graph_build_from_view_layer(graph);
+    }
+    {
+      SCOPED_TIMER(name + ": first evaluation");
+      DEG_evaluate_on_refresh(graph);
+    }
+
+    /* Linking a new object tags relations of the scene for rebuild. */
+    Object *extra_object = object_add(scene->master_collection, "Extra");
+    DEG_relations_tag_update(bmain);
+    {
+      SCOPED_TIMER(name + ": relations update");
+      DEG_graph_relations_update(graph);
+    }
+    DEG_evaluate_on_refresh(graph);
+    EXPECT_NE(DEG_get_evaluated_object(graph, extra_object), extra_object);
+
+    {
+      SCOPED_TIMER(name + ": tag");
+      for (Object *object : objects) {
+        DEG_id_tag_update_ex(bmain, &object->id, ID_RECALC_TRANSFORM);
+      }
+    }
+    {
+      SCOPED_TIMER(name + ": flush");
+      deg_graph_flush_updates(reinterpret_cast<Depsgraph *>(graph));
+    }
+    {
+      SCOPED_TIMER(name + ": evaluation of tagged objects");
+      DEG_evaluate_on_refresh(graph);
+    }
+
+    const int frames_num = 10;
+    {
+      SCOPED_TIMER(name + ": " + std::to_string(frames_num) + " frame changes");
+      for (int frame = 2; frame < 2 + frames_num; frame++) {
+        DEG_evaluate_on_framechange(graph, float(frame));
+      }
+    }
+
+    DEG_graph_free(graph);
+  }
+};
+
+TEST_F(DepsgraphPerformanceTest, objects_1000)
+{
+  benchmark(1000, 0, 0);
+}
+
+TEST_F(DepsgraphPerformanceTest, objects_10000)
+{
+  benchmark(10000, 0, 0);
+}
+
+TEST_F(DepsgraphPerformanceTest, objects_1000_modifiers_2)
+{
+  benchmark(1000, 2, 0);
+}
+
+TEST_F(DepsgraphPerformanceTest, objects_1000_drivers_1000)
+{
+  benchmark(1000, 0, 1000);
+}
+
+}  // namespace blender::deg::tests
@@ -262,13 +262,19 @@ void depsgraph_update_editors_tag(Main *bmain, Depsgraph *graph, ID *id)
   deg_editors_id_update(&update_ctx, id);
 }
 
-void depsgraph_id_tag_copy_on_write(Depsgraph *graph, IDNode *id_node, eUpdateSource update_source)
+/* The recalc denotes which part of the data-block is to be updated by the copy-on-write
+ * operation, see #deg_evaluate_copy_on_write. */
+void depsgraph_id_tag_copy_on_write(Depsgraph *graph,
+                                    IDNode *id_node,
+                                    eUpdateSource update_source,
+                                    int recalc = ID_RECALC_COPY_ON_WRITE)
 {
   ComponentNode *cow_comp = id_node->find_component(NodeType::COPY_ON_WRITE);
   if (cow_comp == nullptr) {
     BLI_assert(!deg_copy_on_write_is_needed(GS(id_node->id_orig->name)));
     return;
   }
+  id_node->copy_on_write_recalc |= recalc;
   cow_comp->tag_update(graph, update_source);
 }
 
@@ -299,7 +305,8 @@ void depsgraph_tag_component(Depsgraph *graph,
   }
   /* If component depends on copy-on-write, tag it as well. */
   if (component_node->need_tag_cow_before_update()) {
-    depsgraph_id_tag_copy_on_write(graph, id_node, update_source);
+    const DepsNodeFactory *factory = type_get_factory(component_type);
+    depsgraph_id_tag_copy_on_write(graph, id_node, update_source, factory->id_recalc_tag());
   }
 }
 
@@ -490,6 +497,7 @@ void deg_graph_node_tag_zero(Main *bmain,
   ID *id = id_node->id_orig;
   /* TODO(sergey): Which recalc flags to set here? */
   id_node->id_cow->recalc |= deg_recalc_flags_for_legacy_zero();
+  id_node->copy_on_write_recalc |= ID_RECALC_COPY_ON_WRITE;
 
   for (ComponentNode *comp_node : id_node->components.values()) {
     if (comp_node->type == NodeType::ANIMATION) {
@@ -25,14 +25,18 @@
 
 #include "intern/eval/deg_eval.h"
 
+#include <algorithm>
+
 #include "PIL_time.h"
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_gsqueue.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BKE_global.h"
+#include "BKE_scene.h"
 
 #include "DNA_node_types.h"
 #include "DNA_object_types.h"
@@ -47,6 +51,7 @@
 
 #include "atomic_ops.h"
 
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/depsgraph.h"
 #include "intern/depsgraph_relation.h"
 #include "intern/depsgraph_tag.h"
@@ -78,6 +83,26 @@ void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), Tas
   BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
 }
 
+/* Keep the most expensive of the scheduled nodes in `r_next_node`, for the current thread to
+ * evaluate once it is done with the current node. The rest of the nodes are pushed to the pool.
+ *
+ * Continuing with the node on the critical path avoids the overhead of the task pool for the
+ * longest chain of operations and makes it start as early as possible. */
+void schedule_node_to_pool_or_continue(OperationNode *node,
+                                       const int thread_id,
+                                       TaskPool *pool,
+                                       OperationNode **r_next_node)
+{
+  if (*r_next_node == nullptr) {
+    *r_next_node = node;
+    return;
+  }
+  if (node->critical_path_cost > (*r_next_node)->critical_path_cost) {
+    std::swap(node, *r_next_node);
+  }
+  schedule_node_to_pool(node, thread_id, pool);
+}
+
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
   /* Stage 1: Only  Copy-on-Write operations are to be evaluated, prior to anything else.
@@ -98,6 +123,8 @@ enum class EvaluationStage {
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Timings of evaluated operations, only allocated when a trace is recorded. */
+  std::unique_ptr<DepsgraphTraceEvents> trace_events;
   EvaluationStage stage;
   bool need_single_thread_pass;
 };
@@ -109,13 +136,17 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const double end_time = PIL_check_seconds_timer();
+  /* Averaged timing is used to estimate the critical path during the next evaluation. */
+  operation_node->stats.accumulate_time(end_time - start_time);
   if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    operation_node->stats.current_time += end_time - start_time;
   }
-  else {
-    operation_node->evaluate(depsgraph);
+  if (state->trace_events) {
+    state->trace_events->local().append(
+        {operation_node, deg_debug_trace_thread_index(), start_time, end_time});
   }
 }
 
@@ -124,12 +155,18 @@ void deg_task_run_func(TaskPool *pool, void *taskdata)
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
   OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  while (operation_node != nullptr) {
+    /* Evaluate node. */
+    evaluate_node(state, operation_node);
 
-  /* Schedule children. */
-  schedule_children(state, operation_node, schedule_node_to_pool, pool);
+    /* Schedule children. The child with the highest critical path cost is evaluated by this
+     * thread right away, other children are pushed to the pool. */
+    OperationNode *next_operation_node = nullptr;
+    schedule_children(
+        state, operation_node, schedule_node_to_pool_or_continue, pool, &next_operation_node);
+    operation_node = next_operation_node;
+  }
 }
 
 bool check_operation_node_visible(OperationNode *op_node)
@@ -186,6 +223,9 @@ void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
 {
   const bool do_stats = state->do_stats;
   calculate_pending_parents(graph);
+  if (!(G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS)) {
+    deg_eval_stats_calculate_critical_path(graph);
+  }
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
     if (do_stats) {
@@ -318,6 +358,27 @@ void schedule_node_to_queue(OperationNode *node,
   BLI_gsqueue_push(evaluation_queue, &node);
 }
 
+void schedule_node_to_vector(OperationNode *node,
+                             const int /*thread_id*/,
+                             Vector<OperationNode *> *r_nodes)
+{
+  r_nodes->append(node);
+}
+
+void schedule_graph_to_pool(DepsgraphEvalState *state, TaskPool *pool)
+{
+  /* Push nodes which are ready for evaluation in the order of decreasing critical path cost, so
+   * that the most expensive chains of operations are started first. */
+  Vector<OperationNode *> nodes;
+  schedule_graph(state, schedule_node_to_vector, &nodes);
+  std::stable_sort(nodes.begin(), nodes.end(), [](OperationNode *a, OperationNode *b) {
+    return a->critical_path_cost > b->critical_path_cost;
+  });
+  for (OperationNode *node : nodes) {
+    schedule_node_to_pool(node, 0, pool);
+  }
+}
+
 void evaluate_graph_single_threaded(DepsgraphEvalState *state)
 {
   GSQueue *evaluation_queue = BLI_gsqueue_new(sizeof(OperationNode *));
@@ -348,6 +409,10 @@ void depsgraph_ensure_view_layer(Depsgraph *graph)
 
   const IDNode *scene_id_node = graph->find_id_node(&graph->scene->id);
   deg_update_copy_on_write_datablock(graph, scene_id_node);
+
+  /* The copy has the frame of the original scene, which is not the frame the graph is evaluated
+   * at when the graph is not active. */
+  BKE_scene_frame_set(scene_cow, graph->frame);
 }
 
 }  // namespace
@@ -369,6 +434,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   }
 
   graph->debug.begin_graph_evaluation();
+  const double start_time = PIL_check_seconds_timer();
 
 #ifdef WITH_PYTHON
   /* Release the GIL so that Python drivers can be evaluated. See T91046. */
@@ -381,6 +447,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  if (deg_debug_trace_is_active()) {
+    state.trace_events = std::make_unique<DepsgraphTraceEvents>();
+  }
   state.need_single_thread_pass = false;
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -389,14 +458,14 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   /* First, process all Copy-On-Write nodes. */
   state.stage = EvaluationStage::COPY_ON_WRITE;
   TaskPool *task_pool = deg_evaluate_task_pool_create(&state);
-  schedule_graph(&state, schedule_node_to_pool, task_pool);
+  schedule_graph_to_pool(&state, task_pool);
   BLI_task_pool_work_and_wait(task_pool);
   BLI_task_pool_free(task_pool);
 
   /* After that, process all other nodes. */
   state.stage = EvaluationStage::THREADED_EVALUATION;
   task_pool = deg_evaluate_task_pool_create(&state);
-  schedule_graph(&state, schedule_node_to_pool, task_pool);
+  schedule_graph_to_pool(&state, task_pool);
   BLI_task_pool_work_and_wait(task_pool);
   BLI_task_pool_free(task_pool);
 
@@ -411,6 +480,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   if (state.do_stats) {
     deg_eval_stats_aggregate(graph);
   }
+  if (state.trace_events) {
+    deg_debug_trace_write(graph, *state.trace_events, start_time, PIL_check_seconds_timer());
+  }
   /* Clear any uncleared tags - just in case. */
   deg_graph_clear_tags(graph);
   graph->is_evaluating = false;
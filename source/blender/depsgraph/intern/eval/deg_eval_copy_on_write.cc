@@ -1010,6 +1010,36 @@ void discard_edit_mode_pointers(ID *id_cow)
   }
 }
 
+/* Update parts of the copy-on-write data-block denoted by the recalc flags of the components
+ * which tagged it for update, without copying the whole data-block.
+ * Returns false if the data-block is to be copied as a whole. */
+bool update_copy_on_write_datablock_partial(const IDNode *id_node)
+{
+  const int recalc = id_node->copy_on_write_recalc;
+  if (recalc == 0 || (recalc & ID_RECALC_COPY_ON_WRITE)) {
+    return false;
+  }
+  if (!check_datablock_expanded(id_node->id_cow)) {
+    return false;
+  }
+  switch (id_node->id_type) {
+    case ID_OB: {
+      /* Avoid copying of modifiers, constraints and pose on every step of interactive object
+       * transform. Settings which are stored outside of the object itself are to be tagged with
+       * ID_RECALC_COPY_ON_WRITE. */
+      if (recalc != ID_RECALC_TRANSFORM) {
+        return false;
+      }
+      BKE_object_transform_settings_copy((Object *)id_node->id_cow,
+                                         (const Object *)id_node->id_orig);
+      return true;
+    }
+    default:
+      break;
+  }
+  return false;
+}
+
 }  // namespace
 
 /**
@@ -1059,6 +1089,9 @@ void deg_evaluate_copy_on_write(struct ::Depsgraph *graph, const IDNode *id_node
      * ensures scene and view layer pointers are valid. */
     return;
   }
+  if (update_copy_on_write_datablock_partial(id_node)) {
+    return;
+  }
   deg_update_copy_on_write_datablock(depsgraph, id_node);
 }
 
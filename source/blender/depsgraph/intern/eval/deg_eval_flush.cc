@@ -190,6 +190,11 @@ inline OperationNode *flush_schedule_children(OperationNode *op_node, FlushQueue
     /* Always flush flushable flags, so children always know what happened
      * to their parents. */
     to_node->flag |= (op_node->flag & DEPSOP_FLAG_FLUSH);
+    /* It is not known which part of the data-block is affected by the update coming from another
+     * data-block, so it is to be copied as a whole. */
+    if (to_node->owner->type == NodeType::COPY_ON_WRITE) {
+      to_node->owner->owner->copy_on_write_recalc |= ID_RECALC_COPY_ON_WRITE;
+    }
     /* Flush update over the relation, if it was not flushed yet. */
     if (to_node->scheduled) {
       continue;
@@ -401,6 +406,9 @@ void deg_graph_clear_tags(Depsgraph *graph)
   }
   /* Clear any entry tags which haven't been flushed. */
   graph->entry_tags.clear();
+  for (IDNode *id_node : graph->id_nodes) {
+    id_node->copy_on_write_recalc = 0;
+  }
 
   graph->time_source->tagged_for_update = false;
 }
@@ -173,6 +173,9 @@ void ObjectRuntimeBackup::restore_pose_channel_runtime_data(Object *object)
       optional<bPoseChannel_Runtime> runtime = pose_channel_runtime_data.pop_try(session_uuid);
       if (runtime.has_value()) {
         pchan->runtime = *runtime;
+        /* The pose matrix is copied from the original, which does not necessarily match the one
+         * the runtime data was computed for. */
+        pchan->runtime.flag &= ~POSE_RUNTIME_EVAL_CHAN_MAT_VALID;
       }
     }
   }
@@ -23,9 +23,12 @@
 
 #include "intern/eval/deg_eval_stats.h"
 
+#include "BLI_math_base.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
 
 #include "intern/node/deg_node.h"
 #include "intern/node/deg_node_component.h"
@@ -54,4 +57,92 @@ void deg_eval_stats_aggregate(Depsgraph *graph)
   }
 }
 
+namespace {
+
+enum {
+  CRITICAL_PATH_NOT_VISITED = 0,
+  CRITICAL_PATH_IN_PROGRESS = 1,
+  CRITICAL_PATH_DONE = 2,
+};
+
+struct CriticalPathStackEntry {
+  OperationNode *node;
+  /* Index of the next outgoing relation to be visited. */
+  int64_t next_relation_index;
+};
+
+/* Operations which are up to date are not evaluated and are not waited for by their children, so
+ * only the tagged operations are part of the critical path. */
+OperationNode *get_critical_path_child(const Relation *relation)
+{
+  if (relation->flag & RELATION_FLAG_CYCLIC) {
+    return nullptr;
+  }
+  if (relation->to->type != NodeType::OPERATION) {
+    return nullptr;
+  }
+  OperationNode *child = (OperationNode *)relation->to;
+  if ((child->flag & DEPSOP_FLAG_NEEDS_UPDATE) == 0) {
+    return nullptr;
+  }
+  return child;
+}
+
+void calculate_critical_path_cost(OperationNode *op_node)
+{
+  double max_child_cost = 0.0;
+  for (Relation *relation : op_node->outlinks) {
+    OperationNode *child = get_critical_path_child(relation);
+    /* Children which are still in progress are part of a dependency cycle which was not detected
+     * by the builder. Ignore them, the cost is only used as a scheduling hint. */
+    if (child != nullptr && child->custom_flags == CRITICAL_PATH_DONE) {
+      max_child_cost = max_dd(max_child_cost, child->critical_path_cost);
+    }
+  }
+  op_node->critical_path_cost = op_node->stats.average_time + max_child_cost;
+}
+
+}  // namespace
+
+void deg_eval_stats_calculate_critical_path(Depsgraph *graph)
+{
+  /* The traversal is limited to the operations tagged for update. Since the update tags are
+   * flushed to the children, those are also all the descendants which are evaluated. */
+  Vector<OperationNode *> tagged_nodes;
+  for (OperationNode *op_node : graph->operations) {
+    if (op_node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
+      op_node->custom_flags = CRITICAL_PATH_NOT_VISITED;
+      tagged_nodes.append(op_node);
+    }
+  }
+  /* Depth-first traversal along the outgoing relations, calculating cost of a node once all of
+   * its children are handled. Explicit stack is used, since the chains of operations can be too
+   * long for recursion. */
+  Vector<CriticalPathStackEntry> stack;
+  for (OperationNode *root : tagged_nodes) {
+    if (root->custom_flags != CRITICAL_PATH_NOT_VISITED) {
+      continue;
+    }
+    root->custom_flags = CRITICAL_PATH_IN_PROGRESS;
+    stack.append({root, 0});
+    while (!stack.is_empty()) {
+      CriticalPathStackEntry &entry = stack.last();
+      OperationNode *op_node = entry.node;
+      if (entry.next_relation_index == op_node->outlinks.size()) {
+        calculate_critical_path_cost(op_node);
+        op_node->custom_flags = CRITICAL_PATH_DONE;
+        stack.pop_last();
+        continue;
+      }
+      OperationNode *child = get_critical_path_child(
+          op_node->outlinks[entry.next_relation_index++]);
+      if (child != nullptr && child->custom_flags == CRITICAL_PATH_NOT_VISITED) {
+        child->custom_flags = CRITICAL_PATH_IN_PROGRESS;
+        /* NOTE: Invalidates the `entry` reference. */
+        stack.append({child, 0});
+      }
+    }
+  }
+}
+
 }  // namespace blender::deg
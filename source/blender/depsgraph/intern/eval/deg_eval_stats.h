@@ -31,5 +31,9 @@ struct Depsgraph;
 /* Aggregate operation timings to overall component and ID nodes timing. */
 void deg_eval_stats_aggregate(Depsgraph *graph);
 
+/* Calculate critical path cost of all operations which are tagged for update, based on the
+ * averaged timing of their previous evaluations. */
+void deg_eval_stats_calculate_critical_path(Depsgraph *graph);
+
 }  // namespace deg
 }  // namespace blender
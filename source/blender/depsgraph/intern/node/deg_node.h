@@ -178,8 +178,12 @@ struct Node {
     /* Reset counters needed for the current graph evaluation, does not
      * touch averaging accumulators. */
     void reset_current();
+    /* Update the averaging accumulators with the time spent on the evaluation of this node. */
+    void accumulate_time(double time);
     /* Time spend on this node during current graph evaluation. */
     double current_time;
+    /* Time spend on this node, averaged over the previous graph evaluations. */
+    double average_time;
   };
   /* Relationships between nodes
    * The reason why all depsgraph nodes are descended from this type (apart
@@ -90,6 +90,7 @@ void IDNode::init(const ID *id, const char *UNUSED(subdata))
   has_base = false;
   is_user_modified = false;
   id_cow_recalc_backup = 0;
+  copy_on_write_recalc = 0;
 
   visible_components_mask = 0;
   previously_visible_components_mask = 0;
@@ -181,6 +182,7 @@ ComponentNode *IDNode::add_component(NodeType type, const char *name)
 
 void IDNode::tag_update(Depsgraph *graph, eUpdateSource source)
 {
+  copy_on_write_recalc |= ID_RECALC_COPY_ON_WRITE;
   for (ComponentNode *comp_node : components.values()) {
     /* Relations update does explicit animation update when needed. Here we ignore animation
      * component to avoid loss of possible unkeyed changes. */
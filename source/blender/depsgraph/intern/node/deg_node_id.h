@@ -124,6 +124,11 @@ struct IDNode : public Node {
   /* Accumulate recalc flags from multiple update passes. */
   int id_cow_recalc_backup;
 
+  /* Recalc flags of the components which caused copy-on-write component to be tagged for update.
+   * ID_RECALC_COPY_ON_WRITE denotes that the whole data-block is to be copied, which is also the
+   * case when the flags are zero. Is reset when tags are cleared after evaluation. */
+  int copy_on_write_recalc;
+
   IDComponentsMask visible_components_mask;
   IDComponentsMask previously_visible_components_mask;
 
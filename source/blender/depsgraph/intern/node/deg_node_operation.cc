@@ -212,7 +212,7 @@ const char *operationCodeAsString(OperationCode opcode)
   return "UNKNOWN";
 }
 
-OperationNode::OperationNode() : name_tag(-1), flag(0)
+OperationNode::OperationNode() : critical_path_cost(0.0), name_tag(-1), flag(0)
 {
 }
 
@@ -272,6 +272,10 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Estimated time needed to evaluate this operation and the most expensive chain of operations
+   * which depend on it. Operations with higher cost are scheduled for evaluation first. */
+  double critical_path_cost;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
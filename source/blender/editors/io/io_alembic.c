@@ -153,6 +153,7 @@ static int wm_alembic_export_exec(bContext *C, wmOperator *op)
       .quad_method = RNA_enum_get(op->ptr, "quad_method"),
       .ngon_method = RNA_enum_get(op->ptr, "ngon_method"),
       .evaluation_mode = RNA_enum_get(op->ptr, "evaluation_mode"),
+      .use_concurrent_frames = RNA_boolean_get(op->ptr, "use_concurrent_frames"),
 
       .global_scale = RNA_float_get(op->ptr, "global_scale"),
   };
@@ -214,6 +215,7 @@ static void ui_alembic_export_settings(uiLayout *layout, PointerRNA *imfptr)
 
   col = uiLayoutColumn(box, true);
   uiItemR(col, imfptr, "evaluation_mode", 0, NULL, ICON_NONE);
+  uiItemR(col, imfptr, "use_concurrent_frames", 0, NULL, ICON_NONE);
 
   /* Object Data */
   box = uiLayoutBox(layout);
@@ -488,6 +490,13 @@ void WM_OT_alembic_export(wmOperatorType *ot)
                "Determines visibility of objects, modifier settings, and other areas where there "
                "are different settings for viewport and rendering");
 
+  RNA_def_boolean(ot->srna,
+                  "use_concurrent_frames",
+                  false,
+                  "Evaluate Frames Concurrently",
+                  "Evaluate multiple frames at the same time, using more memory. Frame change "
+                  "handlers are not run for the exported frames");
+
   /* This dummy prop is used to check whether we need to init the start and
    * end frame values to that of the scene's, otherwise they are reset at
    * every change, draw update. */
@@ -1223,7 +1223,8 @@ static int empty_drop_named_image_invoke(bContext *C, wmOperator *op, const wmEv
   /* either change empty under cursor or create a new empty */
   if (ob_cursor && ob_cursor->type == OB_EMPTY) {
     WM_event_add_notifier(C, NC_SCENE | ND_OB_ACTIVE, scene);
-    DEG_id_tag_update((ID *)ob_cursor, ID_RECALC_TRANSFORM);
+    /* The image is assigned to the object data, so copy-on-write is needed. */
+    DEG_id_tag_update((ID *)ob_cursor, ID_RECALC_TRANSFORM | ID_RECALC_COPY_ON_WRITE);
     ob = ob_cursor;
   }
   else {
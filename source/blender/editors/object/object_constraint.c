@@ -1351,6 +1351,10 @@ void ED_object_constraint_update(Main *bmain, Object *ob)
   else {
     DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
   }
+
+  /* Constraints are not a part of the object transform, so copy-on-write is needed to get the
+   * changes into the evaluated object. */
+  DEG_id_tag_update(&ob->id, ID_RECALC_COPY_ON_WRITE);
 }
 
 static void object_pose_tag_update(Main *bmain, Object *ob)
@@ -1407,7 +1411,7 @@ void ED_object_constraint_dependency_tag_update(Main *bmain, Object *ob, bConstr
   if (ob->pose) {
     object_pose_tag_update(bmain, ob);
   }
-  DEG_relations_tag_update(bmain);
+  DEG_id_tag_relations_update(bmain, &ob->id);
 }
 
 bool ED_object_constraint_move_to_index(Object *ob, bConstraint *con, const int index)
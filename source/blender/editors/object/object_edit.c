@@ -1066,7 +1066,8 @@ static int forcefield_toggle_exec(bContext *C, wmOperator *UNUSED(op))
   WM_event_add_notifier(C, NC_OBJECT | ND_DRAW, ob);
   WM_event_add_notifier(C, NC_OBJECT | ND_MODIFIER, ob);
 
-  DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+  /* Field settings are not a part of the object transform, so copy-on-write is needed. */
+  DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM | ID_RECALC_COPY_ON_WRITE);
 
   return OPERATOR_FINISHED;
 }
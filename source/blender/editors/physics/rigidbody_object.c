@@ -313,7 +313,7 @@ static int rigidbody_objects_shape_change_exec(bContext *C, wmOperator *op)
       RNA_pointer_create(&ob->id, &RNA_RigidBodyObject, ob->rigidbody_object, &ptr);
       RNA_enum_set(&ptr, "collision_shape", shape);
 
-      DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+      DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM | ID_RECALC_COPY_ON_WRITE);
 
       changed = true;
     }
@@ -503,7 +503,7 @@ static int rigidbody_objects_calc_mass_exec(bContext *C, wmOperator *op)
       RNA_pointer_create(&ob->id, &RNA_RigidBodyObject, ob->rigidbody_object, &ptr);
       RNA_float_set(&ptr, "mass", mass);
 
-      DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+      DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM | ID_RECALC_COPY_ON_WRITE);
 
       changed = true;
     }
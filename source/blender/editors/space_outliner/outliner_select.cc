@@ -411,8 +411,9 @@ static void tree_element_material_activate(bContext *C, ViewLayer *view_layer, T
 
   /* Tagging object for update seems a bit stupid here, but looks like we have to do it
    * for render views to update. See T42973.
-   * Note that RNA material update does it too, see e.g. rna_MaterialSlot_update(). */
-  DEG_id_tag_update((ID *)ob, ID_RECALC_TRANSFORM);
+   * Note that RNA material update does it too, see e.g. rna_MaterialSlot_update().
+   * Active material is not a part of the object transform, so copy-on-write is needed. */
+  DEG_id_tag_update((ID *)ob, ID_RECALC_TRANSFORM | ID_RECALC_COPY_ON_WRITE);
   WM_event_add_notifier(C, NC_MATERIAL | ND_SHADING_LINKS, nullptr);
 }
 
@@ -14,6 +14,7 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BLI_array.hh"
 #include "BLI_map.hh"
 #include "BLI_multi_value_map.hh"
 #include "BLI_set.hh"
@@ -150,6 +151,30 @@ static Set<GFieldRef> find_varying_fields(const FieldTreeInfo &field_tree_info,
   return found_fields;
 }
 
+/**
+ * Identifies a function call in the procedure by the called function and the variables that are
+ * passed into its inputs. Multi-functions don't have side effects, so two calls with the same key
+ * compute the same values.
+ */
+struct MFCallKey {
+  const MultiFunction *fn;
+  Vector<MFVariable *> inputs;
+
+  uint64_t hash() const
+  {
+    uint64_t hash = get_default_hash(fn);
+    for (const MFVariable *variable : inputs) {
+      hash = hash * 33 ^ get_default_hash(variable);
+    }
+    return hash;
+  }
+
+  friend bool operator==(const MFCallKey &a, const MFCallKey &b)
+  {
+    return a.fn == b.fn && a.inputs.as_span() == b.inputs.as_span();
+  }
+};
+
 /**
  * Builds the #procedure so that it computes the the fields.
  */
@@ -161,6 +186,10 @@ static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
   MFProcedureBuilder builder{procedure};
   /* Every input, intermediate and output field corresponds to a variable in the procedure. */
   Map<GFieldRef, MFVariable *> variable_by_field;
+  /* The same operation can exist in the field tree more than once, e.g. when the same node is
+   * evaluated in different places of a node tree. Remember the output variables of every call, so
+   * that such common subexpressions are only computed once. Ignored outputs are null. */
+  Map<MFCallKey, Vector<MFVariable *>> output_variables_by_call;
 
   /* Start by adding the field inputs as parameters to the procedure. */
   for (const FieldInput &field_input : field_tree_info.deduplicated_field_inputs) {
@@ -208,7 +237,52 @@ static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
             /* All inputs variables are ready, now gather all variables that are used by the
              * function and call it. */
             const MultiFunction &multi_function = operation_node.multi_function();
+            int outputs_num = 0;
+            for (const int param_index : multi_function.param_indices()) {
+              if (multi_function.param_type(param_index).interface_type() ==
+                  MFParamType::Output) {
+                outputs_num++;
+              }
+            }
+
+            MFCallKey call_key{&multi_function, {}};
+            for (const GField &input_field : operation_inputs) {
+              call_key.inputs.append(variable_by_field.lookup(input_field));
+            }
+            Array<bool> output_is_used(outputs_num);
+            for (const int output_index : IndexRange(outputs_num)) {
+              const GFieldRef output_field{operation_node, output_index};
+              output_is_used[output_index] =
+                  !field_tree_info.field_users.lookup(output_field).is_empty() ||
+                  output_fields.contains(output_field);
+            }
+
+            /* Reuse the outputs of an identical call when it computed all the outputs that are
+             * used here. */
+            const Vector<MFVariable *> *existing_output_variables =
+                output_variables_by_call.lookup_ptr(call_key);
+            if (existing_output_variables != nullptr) {
+              bool all_outputs_available = true;
+              for (const int output_index : IndexRange(outputs_num)) {
+                if (output_is_used[output_index] &&
+                    (*existing_output_variables)[output_index] == nullptr) {
+                  all_outputs_available = false;
+                  break;
+                }
+              }
+              if (all_outputs_available) {
+                for (const int output_index : IndexRange(outputs_num)) {
+                  if (output_is_used[output_index]) {
+                    variable_by_field.add_new({operation_node, output_index},
+                                              (*existing_output_variables)[output_index]);
+                  }
+                }
+                break;
+              }
+            }
+
             Vector<MFVariable *> variables(multi_function.param_amount());
+            Vector<MFVariable *> output_variables(outputs_num, nullptr);
 
             int param_input_index = 0;
             int param_output_index = 0;
@@ -216,23 +290,20 @@ static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
               const MFParamType param_type = multi_function.param_type(param_index);
               const MFParamType::InterfaceType interface_type = param_type.interface_type();
               if (interface_type == MFParamType::Input) {
-                const GField &input_field = operation_inputs[param_input_index];
-                variables[param_index] = variable_by_field.lookup(input_field);
+                variables[param_index] = call_key.inputs[param_input_index];
                 param_input_index++;
               }
               else if (interface_type == MFParamType::Output) {
-                const GFieldRef output_field{operation_node, param_output_index};
-                const bool output_is_ignored =
-                    field_tree_info.field_users.lookup(output_field).is_empty() &&
-                    !output_fields.contains(output_field);
-                if (output_is_ignored) {
+                if (!output_is_used[param_output_index]) {
                   /* Ignored outputs don't need a variable. */
                   variables[param_index] = nullptr;
                 }
                 else {
                   /* Create a new variable for used outputs. */
+                  const GFieldRef output_field{operation_node, param_output_index};
                   MFVariable &new_variable = procedure.new_variable(param_type.data_type());
                   variables[param_index] = &new_variable;
+                  output_variables[param_output_index] = &new_variable;
                   variable_by_field.add_new(output_field, &new_variable);
                 }
                 param_output_index++;
@@ -242,6 +313,8 @@ static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
               }
             }
             builder.add_call_with_all_variables(multi_function, variables);
+            output_variables_by_call.add_overwrite(std::move(call_key),
+                                                   std::move(output_variables));
           }
           break;
         }
@@ -270,13 +343,16 @@ static void build_multi_function_procedure_for_fields(MFProcedure &procedure,
     builder.add_output_parameter(*variable);
   }
 
-  /* Remove the variables that should not be destructed from the map. */
-  for (const GFieldRef &field : output_fields) {
-    variable_by_field.remove(field);
-  }
-  /* Add destructor calls for the remaining variables. */
+  /* Add destructor calls for the variables that are not outputs. A variable can belong to more
+   * than one field when common subexpressions were eliminated, but it is only destructed once. */
+  Set<MFVariable *> destructed_variables;
   for (MFVariable *variable : variable_by_field.values()) {
-    builder.add_destruct(*variable);
+    if (already_output_variables.contains(variable)) {
+      continue;
+    }
+    if (destructed_variables.add(variable)) {
+      builder.add_destruct(*variable);
+    }
   }
 
   MFReturnInstruction &return_instr = builder.add_return();
@@ -289,4 +289,33 @@ TEST(field, IgnoredOutput)
   EXPECT_EQ(results.get(3), 5);
 }
 
+TEST(field, CommonSubexpression)
+{
+  static int call_count = 0;
+  static CustomMF_SI_SO<int, int> add_10_fn{"add_10", [](int a) {
+                                              call_count++;
+                                              return a + 10;
+                                            }};
+  GField index_field{std::make_shared<IndexFieldInput>()};
+
+  /* Two separate operations that compute the same values. */
+  Field<int> field_1{std::make_shared<FieldOperation>(add_10_fn, Vector<GField>{index_field}), 0};
+  Field<int> field_2{std::make_shared<FieldOperation>(add_10_fn, Vector<GField>{index_field}), 0};
+
+  call_count = 0;
+  FieldContext field_context;
+  FieldEvaluator field_evaluator{field_context, 4};
+  VArray<int> result_1;
+  VArray<int> result_2;
+  field_evaluator.add(field_1, &result_1);
+  field_evaluator.add(field_2, &result_2);
+  field_evaluator.evaluate();
+
+  EXPECT_EQ(call_count, 4);
+  EXPECT_EQ(result_1.get(0), 10);
+  EXPECT_EQ(result_1.get(3), 13);
+  EXPECT_EQ(result_2.get(0), 10);
+  EXPECT_EQ(result_2.get(3), 13);
+}
+
 }  // namespace blender::fn::tests
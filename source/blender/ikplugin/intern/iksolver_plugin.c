@@ -270,6 +270,7 @@ static void where_is_ik_bone(bPoseChannel *pchan,
   add_v3_v3v3(pchan->pose_tail, pchan->pose_head, vec);
 
   pchan->flag |= POSE_DONE;
+  BKE_pose_channel_eval_mat_invalidate(pchan);
 }
 
 /* called from within the core BKE_pose_where_is loop, all animsystems and constraints
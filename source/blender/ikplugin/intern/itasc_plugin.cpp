@@ -1713,6 +1713,7 @@ static void execute_scene(struct Depsgraph *depsgraph,
        * mark the channel done also tell Blender that this channel is part of IK tree.
        * Cleared on each BKE_pose_where_is() */
       ikchan->pchan->flag |= (POSE_DONE | POSE_CHAIN);
+      BKE_pose_channel_eval_mat_invalidate(ikchan->pchan);
       ikchan->jointValid = 0;
     }
   }
@@ -1726,6 +1727,7 @@ static void execute_scene(struct Depsgraph *depsgraph,
       /* tell blender that this channel was controlled by IK,
        * it's cleared on each BKE_pose_where_is() */
       ikchan->pchan->flag |= (POSE_DONE | POSE_CHAIN);
+      BKE_pose_channel_eval_mat_invalidate(ikchan->pchan);
       ikchan->jointValid = 0;
     }
   }
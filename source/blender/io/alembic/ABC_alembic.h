@@ -65,6 +65,8 @@ struct AlembicExportParams {
   bool export_custom_properties;
   bool use_instancing;
   enum eEvaluationMode evaluation_mode;
+  /* Evaluate multiple frames at the same time, each in its own depsgraph. */
+  bool use_concurrent_frames;
 
   /* See MOD_TRIANGULATE_NGON_xxx and MOD_TRIANGULATE_QUAD_xxx
    * in DNA_modifier_types.h */
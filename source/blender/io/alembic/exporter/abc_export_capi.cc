@@ -40,6 +40,7 @@
 #include "BLI_fileops.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 
 #include "WM_api.h"
 #include "WM_types.h"
@@ -49,6 +50,7 @@ static CLG_LogRef LOG = {"io.alembic"};
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 struct ExportJobData {
   Main *bmain;
@@ -75,6 +77,64 @@ static void build_depsgraph(Depsgraph *depsgraph, const bool visible_objects_onl
   }
 }
 
+/* Evaluate batches of frames at the same time, every frame of a batch in its own depsgraph, and
+ * write the frames in order. The depsgraph of the export job is used for the first frame of every
+ * batch. */
+static void export_frames_concurrently(ExportJobData *data,
+                                       ABCArchive *abc_archive,
+                                       ABCHierarchyIterator &iter,
+                                       short *stop,
+                                       short *do_update,
+                                       float *progress)
+{
+  Scene *scene = DEG_get_input_scene(data->depsgraph);
+  ViewLayer *view_layer = DEG_get_input_view_layer(data->depsgraph);
+  const std::vector<double> frames(abc_archive->frames_begin(), abc_archive->frames_end());
+  /* Writing the animated frames is not 100% of the work, but it's our best guess. */
+  const float progress_per_frame = 1.0f / std::max(size_t(1), frames.size());
+
+  const int num_graphs = std::clamp(BLI_system_thread_count(), 1, int(frames.size()));
+  const int num_extra_graphs = num_graphs - 1;
+  Depsgraph **extra_graphs = DEG_graphs_new(
+      data->bmain, scene, view_layer, data->params.evaluation_mode, num_extra_graphs);
+
+  std::vector<Depsgraph *> graphs;
+  graphs.push_back(data->depsgraph);
+  for (int i = 0; i < num_extra_graphs; i++) {
+    build_depsgraph(extra_graphs[i], data->params.visible_objects_only);
+    graphs.push_back(extra_graphs[i]);
+  }
+
+  std::vector<float> batch_frames(num_graphs);
+  for (size_t batch_start = 0; batch_start < frames.size(); batch_start += num_graphs) {
+    if (G.is_break || (stop != nullptr && *stop)) {
+      break;
+    }
+
+    const int batch_size = std::min(num_graphs, int(frames.size() - batch_start));
+    for (int i = 0; i < batch_size; i++) {
+      batch_frames[i] = float(frames[batch_start + i]);
+    }
+    DEG_graphs_evaluate_on_framechange(graphs.data(), batch_frames.data(), batch_size);
+
+    for (int i = 0; i < batch_size; i++) {
+      const double frame = frames[batch_start + i];
+
+      CLOG_INFO(&LOG, 2, "Exporting frame %.2f", frame);
+      iter.set_depsgraph(graphs[i]);
+      ExportSubset export_subset = abc_archive->export_subset_for_frame(frame);
+      iter.set_export_subset(export_subset);
+      iter.iterate_and_write();
+
+      *progress += progress_per_frame;
+      *do_update = true;
+    }
+  }
+
+  iter.set_depsgraph(data->depsgraph);
+  DEG_graphs_free(extra_graphs, num_extra_graphs);
+}
+
 static void export_startjob(void *customdata,
                             /* Cannot be const, this function implements wm_jobs_start_callback.
                              * NOLINTNEXTLINE: readability-non-const-parameter. */
@@ -133,7 +193,11 @@ static void export_startjob(void *customdata,
 
   ABCHierarchyIterator iter(data->depsgraph, abc_archive.get(), data->params);
 
-  if (export_animation) {
+  if (export_animation && data->params.use_concurrent_frames) {
+    CLOG_INFO(&LOG, 2, "Exporting animation, evaluating frames concurrently");
+    export_frames_concurrently(data, abc_archive.get(), iter, stop, do_update, progress);
+  }
+  else if (export_animation) {
     CLOG_INFO(&LOG, 2, "Exporting animation");
 
     /* Writing the animated frames is not 100% of the work, but it's our best guess. */
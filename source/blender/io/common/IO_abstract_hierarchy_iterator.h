@@ -245,6 +245,11 @@ class AbstractHierarchyIterator {
    * previous iteration. */
   void set_export_subset(ExportSubset export_subset_);
 
+  /* Depsgraph which is iterated over. It can be changed between iterations, for example when
+   * frames are evaluated by different depsgraphs. */
+  Depsgraph *get_depsgraph() const;
+  void set_depsgraph(Depsgraph *depsgraph);
+
   /* Convert the given name to something that is valid for the exported file format.
    * This base implementation is a no-op; override in a concrete subclass. */
   virtual std::string make_valid_name(const std::string &name) const;
@@ -38,6 +38,7 @@
 extern "C" {
 #endif
 
+struct ActionEvalProgram;
 struct Collection;
 struct GHash;
 struct Object;
@@ -203,8 +204,24 @@ typedef struct bPoseChannel_Runtime {
   /* Delta from rest to pose in matrix and DualQuat form. */
   struct Mat4 *bbone_deform_mats;
   struct DualQuat *bbone_dual_quats;
+
+  /* Channel matrix from which the pose matrix was computed by the last evaluation of the bone,
+   * used to keep the pose matrix when nothing changed. See #BKE_pose_eval_bone. */
+  float eval_chan_mat[4][4];
+
+  /* ePoseChannelRuntimeFlag */
+  int flag;
+  char _pad[4];
 } bPoseChannel_Runtime;
 
+/* bPoseChannel_Runtime->flag */
+typedef enum ePoseChannelRuntimeFlag {
+  /* The pose matrix was computed from eval_chan_mat and the pose matrix of the parent. */
+  POSE_RUNTIME_EVAL_CHAN_MAT_VALID = (1 << 0),
+  /* The pose matrix was changed by the last evaluation of the bone. */
+  POSE_RUNTIME_EVAL_CHANGED = (1 << 1),
+} ePoseChannelRuntimeFlag;
+
 /* ************************************************ */
 /* Poses */
 
@@ -647,6 +664,11 @@ typedef enum eActionGroup_Flag {
 
 /* Actions -------------------------------------- */
 
+typedef struct bAction_Runtime {
+  /** Compiled F-Curves, only used by evaluated actions (#ActionEvalProgram). */
+  struct ActionEvalProgram *eval_program;
+} bAction_Runtime;
+
 /* Action - reusable F-Curve 'bag'  (act)
  *
  * This contains F-Curves that may affect settings from more than one ID blocktype and/or datablock
@@ -687,6 +709,8 @@ typedef struct bAction {
   float frame_start, frame_end;
 
   PreviewImage *preview;
+
+  bAction_Runtime runtime;
 } bAction;
 
 /* Flags for the action */
@@ -1117,6 +1117,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime data, resolved RNA paths of the F-Curves of evaluated actions. */
+  struct AnimEvalRNACache *eval_rna_cache;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
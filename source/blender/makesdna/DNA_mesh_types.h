@@ -141,7 +141,11 @@ typedef struct Mesh_Runtime {
   char _pad[2];
   int subsurf_resolution;
 
-  void *_pad2;
+  /**
+   * Cache of vertex group weights in a compact layout for armature deform, only used for
+   * copy-on-write meshes. Defined in `armature_deform.c`.
+   */
+  struct ArmatureDeformWeights *deform_weights;
 
   /**
    * Used to mark when derived data needs to be recalculated for a certain layer.
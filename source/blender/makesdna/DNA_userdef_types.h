@@ -666,7 +666,7 @@ typedef struct UserDef_Experimental {
   char use_sculpt_tools_tilt;
   char use_extended_asset_browser;
   char use_override_templates;
-  char _pad[1];
+  char use_undo_skip_unchanged_ids;
   /** `makesdna` does not allow empty structs. */
 } UserDef_Experimental;
 
@@ -685,7 +685,8 @@ typedef struct UserDef {
   char pref_flag;
   char savetime;
   char mouse_emulate_3_button_modifier;
-  char _pad4[1];
+  /** Zstandard compression level used when saving compressed files. */
+  char file_compression_level;
   /** FILE_MAXDIR length. */
   char tempdir[768];
   char fontdir[768];
@@ -814,7 +815,8 @@ typedef struct UserDef {
   int prefetchframes;
   /** Control the rotation step of the view when PAD2, PAD4, PAD6&PAD8 is use. */
   float pad_rot_angle;
-  char _pad12[4];
+  /** Memory limit of the geometry nodes output cache in megabytes, zero disables the cache. */
+  int geometry_nodes_cache_limit;
   /** Rotating view icon size. */
   short rvisize;
   /** Rotating view icon brightness. */
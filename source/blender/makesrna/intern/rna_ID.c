@@ -928,6 +928,11 @@ static void rna_ID_update_tag(ID *id, Main *bmain, ReportList *reports, int flag
                   allow_flag ? "the specified" : "any");
       return;
     }
+
+    /* Scripts may change any data before tagging (ID properties, `foreach_set()`, ...), so make
+     * sure the whole data-block is copied to its evaluated version and not only the parts which
+     * the dependency graph associates with the given flags (such as the object transform). */
+    flag |= ID_RECALC_COPY_ON_WRITE;
   }
 
   DEG_id_tag_update_ex(bmain, id, flag);
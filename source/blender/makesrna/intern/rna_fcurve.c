@@ -233,7 +233,7 @@ static void rna_ChannelDriver_update_data(Main *bmain, Scene *scene, PointerRNA
   driver->flag &= ~DRIVER_FLAG_INVALID;
 
   /* TODO: this really needs an update guard... */
-  DEG_relations_tag_update(bmain);
+  DEG_id_tag_relations_update(bmain, id);
   DEG_id_tag_update(id, ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY);
 
   WM_main_add_notifier(NC_SCENE | ND_FRAME, scene);
@@ -656,7 +656,8 @@ static void rna_FieldSettings_update(Main *UNUSED(bmain), Scene *UNUSED(scene),
       DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
     }
 
-    DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+    /* Field settings are not a part of the object transform, so copy-on-write is needed. */
+    DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM | ID_RECALC_COPY_ON_WRITE);
     WM_main_add_notifier(NC_OBJECT | ND_DRAW, ob);
   }
 }
@@ -667,7 +668,8 @@ static void rna_FieldSettings_shape_update(Main *bmain, Scene *scene, PointerRNA
     Object *ob = (Object *)ptr->owner_id;
     ED_object_check_force_modifiers(bmain, scene, ob);
 
-    DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+    /* Field settings are not a part of the object transform, so copy-on-write is needed. */
+    DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM | ID_RECALC_COPY_ON_WRITE);
     WM_main_add_notifier(NC_OBJECT | ND_DRAW, ob);
     WM_main_add_notifier(NC_OBJECT | ND_MODIFIER, ob);
   }
@@ -201,6 +201,8 @@ static const EnumPropertyItem rna_enum_userdef_viewport_aa_items[] = {
 #  include "MEM_CacheLimiterC-Api.h"
 #  include "MEM_guardedalloc.h"
 
+#  include "MOD_nodes.h"
+
 #  include "UI_interface.h"
 
 #  ifdef WITH_OPENSUBDIV
@@ -607,6 +609,14 @@ static void rna_Userdef_memcache_update(Main *UNUSED(bmain),
   USERDEF_TAG_DIRTY;
 }
 
+static void rna_Userdef_geometry_nodes_cache_update(Main *UNUSED(bmain),
+                                                    Scene *UNUSED(scene),
+                                                    PointerRNA *UNUSED(ptr))
+{
+  MOD_nodes_output_cache_free();
+  USERDEF_TAG_DIRTY;
+}
+
 static void rna_Userdef_disk_cache_dir_update(Main *UNUSED(bmain),
                                               Scene *UNUSED(scene),
                                               PointerRNA *UNUSED(ptr))
@@ -5502,6 +5512,15 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "geometry_nodes_cache_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "geometry_nodes_cache_limit");
+  RNA_def_property_range(prop, 0, max_memory_in_megabytes_int());
+  RNA_def_property_ui_text(prop,
+                           "Geometry Nodes Cache Limit",
+                           "Memory limit for geometry created by primitive nodes, which is kept "
+                           "between evaluations (in megabytes, zero disables the cache)");
+  RNA_def_property_update(prop, 0, "rna_Userdef_geometry_nodes_cache_update");
+
   /* Sequencer disk cache */
 
   prop = RNA_def_property(srna, "use_sequencer_disk_cache", PROP_BOOLEAN, PROP_NONE);
@@ -6205,6 +6224,13 @@ static void rna_def_userdef_filepaths(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Compress File", "Enable file compression when saving .blend files");
 
+  prop = RNA_def_property(srna, "file_compression_level", PROP_INT, PROP_NONE);
+  RNA_def_property_range(prop, 1, 19);
+  RNA_def_property_ui_text(prop,
+                           "Compression Level",
+                           "Compression level used when saving compressed .blend files, "
+                           "lower levels save faster but result in larger files");
+
   prop = RNA_def_property(srna, "use_load_ui", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, NULL, "flag", USER_FILENOUI);
   RNA_def_property_ui_text(prop, "Load UI", "Load user interface setup when loading .blend files");
@@ -6450,6 +6476,15 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Override Templates", "Enable library override template in the python API");
 
+  prop = RNA_def_property(srna, "use_undo_skip_unchanged_ids", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_undo_skip_unchanged_ids", 1);
+  RNA_def_property_ui_text(prop,
+                           "Undo Skip Unchanged Data",
+                           "Re-use the previous undo step's memory for data-blocks that were not "
+                           "tagged as changed since then, instead of writing them again "
+                           "(faster undo pushes in heavy scenes, changes that are not tagged for "
+                           "update may not be undone)");
+
   prop = RNA_def_property(srna, "use_geometry_nodes_legacy", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "use_geometry_nodes_legacy", 1);
   RNA_def_property_ui_text(
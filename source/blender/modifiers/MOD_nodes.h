@@ -33,6 +33,12 @@ void MOD_nodes_update_interface(struct Object *object, struct NodesModifierData
 
 void MOD_nodes_init(struct Main *bmain, struct NodesModifierData *nmd);
 
+/**
+ * Free the outputs of primitive nodes that are cached between evaluations. This should be called
+ * when the cached geometry is not likely to be used anymore or the memory is needed elsewhere.
+ */
+void MOD_nodes_output_cache_free(void);
+
 #ifdef __cplusplus
 }
 #endif
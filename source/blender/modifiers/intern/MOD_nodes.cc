@@ -729,6 +729,11 @@ void MOD_nodes_init(Main *bmain, NodesModifierData *nmd)
   BKE_ntree_update_main_tree(bmain, ntree, nullptr);
 }
 
+void MOD_nodes_output_cache_free()
+{
+  blender::modifiers::geometry_nodes::free_node_output_cache();
+}
+
 static void initialize_group_input(NodesModifierData &nmd,
                                    const OutputSocketRef &socket,
                                    void *r_value)
@@ -15,6 +15,7 @@
  */
 
 #include "MOD_nodes_evaluator.hh"
+#include "MOD_nodes_output_cache.hh"
 
 #include "BKE_type_conversions.hh"
 
@@ -30,6 +31,10 @@
 
 #include "BLT_translation.h"
 
+#include "DNA_userdef_types.h"
+
+#include "MEM_guardedalloc.h"
+
 #include "BLI_enumerable_thread_specific.hh"
 #include "BLI_stack.hh"
 #include "BLI_task.h"
@@ -37,6 +42,8 @@
 #include "BLI_vector_set.hh"
 
 #include <chrono>
+#include <memory>
+#include <mutex>
 
 namespace blender::modifiers::geometry_nodes {
 
@@ -417,6 +424,170 @@ static bool node_supports_laziness(const DNode node)
   return node->typeinfo()->geometry_node_execute_supports_laziness;
 }
 
+/**
+ * These nodes always create the same geometry for the same inputs and properties. Their outputs
+ * are kept in a global cache, so that evaluating them again (e.g. on frame changes or when an
+ * unrelated part of the node tree changed) becomes a lookup. Input geometry is part of the cache
+ * key through a hash of its content. The geometry is shared with the cache, so nodes that modify
+ * it further copy the data first. The memory used by the cache is limited in the preferences, a
+ * limit of zero turns caching off.
+ */
+static bool node_supports_output_caching(const DNode node)
+{
+  switch (node->bnode()->type) {
+    case GEO_NODE_MESH_PRIMITIVE_CUBE:
+    case GEO_NODE_MESH_PRIMITIVE_CIRCLE:
+    case GEO_NODE_MESH_PRIMITIVE_UV_SPHERE:
+    case GEO_NODE_MESH_PRIMITIVE_CYLINDER:
+    case GEO_NODE_MESH_PRIMITIVE_ICO_SPHERE:
+    case GEO_NODE_MESH_PRIMITIVE_CONE:
+    case GEO_NODE_MESH_PRIMITIVE_LINE:
+    case GEO_NODE_MESH_PRIMITIVE_GRID:
+    case GEO_NODE_CURVE_PRIMITIVE_STAR:
+    case GEO_NODE_CURVE_PRIMITIVE_SPIRAL:
+    case GEO_NODE_CURVE_PRIMITIVE_QUADRATIC_BEZIER:
+    case GEO_NODE_CURVE_PRIMITIVE_BEZIER_SEGMENT:
+    case GEO_NODE_CURVE_PRIMITIVE_CIRCLE:
+    case GEO_NODE_CURVE_PRIMITIVE_LINE:
+    case GEO_NODE_CURVE_PRIMITIVE_QUADRILATERAL:
+    case GEO_NODE_CURVE_PRIMITIVE_ARC:
+    case GEO_NODE_DISTRIBUTE_POINTS_ON_FACES:
+    case GEO_NODE_INSTANCE_ON_POINTS:
+    case GEO_NODE_SUBDIVISION_SURFACE:
+    case GEO_NODE_SUBDIVIDE_MESH:
+    case GEO_NODE_TRIANGULATE:
+    case GEO_NODE_CONVEX_HULL:
+    case GEO_NODE_DUAL_MESH:
+      return true;
+  }
+  return false;
+}
+
+/**
+ * The cache is shared by all evaluations. It is created when the first outputs are added and
+ * freed with #free_node_output_cache, so the geometry it holds does not outlive the file.
+ */
+static std::mutex node_output_cache_mutex;
+static std::unique_ptr<NodeOutputCache> node_output_cache;
+
+/** Memory limit of the cache from the preferences, zero disables caching. */
+static int64_t node_output_cache_limit()
+{
+  return int64_t(U.geometry_nodes_cache_limit) * 1024 * 1024;
+}
+
+static bool node_output_cache_lookup(const NodeOutputCacheKey &key,
+                                     Span<int> output_indices,
+                                     Vector<GeometrySet> &r_geometries)
+{
+  std::lock_guard lock{node_output_cache_mutex};
+  if (!node_output_cache) {
+    return false;
+  }
+  return node_output_cache->lookup(key, output_indices, r_geometries);
+}
+
+static void node_output_cache_add(NodeOutputCacheKey key, NodeOutputCacheEntry entry)
+{
+  std::lock_guard lock{node_output_cache_mutex};
+  if (!node_output_cache) {
+    node_output_cache = std::make_unique<NodeOutputCache>();
+  }
+  node_output_cache->add(std::move(key), std::move(entry), node_output_cache_limit());
+}
+
+void free_node_output_cache()
+{
+  std::lock_guard lock{node_output_cache_mutex};
+  node_output_cache.reset();
+}
+
+/**
+ * Find the outputs that have to be computed. Only nodes whose used outputs are all geometries
+ * are cached, field outputs reference anonymous attributes that are created during evaluation.
+ */
+static bool node_output_cache_required_outputs(const DNode node,
+                                               const NodeState &node_state,
+                                               Vector<int> &r_output_indices)
+{
+  for (const int i : node->outputs().index_range()) {
+    const OutputSocketRef &socket_ref = node->output(i);
+    const OutputState &output_state = node_state.outputs[i];
+    if (!socket_ref.is_available()) {
+      continue;
+    }
+    if (output_state.output_usage_for_execution == ValueUsage::Unused) {
+      continue;
+    }
+    if (output_state.has_been_computed || socket_ref.typeinfo()->type != SOCK_GEOMETRY) {
+      return false;
+    }
+    r_output_indices.append(i);
+  }
+  return !r_output_indices.is_empty();
+}
+
+static bool node_output_cache_key_build(const DNode node,
+                                        const NodeState &node_state,
+                                        NodeOutputCacheKey &r_key)
+{
+  const bNode &bnode = *node->bnode();
+
+  r_key.append(&bnode.type, sizeof(bnode.type));
+  r_key.append(&bnode.custom1, sizeof(bnode.custom1));
+  r_key.append(&bnode.custom2, sizeof(bnode.custom2));
+  r_key.append(&bnode.custom3, sizeof(bnode.custom3));
+  r_key.append(&bnode.custom4, sizeof(bnode.custom4));
+  if (bnode.storage != nullptr) {
+    r_key.append(bnode.storage, MEM_allocN_len(bnode.storage));
+  }
+
+  for (const int i : node->inputs().index_range()) {
+    const InputSocketRef &socket_ref = node->input(i);
+    const InputState &input_state = node_state.inputs[i];
+    if (input_state.type == nullptr || !socket_ref.is_available()) {
+      continue;
+    }
+    if (socket_ref.is_multi_input_socket()) {
+      return false;
+    }
+    if (input_state.type == &CPPType::get<GeometrySet>()) {
+      const GeometrySet *geometry_set = static_cast<const GeometrySet *>(
+          input_state.value.single->value);
+      if (geometry_set == nullptr) {
+        return false;
+      }
+      r_key.append(&i, sizeof(i));
+      if (!r_key.append_geometry(*geometry_set)) {
+        return false;
+      }
+      continue;
+    }
+    const ValueOrFieldCPPType *type = dynamic_cast<const ValueOrFieldCPPType *>(
+        input_state.type);
+    if (type == nullptr || !type->base_type().is_trivial()) {
+      return false;
+    }
+    const void *value = input_state.value.single->value;
+    if (value == nullptr) {
+      return false;
+    }
+    r_key.append(&i, sizeof(i));
+    if (type->is_field(value)) {
+      /* Unlinked inputs only have a field value when it is the implicit field of the socket (e.g.
+       * the index), which is the same for every evaluation of the node type. */
+      if (socket_ref.is_logically_linked()) {
+        return false;
+      }
+      continue;
+    }
+    r_key.append(type->get_value_ptr(value), type->base_type().size());
+  }
+
+  r_key.update_hash();
+  return true;
+}
+
 struct NodeTaskRunState {
   /** The node that should be run on the same thread after the current node finished. */
   DNode next_node_to_run;
@@ -430,6 +601,9 @@ class NodeParamsProvider : public nodes::GeoNodeExecParamsProvider {
   NodeTaskRunState *run_state_;
 
  public:
+  /** When set, geometry outputs are also copied into this entry of the node output cache. */
+  NodeOutputCacheEntry *output_cache_entry = nullptr;
+
   NodeParamsProvider(GeometryNodesEvaluator &evaluator,
                      DNode dnode,
                      NodeState &node_state,
@@ -996,16 +1170,80 @@ class GeometryNodesEvaluator {
   {
     const bNode &bnode = *node->bnode();
 
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point begin = Clock::now();
+
+    NodeOutputCacheKey cache_key;
+    Vector<int> cache_output_indices;
+    const bool use_output_cache = node_output_cache_limit() > 0 &&
+                                  node_supports_output_caching(node) &&
+                                  node_output_cache_required_outputs(
+                                      node, node_state, cache_output_indices) &&
+                                  node_output_cache_key_build(node, node_state, cache_key);
+    if (use_output_cache && this->forward_cached_outputs(
+                                node, node_state, cache_key, cache_output_indices, run_state)) {
+      this->log_execution_time(node, begin, Clock::now());
+      return;
+    }
+
+    NodeOutputCacheEntry cache_entry;
     NodeParamsProvider params_provider{*this, node, node_state, run_state};
+    if (use_output_cache) {
+      params_provider.output_cache_entry = &cache_entry;
+    }
     GeoNodeExecParams params{params_provider};
     if (node->idname().find("Legacy") != StringRef::not_found) {
       params.error_message_add(geo_log::NodeWarningType::Legacy,
                                TIP_("Legacy node will be removed before Blender 4.0"));
     }
-    using Clock = std::chrono::steady_clock;
-    Clock::time_point begin = Clock::now();
     bnode.typeinfo->geometry_node_execute(params);
-    Clock::time_point end = Clock::now();
+    this->log_execution_time(node, begin, Clock::now());
+
+    if (use_output_cache) {
+      /* Empty outputs are not cached, nodes output those when there was an error, and the error
+       * message would be lost when the node is not executed again. */
+      for (const int output_index : cache_output_indices) {
+        const GeometrySet *geometry = cache_entry.geometries.lookup_ptr(output_index);
+        if (geometry == nullptr || geometry->is_empty()) {
+          return;
+        }
+      }
+      node_output_cache_add(std::move(cache_key), std::move(cache_entry));
+    }
+  }
+
+  /**
+   * Forward geometry from the node output cache instead of executing the node.
+   * \return False when the outputs are not cached.
+   */
+  bool forward_cached_outputs(const DNode node,
+                              NodeState &node_state,
+                              const NodeOutputCacheKey &cache_key,
+                              Span<int> output_indices,
+                              NodeTaskRunState *run_state)
+  {
+    Vector<GeometrySet> geometries;
+    if (!node_output_cache_lookup(cache_key, output_indices, geometries)) {
+      return false;
+    }
+    LinearAllocator<> &allocator = local_allocators_.local();
+    const CPPType &type = CPPType::get<GeometrySet>();
+    for (const int i : output_indices.index_range()) {
+      const DOutputSocket socket = node.output(output_indices[i]);
+      OutputState &output_state = node_state.outputs[output_indices[i]];
+      GeometrySet *buffer = static_cast<GeometrySet *>(
+          allocator.allocate(type.size(), type.alignment()));
+      new (buffer) GeometrySet(std::move(geometries[i]));
+      this->forward_output(socket, {type, buffer}, run_state);
+      output_state.has_been_computed = true;
+    }
+    return true;
+  }
+
+  void log_execution_time(const DNode node,
+                          const std::chrono::steady_clock::time_point begin,
+                          const std::chrono::steady_clock::time_point end)
+  {
     const std::chrono::microseconds duration =
         std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
     if (params_.geo_logger != nullptr) {
@@ -1868,6 +2106,9 @@ void NodeParamsProvider::set_output(StringRef identifier, GMutablePointer value)
 
   OutputState &output_state = node_state_.outputs[socket->index()];
   BLI_assert(!output_state.has_been_computed);
+  if (output_cache_entry != nullptr && value.type() == &CPPType::get<GeometrySet>()) {
+    output_cache_entry->geometries.add_overwrite(socket->index(), *value.get<GeometrySet>());
+  }
   evaluator_.forward_output(socket, value, run_state_);
   output_state.has_been_computed = true;
 }
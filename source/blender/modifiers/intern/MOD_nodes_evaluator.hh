@@ -58,4 +58,7 @@ struct GeometryNodesEvaluationParams {
 
 void evaluate_geometry_nodes(GeometryNodesEvaluationParams &params);
 
+/** Free the geometry of primitive nodes that is kept between evaluations. */
+void free_node_output_cache();
+
 }  // namespace blender::modifiers::geometry_nodes
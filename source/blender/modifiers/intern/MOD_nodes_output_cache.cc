@@ -0,0 +1,253 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup modifiers
+ */
+
+#include "MOD_nodes_output_cache.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_attribute_access.hh"
+#include "BKE_customdata.h"
+
+#include "BLI_hash_mm2a.h"
+#include "BLI_listbase.h"
+
+namespace blender::modifiers::geometry_nodes {
+
+void NodeOutputCacheKey::append(const void *src, const int64_t size)
+{
+  data.extend(Span<uint8_t>(static_cast<const uint8_t *>(src), size));
+}
+
+void NodeOutputCacheKey::update_hash()
+{
+  hash_value = BLI_hash_mm2(data.data(), size_t(data.size()), 0);
+}
+
+/* Two hashes with different seeds, so that different content practically never has the same
+ * fingerprint. */
+static const uint32_t fingerprint_seeds[2] = {0, 0x9e3779b9};
+
+static void append_fingerprint(NodeOutputCacheKey &key, const void *data, const size_t size)
+{
+  for (const uint32_t seed : fingerprint_seeds) {
+    const uint32_t hash = BLI_hash_mm2(static_cast<const unsigned char *>(data), size, seed);
+    key.append(&hash, sizeof(hash));
+  }
+}
+
+static void append_deform_verts_fingerprint(NodeOutputCacheKey &key,
+                                            const MDeformVert *dverts,
+                                            const int size)
+{
+  for (const uint32_t seed : fingerprint_seeds) {
+    BLI_HashMurmur2A mm2;
+    BLI_hash_mm2a_init(&mm2, seed);
+    for (const MDeformVert &dvert : Span(dverts, size)) {
+      BLI_hash_mm2a_add_int(&mm2, dvert.totweight);
+      BLI_hash_mm2a_add(&mm2,
+                        reinterpret_cast<const unsigned char *>(dvert.dw),
+                        sizeof(MDeformWeight) * size_t(dvert.totweight));
+    }
+    const uint32_t hash = BLI_hash_mm2a_end(&mm2);
+    key.append(&hash, sizeof(hash));
+  }
+}
+
+static bool append_custom_data(NodeOutputCacheKey &key, const CustomData &data, const int size)
+{
+  key.append(&size, sizeof(size));
+  for (const CustomDataLayer &layer : Span(data.layers, data.totlayer)) {
+    if (layer.anonymous_id != nullptr) {
+      return false;
+    }
+    if (layer.data == nullptr) {
+      continue;
+    }
+    key.append(&layer.type, sizeof(layer.type));
+    key.append(layer.name, int64_t(strlen(layer.name)) + 1);
+    switch (layer.type) {
+      case CD_MDEFORMVERT:
+        append_deform_verts_fingerprint(key, static_cast<const MDeformVert *>(layer.data), size);
+        break;
+      case CD_MDISPS:
+      case CD_GRID_PAINT_MASK:
+      case CD_BM_ELEM_PYPTR:
+        /* Layers referencing other memory. */
+        return false;
+      default:
+        append_fingerprint(key, layer.data, size_t(CustomData_sizeof(layer.type)) * size_t(size));
+        break;
+    }
+  }
+  return true;
+}
+
+/* Materials are only referenced, the same pointers mean the same materials. */
+static void append_materials(NodeOutputCacheKey &key, const void *materials, const int len)
+{
+  key.append(&len, sizeof(len));
+  if (len > 0) {
+    key.append(materials, int64_t(sizeof(void *)) * len);
+  }
+}
+
+bool NodeOutputCacheKey::append_geometry(const GeometrySet &geometry_set)
+{
+  for (const GeometryComponent *component : geometry_set.get_components_for_read()) {
+    const GeometryComponentType type = component->type();
+    this->append(&type, sizeof(type));
+    switch (type) {
+      case GEO_COMPONENT_TYPE_MESH: {
+        const Mesh *mesh = static_cast<const MeshComponent *>(component)->get_for_read();
+        if (mesh == nullptr) {
+          break;
+        }
+        if (!append_custom_data(*this, mesh->vdata, mesh->totvert) ||
+            !append_custom_data(*this, mesh->edata, mesh->totedge) ||
+            !append_custom_data(*this, mesh->ldata, mesh->totloop) ||
+            !append_custom_data(*this, mesh->pdata, mesh->totpoly)) {
+          return false;
+        }
+        append_materials(*this, mesh->mat, mesh->totcol);
+        LISTBASE_FOREACH (const bDeformGroup *, defgroup, &mesh->vertex_group_names) {
+          this->append(defgroup->name, int64_t(strlen(defgroup->name)) + 1);
+        }
+        this->append(&mesh->flag, sizeof(mesh->flag));
+        this->append(&mesh->smoothresh, sizeof(mesh->smoothresh));
+        break;
+      }
+      case GEO_COMPONENT_TYPE_POINT_CLOUD: {
+        const PointCloud *pointcloud =
+            static_cast<const PointCloudComponent *>(component)->get_for_read();
+        if (pointcloud == nullptr) {
+          break;
+        }
+        if (!append_custom_data(*this, pointcloud->pdata, pointcloud->totpoint)) {
+          return false;
+        }
+        append_materials(*this, pointcloud->mat, pointcloud->totcol);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+bool NodeOutputCache::lookup(const NodeOutputCacheKey &key,
+                             Span<int> output_indices,
+                             Vector<GeometrySet> &r_geometries)
+{
+  NodeOutputCacheEntry *entry = entries_.lookup_ptr(key);
+  if (entry == nullptr) {
+    return false;
+  }
+  for (const int output_index : output_indices) {
+    if (!entry->geometries.contains(output_index)) {
+      return false;
+    }
+  }
+  for (const int output_index : output_indices) {
+    r_geometries.append(entry->geometries.lookup(output_index));
+  }
+  entry->last_used = ++clock_;
+  return true;
+}
+
+void NodeOutputCache::add(NodeOutputCacheKey key,
+                          NodeOutputCacheEntry entry,
+                          const int64_t max_size_in_bytes)
+{
+  entry.size_in_bytes = 0;
+  for (const GeometrySet &geometry_set : entry.geometries.values()) {
+    entry.size_in_bytes += geometry_set_size_in_bytes(geometry_set);
+  }
+  if (entry.size_in_bytes > max_size_in_bytes) {
+    return;
+  }
+  const NodeOutputCacheEntry *old_entry = entries_.lookup_ptr(key);
+  if (old_entry != nullptr) {
+    size_in_bytes_ -= old_entry->size_in_bytes;
+  }
+  entry.last_used = ++clock_;
+  size_in_bytes_ += entry.size_in_bytes;
+  entries_.add_overwrite(std::move(key), std::move(entry));
+  this->shrink(max_size_in_bytes);
+}
+
+void NodeOutputCache::shrink(const int64_t max_size_in_bytes)
+{
+  while (size_in_bytes_ > max_size_in_bytes) {
+    const NodeOutputCacheKey *oldest_key = nullptr;
+    const NodeOutputCacheEntry *oldest_entry = nullptr;
+    for (auto item : entries_.items()) {
+      if (oldest_entry == nullptr || item.value.last_used < oldest_entry->last_used) {
+        oldest_key = &item.key;
+        oldest_entry = &item.value;
+      }
+    }
+    size_in_bytes_ -= oldest_entry->size_in_bytes;
+    /* Copy the key, because removing the entry also frees the key it points to. */
+    entries_.remove(NodeOutputCacheKey(*oldest_key));
+  }
+}
+
+static int64_t custom_data_size_in_bytes(const CustomData &data, const int64_t size)
+{
+  int64_t size_in_bytes = 0;
+  for (const CustomDataLayer &layer : Span(data.layers, data.totlayer)) {
+    size_in_bytes += int64_t(CustomData_sizeof(layer.type)) * size;
+  }
+  return size_in_bytes;
+}
+
+int64_t geometry_set_size_in_bytes(const GeometrySet &geometry_set)
+{
+  int64_t size_in_bytes = 0;
+  for (const GeometryComponent *component : geometry_set.get_components_for_read()) {
+    if (component->type() == GEO_COMPONENT_TYPE_MESH) {
+      /* Not all mesh data is exposed as attributes. */
+      const Mesh *mesh = static_cast<const MeshComponent *>(component)->get_for_read();
+      if (mesh != nullptr) {
+        size_in_bytes += custom_data_size_in_bytes(mesh->vdata, mesh->totvert);
+        size_in_bytes += custom_data_size_in_bytes(mesh->edata, mesh->totedge);
+        size_in_bytes += custom_data_size_in_bytes(mesh->ldata, mesh->totloop);
+        size_in_bytes += custom_data_size_in_bytes(mesh->pdata, mesh->totpoly);
+      }
+      continue;
+    }
+    component->attribute_foreach(
+        [&](const bke::AttributeIDRef & /*attribute_id*/, const AttributeMetaData &meta_data) {
+          const fn::CPPType *type = bke::custom_data_type_to_cpp_type(meta_data.data_type);
+          if (type != nullptr) {
+            size_in_bytes += type->size() *
+                             int64_t(component->attribute_domain_size(meta_data.domain));
+          }
+          return true;
+        });
+  }
+  return size_in_bytes;
+}
+
+}  // namespace blender::modifiers::geometry_nodes
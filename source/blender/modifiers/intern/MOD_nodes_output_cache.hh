@@ -0,0 +1,117 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup modifiers
+ *
+ * Cache of the geometry created by nodes, kept between evaluations of geometry node trees.
+ */
+
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_geometry_set.hh"
+
+namespace blender::modifiers::geometry_nodes {
+
+/**
+ * Identifies a node evaluation by the node type, its properties and its input values. Single
+ * values are stored as raw bytes, so only trivial ones can be part of a key. Geometry inputs are
+ * stored as a hash of their content.
+ */
+struct NodeOutputCacheKey {
+  Vector<uint8_t> data;
+  uint64_t hash_value = 0;
+
+  void append(const void *src, int64_t size);
+  /**
+   * Append a fingerprint of the content of the geometry instead of the data itself. Only meshes
+   * and point clouds without anonymous attributes are supported, anonymous attributes belong to
+   * a single evaluation so cached outputs propagating them could not be used by later ones.
+   * \return False when the geometry cannot be part of a key.
+   */
+  bool append_geometry(const GeometrySet &geometry_set);
+  /** Has to be called after all data has been appended. */
+  void update_hash();
+
+  uint64_t hash() const
+  {
+    return hash_value;
+  }
+
+  friend bool operator==(const NodeOutputCacheKey &a, const NodeOutputCacheKey &b)
+  {
+    return a.hash_value == b.hash_value && a.data.as_span() == b.data.as_span();
+  }
+};
+
+struct NodeOutputCacheEntry {
+  /** Geometry computed for each output socket, the key is the socket index. */
+  Map<int, GeometrySet> geometries;
+  uint64_t last_used = 0;
+  int64_t size_in_bytes = 0;
+};
+
+/**
+ * Outputs of nodes, bounded by the memory used by their geometry. The least recently used entries
+ * are removed first. Access is not thread-safe.
+ */
+class NodeOutputCache {
+ private:
+  Map<NodeOutputCacheKey, NodeOutputCacheEntry> entries_;
+  uint64_t clock_ = 0;
+  int64_t size_in_bytes_ = 0;
+
+ public:
+  /**
+   * Copy the cached geometry of all the given outputs into `r_geometries`.
+   * \return False when any of the outputs is not cached.
+   */
+  bool lookup(const NodeOutputCacheKey &key,
+              Span<int> output_indices,
+              Vector<GeometrySet> &r_geometries);
+
+  /**
+   * Add the outputs of a node evaluation, removing the least recently used entries until the
+   * memory used by the cache is within `max_size_in_bytes`. Entries which are larger than the
+   * limit on their own are not added.
+   */
+  void add(NodeOutputCacheKey key, NodeOutputCacheEntry entry, int64_t max_size_in_bytes);
+
+  /** Remove least recently used entries until the cache is within `max_size_in_bytes`. */
+  void shrink(int64_t max_size_in_bytes);
+
+  int64_t size() const
+  {
+    return entries_.size();
+  }
+
+  int64_t size_in_bytes() const
+  {
+    return size_in_bytes_;
+  }
+};
+
+/**
+ * Estimate of the memory used by the geometry. Only the attribute arrays are counted, which are
+ * the bulk of the memory of generated geometry.
+ */
+int64_t geometry_set_size_in_bytes(const GeometrySet &geometry_set);
+
+}  // namespace blender::modifiers::geometry_nodes
@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "testing/testing.h"
+
+#include "MOD_nodes_output_cache.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_anonymous_attribute.h"
+#include "BKE_customdata.h"
+#include "BKE_idtype.h"
+#include "BKE_mesh.h"
+#include "BKE_node.h"
+#include "BKE_pointcloud.h"
+
+namespace blender::modifiers::geometry_nodes::tests {
+
+class NodeOutputCacheTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+
+ protected:
+  /* Key of a cube primitive node with the given size input. */
+  static NodeOutputCacheKey cube_key(const float size)
+  {
+    NodeOutputCacheKey key;
+    const short type = GEO_NODE_MESH_PRIMITIVE_CUBE;
+    const int input_index = 0;
+    key.append(&type, sizeof(type));
+    key.append(&input_index, sizeof(input_index));
+    key.append(&size, sizeof(size));
+    key.update_hash();
+    return key;
+  }
+
+  static NodeOutputCacheEntry mesh_entry(const int verts_num)
+  {
+    NodeOutputCacheEntry entry;
+    Mesh *mesh = BKE_mesh_new_nomain(verts_num, 0, 0, 0, 0);
+    entry.geometries.add(0, GeometrySet::create_with_mesh(mesh));
+    return entry;
+  }
+
+  static int64_t mesh_entry_size(const int verts_num)
+  {
+    return geometry_set_size_in_bytes(mesh_entry(verts_num).geometries.lookup(0));
+  }
+
+  static bool lookup(NodeOutputCache &cache, const NodeOutputCacheKey &key)
+  {
+    Vector<GeometrySet> geometries;
+    return cache.lookup(key, {0}, geometries);
+  }
+};
+
+TEST_F(NodeOutputCacheTest, Reuse)
+{
+  NodeOutputCache cache;
+  NodeOutputCacheEntry entry = mesh_entry(8);
+  const Mesh *mesh = entry.geometries.lookup(0).get_mesh_for_read();
+  cache.add(cube_key(1.0f), std::move(entry), 1024 * 1024);
+
+  Vector<GeometrySet> geometries;
+  EXPECT_TRUE(cache.lookup(cube_key(1.0f), {0}, geometries));
+  ASSERT_EQ(geometries.size(), 1);
+  /* The geometry is shared with the cache, not copied. */
+  EXPECT_EQ(geometries[0].get_mesh_for_read(), mesh);
+
+  /* Other outputs of the node are not cached. */
+  EXPECT_FALSE(cache.lookup(cube_key(1.0f), {0, 1}, geometries));
+}
+
+TEST_F(NodeOutputCacheTest, InputChanged)
+{
+  NodeOutputCache cache;
+  cache.add(cube_key(1.0f), mesh_entry(8), 1024 * 1024);
+  EXPECT_FALSE(lookup(cache, cube_key(2.0f)));
+
+  cache.add(cube_key(2.0f), mesh_entry(8), 1024 * 1024);
+  EXPECT_TRUE(lookup(cache, cube_key(1.0f)));
+  EXPECT_TRUE(lookup(cache, cube_key(2.0f)));
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST_F(NodeOutputCacheTest, MemoryLimit)
+{
+  const int64_t entry_size = mesh_entry_size(1000);
+  EXPECT_GT(entry_size, 1000 * int64_t(sizeof(float[3])));
+  const int64_t limit = entry_size * 2;
+
+  NodeOutputCache cache;
+  cache.add(cube_key(1.0f), mesh_entry(1000), limit);
+  cache.add(cube_key(2.0f), mesh_entry(1000), limit);
+  EXPECT_EQ(cache.size_in_bytes(), entry_size * 2);
+
+  /* The least recently used entry is removed first. */
+  EXPECT_TRUE(lookup(cache, cube_key(1.0f)));
+  cache.add(cube_key(3.0f), mesh_entry(1000), limit);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.size_in_bytes(), entry_size * 2);
+  EXPECT_TRUE(lookup(cache, cube_key(1.0f)));
+  EXPECT_FALSE(lookup(cache, cube_key(2.0f)));
+  EXPECT_TRUE(lookup(cache, cube_key(3.0f)));
+
+  /* Entries larger than the limit are not added. */
+  cache.add(cube_key(4.0f), mesh_entry(3000), limit);
+  EXPECT_FALSE(lookup(cache, cube_key(4.0f)));
+  EXPECT_EQ(cache.size(), 2);
+
+  cache.shrink(0);
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.size_in_bytes(), 0);
+}
+
+static GeometrySet grid_mesh_geometry(const float z)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(4, 0, 0, 0, 0);
+  for (const int i : IndexRange(4)) {
+    mesh->mvert[i].co[0] = float(i % 2);
+    mesh->mvert[i].co[1] = float(i / 2);
+    mesh->mvert[i].co[2] = z;
+  }
+  return GeometrySet::create_with_mesh(mesh);
+}
+
+static bool geometry_key(const GeometrySet &geometry_set, NodeOutputCacheKey &r_key)
+{
+  const bool success = r_key.append_geometry(geometry_set);
+  r_key.update_hash();
+  return success;
+}
+
+TEST_F(NodeOutputCacheTest, GeometryInput)
+{
+  NodeOutputCacheKey key_a, key_b, key_c;
+  EXPECT_TRUE(geometry_key(grid_mesh_geometry(0.0f), key_a));
+  /* Separate meshes with the same content have the same key. */
+  EXPECT_TRUE(geometry_key(grid_mesh_geometry(0.0f), key_b));
+  EXPECT_TRUE(key_a == key_b);
+  /* Changed content. */
+  EXPECT_TRUE(geometry_key(grid_mesh_geometry(1.0f), key_c));
+  EXPECT_FALSE(key_a == key_c);
+
+  /* Named attributes are part of the content. */
+  GeometrySet geometry = grid_mesh_geometry(0.0f);
+  Mesh *mesh = geometry.get_mesh_for_write();
+  CustomData_add_layer_named(&mesh->vdata, CD_PROP_FLOAT, CD_CALLOC, nullptr, 4, "weight");
+  NodeOutputCacheKey key_named;
+  EXPECT_TRUE(geometry_key(geometry, key_named));
+  EXPECT_FALSE(key_a == key_named);
+
+  /* The data is not stored in the key, only its hash. */
+  EXPECT_LT(key_a.data.size(), int64_t(sizeof(MVert)) * 4);
+
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(10);
+  NodeOutputCacheKey key_points;
+  EXPECT_TRUE(geometry_key(GeometrySet::create_with_pointcloud(pointcloud), key_points));
+}
+
+TEST_F(NodeOutputCacheTest, GeometryInputUnsupported)
+{
+  /* Anonymous attributes belong to a single evaluation. */
+  GeometrySet geometry = grid_mesh_geometry(0.0f);
+  Mesh *mesh = geometry.get_mesh_for_write();
+  AnonymousAttributeID *anonymous_id = BKE_anonymous_attribute_id_new_strong("test");
+  CustomData_add_layer_anonymous(
+      &mesh->vdata, CD_PROP_FLOAT, CD_CALLOC, nullptr, 4, anonymous_id);
+  NodeOutputCacheKey key;
+  EXPECT_FALSE(key.append_geometry(geometry));
+  BKE_anonymous_attribute_id_decrement_strong(anonymous_id);
+
+  /* Instances reference other geometry. */
+  GeometrySet instances;
+  instances.get_component_for_write<InstancesComponent>();
+  NodeOutputCacheKey key_instances;
+  EXPECT_FALSE(key_instances.append_geometry(instances));
+}
+
+}  // namespace blender::modifiers::geometry_nodes::tests
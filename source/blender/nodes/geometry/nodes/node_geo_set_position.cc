@@ -48,7 +48,9 @@ static void set_computed_position_and_offset(GeometryComponent &component,
 
   switch (component.type()) {
     case GEO_COMPONENT_TYPE_MESH: {
-      Mesh *mesh = static_cast<MeshComponent &>(component).get_for_write();
+      /* The vertex layer is not shared anymore after retrieving the output attribute above. The
+       * other layers can stay shared with the input geometry. */
+      Mesh *mesh = static_cast<MeshComponent &>(component).get_for_write_with_shared_layers();
       MutableSpan<MVert> mverts{mesh->mvert, mesh->totvert};
       if (in_positions.is_same(positions.varray())) {
         devirtualize_varray(in_offsets, [&](const auto in_offsets) {
@@ -271,6 +271,25 @@ class MapRangeVectorFunction : public blender::fn::MultiFunction {
     const blender::VArray<float3> &to_max = params.readonly_single_input<float3>(4, "To Max");
     blender::MutableSpan<float3> results = params.uninitialized_single_output<float3>(5, "Vector");
 
+    if (from_min.is_single() && from_max.is_single() && to_min.is_single() &&
+        to_max.is_single()) {
+      /* Mapping with constant ranges is the common case. The ranges are only computed once, and
+       * the loop over devirtualized values can be vectorized. */
+      const float3 from_min_value = from_min.get_internal_single();
+      const float3 to_min_value = to_min.get_internal_single();
+      const float3 to_max_value = to_max.get_internal_single();
+      const float3 from_range = from_max.get_internal_single() - from_min_value;
+      const float3 to_range = to_max_value - to_min_value;
+      devirtualize_varray(values, [&](const auto &values) {
+        mask.foreach_index([&](const int64_t i) {
+          const float3 factor = math::safe_divide(values[i] - from_min_value, from_range);
+          const float3 result = factor * to_range + to_min_value;
+          results[i] = clamp_ ? clamp_range(result, to_min_value, to_max_value) : result;
+        });
+      });
+      return;
+    }
+
     for (int64_t i : mask) {
       float3 factor = math::safe_divide(values[i] - from_min[i], from_max[i] - from_min[i]);
       results[i] = factor * (to_max[i] - to_min[i]) + to_min[i];
@@ -440,6 +459,25 @@ class MapRangeFunction : public blender::fn::MultiFunction {
     const blender::VArray<float> &to_max = params.readonly_single_input<float>(4, "To Max");
     blender::MutableSpan<float> results = params.uninitialized_single_output<float>(5, "Result");
 
+    if (from_min.is_single() && from_max.is_single() && to_min.is_single() &&
+        to_max.is_single()) {
+      /* Mapping with constant ranges is the common case. The ranges are only computed once, and
+       * the loop over devirtualized values can be vectorized. */
+      const float from_min_value = from_min.get_internal_single();
+      const float to_min_value = to_min.get_internal_single();
+      const float to_max_value = to_max.get_internal_single();
+      const float from_range = from_max.get_internal_single() - from_min_value;
+      const float to_range = to_max_value - to_min_value;
+      devirtualize_varray(values, [&](const auto &values) {
+        mask.foreach_index([&](const int64_t i) {
+          const float factor = safe_divide(values[i] - from_min_value, from_range);
+          const float result = to_min_value + factor * to_range;
+          results[i] = clamp_ ? clamp_range(result, to_min_value, to_max_value) : result;
+        });
+      });
+      return;
+    }
+
     for (int64_t i : mask) {
       float factor = safe_divide(values[i] - from_min[i], from_max[i] - from_min[i]);
       results[i] = to_min[i] + factor * (to_max[i] - to_min[i]);
@@ -589,6 +589,8 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-time");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-pretty");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-uuid");
+  BLI_args_print_arg_doc(ba, "--debug-depsgraph-verify");
+  BLI_args_print_arg_doc(ba, "--debug-depsgraph-trace");
   BLI_args_print_arg_doc(ba, "--debug-ghost");
   BLI_args_print_arg_doc(ba, "--debug-gpu");
   BLI_args_print_arg_doc(ba, "--debug-gpu-force-workarounds");
@@ -997,6 +999,9 @@ static const char arg_handle_debug_mode_generic_set_doc_depsgraph_pretty[] =
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph_uuid[] =
     "\n\t"
     "Verify validness of session-wide identifiers assigned to ID datablocks.";
+static const char arg_handle_debug_mode_generic_set_doc_depsgraph_verify[] =
+    "\n\t"
+    "Verify relations of dependency graph which were partially updated against a full rebuild.";
 static const char arg_handle_debug_mode_generic_set_doc_gpu_force_workarounds[] =
     "\n\t"
     "Enable workarounds for typical GPU issues and disable all GPU extensions.";
@@ -1009,6 +1014,29 @@ static int arg_handle_debug_mode_generic_set(int UNUSED(argc),
   return 0;
 }
 
+static const char arg_handle_debug_depsgraph_trace_set_doc[] =
+    "<filename>\n"
+    "\tWrite a timeline of all evaluated dependency graph operations to a file.\n"
+    "\tThe file uses the Chrome trace event format, view it with 'chrome://tracing' or Perfetto.";
+static int arg_handle_debug_depsgraph_trace_set(int argc, const char **argv, void *UNUSED(data))
+{
+  const char *arg_id = "--debug-depsgraph-trace";
+  if (argc > 1) {
+    errno = 0;
+    FILE *fp = BLI_fopen(argv[1], "w");
+    if (fp == NULL) {
+      const char *err_msg = errno ? strerror(errno) : "unknown";
+      printf("\nError: %s '%s %s'.\n", err_msg, arg_id, argv[1]);
+    }
+    else {
+      DEG_debug_trace_begin(fp);
+    }
+    return 1;
+  }
+  printf("\nError: '%s' no args given.\n", arg_id);
+  return 0;
+}
+
 static const char arg_handle_debug_mode_io_doc[] =
     "\n\t"
     "Enable debug messages for I/O (Collada, ...).";
@@ -2198,6 +2226,13 @@ void main_args_setup(bContext *C, bArgs *ba)
                "--debug-depsgraph-uuid",
                CB_EX(arg_handle_debug_mode_generic_set, depsgraph_uuid),
                (void *)G_DEBUG_DEPSGRAPH_UUID);
+  BLI_args_add(ba,
+               NULL,
+               "--debug-depsgraph-verify",
+               CB_EX(arg_handle_debug_mode_generic_set, depsgraph_verify),
+               (void *)G_DEBUG_DEPSGRAPH_VERIFY);
+  BLI_args_add(
+      ba, NULL, "--debug-depsgraph-trace", CB(arg_handle_debug_depsgraph_trace_set), NULL);
   BLI_args_add(ba,
                NULL,
                "--debug-gpu-force-workarounds",
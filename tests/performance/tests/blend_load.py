@@ -22,21 +22,73 @@ def _run(filepath):
     return result
 
 
+def _run_generated(args):
+    import bpy
+    import time
+
+    # Save a file with a few large meshes, so loading it is dominated by reading big arrays
+    # without needing files from the benchmark repository.
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    for i in range(args['num_meshes']):
+        bpy.ops.mesh.primitive_grid_add(x_subdivisions=args['grid_size'],
+                                        y_subdivisions=args['grid_size'],
+                                        location=(i * 3.0, 0.0, 0.0))
+    bpy.ops.wm.save_as_mainfile(filepath=args['filepath'], compress=False)
+    bpy.ops.wm.read_homefile()
+
+    result = _run(args['filepath'])
+    os.remove(args['filepath'])
+    return result
+
+
 class BlendLoadTest(api.Test):
-    def __init__(self, filepath):
+    def __init__(self, filepath, num_threads=0):
         self.filepath = filepath
+        # Zero uses all available threads.
+        self.num_threads = num_threads
 
     def name(self):
+        if self.num_threads:
+            return f"{self.filepath.stem}_{self.num_threads}_threads"
         return self.filepath.stem
 
     def category(self):
         return "blend_load"
 
     def run(self, env, device_id):
-        result, _ = env.run_in_blender(_run, str(self.filepath))
+        blender_args = ['--threads', str(self.num_threads)] if self.num_threads else []
+        result, _ = env.run_in_blender(_run, str(self.filepath), blender_args)
+        return result
+
+
+class BlendLoadGeneratedTest(api.Test):
+    def __init__(self, num_meshes, grid_size, num_threads=0):
+        self.num_meshes = num_meshes
+        self.grid_size = grid_size
+        self.num_threads = num_threads
+
+    def name(self):
+        name = f"generated_meshes_{self.num_meshes}_grid_{self.grid_size}"
+        if self.num_threads:
+            return f"{name}_{self.num_threads}_threads"
+        return name
+
+    def category(self):
+        return "blend_load"
+
+    def run(self, env, device_id):
+        blender_args = ['--threads', str(self.num_threads)] if self.num_threads else []
+        args = {'num_meshes': self.num_meshes,
+                'grid_size': self.grid_size,
+                'filepath': str(env.base_dir / f"{self.name()}.blend")}
+        result, _ = env.run_in_blender(_run_generated, args, blender_args)
         return result
 
 
 def generate(env):
     filepaths = env.find_blend_files('*/*')
-    return [BlendLoadTest(filepath) for filepath in filepaths]
+    # Single threaded variant, to compare against and see how loading scales with threads.
+    return ([BlendLoadTest(filepath) for filepath in filepaths] +
+            [BlendLoadTest(filepath, num_threads=1) for filepath in filepaths] +
+            [BlendLoadGeneratedTest(4, 1000),
+             BlendLoadGeneratedTest(4, 1000, num_threads=1)])
@@ -6,6 +6,7 @@ import os
 
 def _run(args):
     import bpy
+    import os
     import time
 
     device_type = args['device_type']
@@ -17,6 +18,10 @@ def _run(args):
     scene.render.image_settings.file_format = 'PNG'
     scene.cycles.device = 'CPU' if device_type == 'CPU' else 'GPU'
 
+    if args['use_wavefront']:
+        # Read by Cycles when resetting its debug flags for the render.
+        os.environ['CYCLES_CPU_WAVEFRONT'] = '1'
+
     if scene.cycles.use_adaptive_sampling:
         # Render samples specified in file, no other way to measure
         # adaptive sampling performance reliably.
@@ -52,14 +57,17 @@ def _run(args):
 
 
 class CyclesTest(api.Test):
-    def __init__(self, filepath):
+    def __init__(self, filepath, use_wavefront=False):
         self.filepath = filepath
+        self.use_wavefront = use_wavefront
 
     def name(self):
         return self.filepath.stem
 
     def category(self):
-        return "cycles"
+        # Wavefront path tracing is a separate category, to compare it against the
+        # "cycles" category on the CPU device only.
+        return "cycles_wavefront" if self.use_wavefront else "cycles"
 
     def use_device(self):
         return True
@@ -68,8 +76,11 @@ class CyclesTest(api.Test):
         tokens = device_id.split('_')
         device_type = tokens[0]
         device_index = int(tokens[1]) if len(tokens) > 1 else 0
+        if self.use_wavefront and device_type != 'CPU':
+            raise Exception("Wavefront path tracing is only available on the CPU device")
         args = {'device_type': device_type,
                 'device_index': device_index,
+                'use_wavefront': self.use_wavefront,
                 'render_filepath': str(env.log_file.parent / (env.log_file.stem + '.png'))}
 
         _, lines = env.run_in_blender(_run, args, ['--debug-cycles', '--verbose', '2', self.filepath])
@@ -109,4 +120,6 @@ class CyclesTest(api.Test):
 
 def generate(env):
     filepaths = env.find_blend_files('cycles/*')
-    return [CyclesTest(filepath) for filepath in filepaths]
+    return [CyclesTest(filepath, use_wavefront)
+            for use_wavefront in (False, True)
+            for filepath in filepaths]
@@ -0,0 +1,128 @@
+# Apache License, Version 2.0
+
+import api
+import re
+
+
+def _run(args):
+    import bpy
+    import time
+
+    num_objects = args['num_objects']
+    num_modifiers = args['num_modifiers']
+    num_drivers = args['num_drivers']
+
+    # Generate the scene procedurally, so it scales to any number of objects
+    # without having to store huge files in the benchmark repository.
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    view_layer = bpy.context.view_layer
+
+    mesh = bpy.data.meshes.new("Mesh")
+    mesh.from_pydata([(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)], [], [(0, 1, 2, 3)])
+
+    objects = []
+    for i in range(num_objects):
+        ob = bpy.data.objects.new(f"Object{i}", mesh)
+        scene.collection.objects.link(ob)
+        for j in range(num_modifiers):
+            ob.modifiers.new(f"Displace{j}", 'DISPLACE')
+        objects.append(ob)
+
+    # Drivers reference the current frame and a neighbor object, to have both
+    # time source and inter-object relations in the graph.
+    for i in range(num_drivers):
+        ob = objects[i % num_objects]
+        fcurve = ob.driver_add("location", i % 3)
+        driver = fcurve.driver
+        driver.type = 'SCRIPTED'
+        var = driver.variables.new()
+        var.name = "x"
+        var.type = 'TRANSFORMS'
+        var.targets[0].id = objects[(i + 1) % num_objects]
+        var.targets[0].transform_type = 'LOC_Z'
+        driver.expression = "x + frame * 0.01"
+
+    # Build the dependency graph from scratch, and evaluate it for the first time.
+    start_time = time.time()
+    view_layer.update()
+    build_time = time.time() - start_time
+
+    # Update relations: linking a new object tags relations of the scene for rebuild.
+    extra_ob = bpy.data.objects.new("Extra", mesh)
+    start_time = time.time()
+    scene.collection.objects.link(extra_ob)
+    view_layer.update()
+    relations_time = time.time() - start_time
+
+    # Tag all objects, and flush the tags through the graph.
+    start_time = time.time()
+    for ob in objects:
+        ob.update_tag()
+    view_layer.update()
+    tag_flush_time = time.time() - start_time
+
+    # Evaluate frame changes.
+    num_frames = 10
+    start_time = time.time()
+    for frame in range(scene.frame_start + 1, scene.frame_start + 1 + num_frames):
+        scene.frame_set(frame)
+    eval_time = (time.time() - start_time) / num_frames
+
+    result = {'time': build_time,
+              'relations_time': relations_time,
+              'tag_flush_time': tag_flush_time,
+              'eval_time': eval_time}
+    return result
+
+
+# Timings printed by --debug-depsgraph-time, and the result keys they are stored as.
+_phase_timers = (
+    ('nodes_time', re.compile(r'Depsgraph nodes built in ([0-9.]+) seconds')),
+    ('relations_build_time', re.compile(r'Depsgraph relations built in ([0-9.]+) seconds')),
+    ('finalize_time', re.compile(r'Depsgraph finalized in ([0-9.]+) seconds')),
+    ('flush_time', re.compile(r'Depsgraph updates flushed in ([0-9.]+) seconds')),
+)
+
+
+class DepsgraphTest(api.Test):
+    def __init__(self, num_objects, num_modifiers, num_drivers):
+        self.num_objects = num_objects
+        self.num_modifiers = num_modifiers
+        self.num_drivers = num_drivers
+
+    def name(self):
+        return (f"objects_{self.num_objects}"
+                f"_modifiers_{self.num_modifiers}"
+                f"_drivers_{self.num_drivers}")
+
+    def category(self):
+        return "depsgraph"
+
+    def run(self, env, device_id):
+        args = {'num_objects': self.num_objects,
+                'num_modifiers': self.num_modifiers,
+                'num_drivers': self.num_drivers}
+        result, _ = env.run_in_blender(_run, args)
+
+        # Phase timers come from a separate run, since --debug-depsgraph-time also
+        # times every operation and would inflate the timings measured above.
+        _, lines = env.run_in_blender(_run, args, ['--debug-depsgraph-time'])
+
+        # Slowest occurrence of every phase, the first build is the one of interest.
+        for key, pattern in _phase_timers:
+            for line in lines:
+                match = pattern.search(line)
+                if match:
+                    result[key] = max(result.get(key, 0.0), float(match.group(1)))
+
+        return result
+
+
+def generate(env):
+    return [DepsgraphTest(1000, 0, 0),
+            DepsgraphTest(10000, 0, 0),
+            DepsgraphTest(50000, 0, 0),
+            DepsgraphTest(10000, 2, 0),
+            DepsgraphTest(10000, 0, 1000),
+            DepsgraphTest(10000, 2, 10000)]
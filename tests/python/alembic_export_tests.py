@@ -463,6 +463,108 @@ class UVMapExportTest(AbstractAlembicTest):
         ])
 
 
+class ConcurrentFramesExportTest(AbstractAlembicTest):
+    """Tests that evaluating frames concurrently gives the same result as evaluating them in order.
+
+    The scene is generated by the script, and both exports are imported again to compare the
+    evaluated results frame by frame.
+    """
+
+    script = """
+import bpy
+from math import isclose
+
+FRAMES = range(1, 9)
+
+
+def build_scene():
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    collection = scene.collection
+
+    # Two bone IK chain following an animated target, with a mesh parented to the tip bone.
+    target = bpy.data.objects.new('Target', None)
+    collection.objects.link(target)
+    for frame, location in ((1, (0.0, 1.0, 1.0)), (8, (1.0, -0.5, 1.5))):
+        target.location = location
+        target.keyframe_insert('location', frame=frame)
+
+    armature = bpy.data.objects.new('Armature', bpy.data.armatures.new('Armature'))
+    collection.objects.link(armature)
+    bpy.context.view_layer.objects.active = armature
+    bpy.ops.object.mode_set(mode='EDIT')
+    upper = armature.data.edit_bones.new('Upper')
+    upper.head, upper.tail = (0.0, 0.0, 0.0), (0.0, 0.0, 1.0)
+    lower = armature.data.edit_bones.new('Lower')
+    lower.head, lower.tail = (0.0, 0.0, 1.0), (0.0, 0.1, 2.0)
+    lower.parent = upper
+    lower.use_connect = True
+    bpy.ops.object.mode_set(mode='OBJECT')
+
+    ik = armature.pose.bones['Lower'].constraints.new('IK')
+    ik.target = target
+    ik.chain_count = 2
+
+    tip_mesh = bpy.data.meshes.new('Tip')
+    tip_mesh.from_pydata([(0.0, 0.0, 0.0), (0.1, 0.0, 0.0), (0.0, 0.1, 0.0)], [], [(0, 1, 2)])
+    tip = bpy.data.objects.new('Tip', tip_mesh)
+    collection.objects.link(tip)
+    tip.parent = armature
+    tip.parent_type = 'BONE'
+    tip.parent_bone = 'Lower'
+
+    # The build modifier depends on the frame of the evaluated scene.
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=10, y_subdivisions=10, size=2.0)
+    grid = bpy.context.active_object
+    grid.name = 'Grid'
+    build = grid.modifiers.new('Build', 'BUILD')
+    build.frame_start = 0
+    build.frame_duration = 10
+
+
+def sample(filepath):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.wm.alembic_import(filepath=filepath, as_background_job=False)
+    scene = bpy.context.scene
+    result = []
+    for frame in FRAMES:
+        scene.frame_set(frame)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        tip = bpy.data.objects['Tip'].evaluated_get(depsgraph)
+        grid = bpy.data.objects['Grid'].evaluated_get(depsgraph)
+        num_polygons = len(grid.to_mesh().polygons)
+        grid.to_mesh_clear()
+        result.append((tip.matrix_world.copy(), num_polygons))
+    return result
+
+
+build_scene()
+bpy.ops.wm.alembic_export(filepath='{serial}', start=FRAMES.start, end=FRAMES.stop - 1,
+                          as_background_job=False)
+bpy.ops.wm.alembic_export(filepath='{concurrent}', start=FRAMES.start, end=FRAMES.stop - 1,
+                          use_concurrent_frames=True, as_background_job=False)
+
+serial = sample('{serial}')
+concurrent = sample('{concurrent}')
+
+assert len(set(num_polygons for _, num_polygons in serial)) > 1, 'Grid is not animated'
+assert len(set(tuple(matrix.translation) for matrix, _ in serial)) > 1, 'Tip is not animated'
+
+for frame, (expect, actual) in zip(FRAMES, zip(serial, concurrent)):
+    assert expect[1] == actual[1], f'Frame {{frame}}: {{actual[1]}} != {{expect[1]}} polygons'
+    for expect_row, actual_row in zip(expect[0], actual[0]):
+        for exp, act in zip(expect_row, actual_row):
+            assert isclose(exp, act, abs_tol=1e-5), \
+                f'Frame {{frame}}: {{actual[0]}} != {{expect[0]}}'
+"""
+
+    @with_tempdir
+    def test_armature_ik(self, tempdir: pathlib.Path):
+        script = self.script.format(serial=(tempdir / 'serial.abc').as_posix(),
+                                    concurrent=(tempdir / 'concurrent.abc').as_posix())
+        self.run_blender('', script)
+
+
 class LongNamesExportTest(AbstractAlembicTest):
     @with_tempdir
     def test_export_long_names(self, tempdir: pathlib.Path):
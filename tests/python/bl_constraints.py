@@ -439,6 +439,131 @@ class CopyTransformsTest(AbstractConstraintTests):
         )))
 
 
+class ConstraintStackUpdateTest(AbstractConstraintTests):
+    """Changes to the constraint stack by operators should reach the evaluated object."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        collection = bpy.context.scene.collection
+
+        for name, location in (('Target A', (1.0, 0.0, 0.0)), ('Target B', (0.0, 2.0, 0.0))):
+            target = bpy.data.objects.new(name, None)
+            target.location = location
+            collection.objects.link(target)
+
+        owner = bpy.data.objects.new('Stack.owner', None)
+        collection.objects.link(owner)
+        for name, target_name in (('Copy A', 'Target A'), ('Copy B', 'Target B')):
+            constraint = owner.constraints.new('COPY_LOCATION')
+            constraint.name = name
+            constraint.target = bpy.data.objects[target_name]
+
+    def test_move_up(self):
+        """Constraint stack: moving a constraint up through an operator."""
+        self.assertEqual(self.matrix('Stack.owner').translation, (0.0, 2.0, 0.0))
+
+        context = self.constraint_context('Copy B', owner_name='Stack.owner')
+        bpy.ops.constraint.move_up(context, constraint='Copy B', owner='OBJECT')
+
+        ob_eval = self._get_eval_object('Stack.owner')
+        self.assertEqual([con.name for con in ob_eval.constraints], ['Copy B', 'Copy A'])
+        self.assertEqual(ob_eval.matrix_world.translation, (1.0, 0.0, 0.0))
+
+
+class TargetMatrixReuseTest(AbstractConstraintTests):
+    """Target matrices reused by following constraints of a stack give the same result as
+    computing them again for every constraint."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        scene = bpy.context.scene
+
+        armature = bpy.data.armatures.new('Rig')
+        rig = bpy.data.objects.new('Rig', armature)
+        rig.location = (0.0, 0.0, 5.0)
+        scene.collection.objects.link(rig)
+        bpy.context.view_layer.objects.active = rig
+
+        bpy.ops.object.mode_set(mode='EDIT')
+        bone = armature.edit_bones.new('Bone')
+        bone.head = (0.0, 0.0, 0.0)
+        bone.tail = (0.0, 2.0, 0.0)
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+        pose_bone = rig.pose.bones['Bone']
+        pose_bone.location = (1.0, 0.0, 0.0)
+        pose_bone.rotation_mode = 'XYZ'
+        pose_bone.rotation_euler = (0.3, 0.0, 0.7)
+
+        # Constraint with a different target, which does not change the owner.
+        self.other = bpy.data.objects.new('Other', None)
+        self.other.location = (3.0, 3.0, 3.0)
+        scene.collection.objects.link(self.other)
+
+    def add_owner(self, name: str) -> bpy.types.Object:
+        owner = bpy.data.objects.new(name, None)
+        bpy.context.scene.collection.objects.link(owner)
+        return owner
+
+    def add_bone_constraint(self, owner, constraint_type: str, **settings):
+        con = owner.constraints.new(constraint_type)
+        con.target = bpy.data.objects['Rig']
+        con.subtarget = 'Bone'
+        for key, value in settings.items():
+            setattr(con, key, value)
+        return con
+
+    def add_other_constraint(self, owner):
+        """Constraint which computes the matrix of another target without changing the owner,
+        so the bone target matrix is computed again by the following constraint."""
+        con = owner.constraints.new('COPY_LOCATION')
+        con.target = self.other
+        con.use_x = con.use_y = con.use_z = False
+
+    def assert_same_result(self, cached: str, recomputed: str):
+        self.assert_matrix(self.matrix(cached), self.matrix(recomputed), cached, delta=1e-5)
+
+    def test_same_target(self):
+        """Constraints with identical targets share the target matrix."""
+        cached = self.add_owner('Cached')
+        self.add_bone_constraint(cached, 'COPY_LOCATION')
+        self.add_bone_constraint(cached, 'COPY_ROTATION')
+
+        recomputed = self.add_owner('Recomputed')
+        self.add_bone_constraint(recomputed, 'COPY_LOCATION')
+        self.add_other_constraint(recomputed)
+        self.add_bone_constraint(recomputed, 'COPY_ROTATION')
+
+        self.assert_same_result('Cached', 'Recomputed')
+
+    def test_head_tail(self):
+        """Targets differing only in head/tail do not share the target matrix."""
+        cached = self.add_owner('Cached')
+        self.add_bone_constraint(cached, 'COPY_LOCATION', head_tail=0.0)
+        self.add_bone_constraint(cached, 'COPY_LOCATION', head_tail=1.0)
+
+        recomputed = self.add_owner('Recomputed')
+        self.add_bone_constraint(recomputed, 'COPY_LOCATION', head_tail=1.0)
+
+        self.assert_same_result('Cached', 'Recomputed')
+        # The tail of the posed bone, not its head.
+        self.assertNotAlmostEqual((self.matrix('Cached').translation -
+                                   self.bone_matrix('Rig', 'Bone').translation).length, 0.0)
+
+    def test_target_space(self):
+        """Targets differing only in target space do not share the target matrix."""
+        for first, second in (('LOCAL', 'WORLD'), ('WORLD', 'LOCAL')):
+            with self.subTest(first=first, second=second):
+                cached = self.add_owner(f'Cached.{first}')
+                self.add_bone_constraint(cached, 'COPY_LOCATION', target_space=first)
+                self.add_bone_constraint(cached, 'COPY_LOCATION', target_space=second)
+
+                recomputed = self.add_owner(f'Recomputed.{first}')
+                self.add_bone_constraint(recomputed, 'COPY_LOCATION', target_space=second)
+
+                self.assert_same_result(f'Cached.{first}', f'Recomputed.{first}')
+
+
 def main():
     global args
     import argparse
@@ -178,6 +178,25 @@ class TestIdRename(TestHelper, unittest.TestCase):
         self.ensure_proper_order()
 
 
+class TestIdUpdateTag(unittest.TestCase):
+
+    def test_object_update_tag(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        ob = bpy.data.objects.new("UpdateTag", None)
+        bpy.context.scene.collection.objects.link(ob)
+        ob["prop"] = 1.0
+
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        self.assertEqual(ob.evaluated_get(depsgraph)["prop"], 1.0)
+
+        # Changes done without going through property updates are only to be seen by the evaluated
+        # object after an explicit tag, even if it only mentions the object transform.
+        ob["prop"] = 2.0
+        ob.update_tag(refresh={'OBJECT'})
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        self.assertEqual(ob.evaluated_get(depsgraph)["prop"], 2.0)
+
+
 if __name__ == '__main__':
     import sys
     sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
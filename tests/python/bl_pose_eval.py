@@ -0,0 +1,184 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+blender -b -noaudio --factory-startup --python tests/python/bl_pose_eval.py
+"""
+
+import unittest
+from math import radians
+
+import bpy
+from mathutils import Matrix
+
+
+class PoseMatrixTest(unittest.TestCase):
+    """Pose matrices of unchanged bones are kept between evaluations, changes of the armature
+    should still be taken into account."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+
+        armature = bpy.data.armatures.new('Armature')
+        self.ob = bpy.data.objects.new('Armature', armature)
+        bpy.context.scene.collection.objects.link(self.ob)
+        bpy.context.view_layer.objects.active = self.ob
+
+        bpy.ops.object.mode_set(mode='EDIT')
+        parent = armature.edit_bones.new('Parent')
+        parent.head = (0.0, 0.0, 0.0)
+        parent.tail = (0.0, 1.0, 0.0)
+        child = armature.edit_bones.new('Child')
+        child.head = (0.0, 1.0, 0.0)
+        child.tail = (0.0, 2.0, 0.0)
+        child.parent = parent
+        child.use_connect = True
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+        self.ob.pose.bones['Parent'].rotation_mode = 'XYZ'
+        self.ob.pose.bones['Parent'].rotation_euler = (0.0, 0.0, radians(90.0))
+
+    def pose_matrix(self, bone_name: str) -> Matrix:
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        ob_eval = self.ob.evaluated_get(depsgraph)
+        return ob_eval.pose.bones[bone_name].matrix.copy()
+
+    def assert_matrix(self, actual: Matrix, expect: Matrix):
+        for act_row, exp_row in zip(actual, expect):
+            for act, exp in zip(act_row, exp_row):
+                self.assertAlmostEqual(act, exp, places=5, msg=f'{actual} != {expect}')
+
+    def test_inherit_rotation(self):
+        """Pose matrix of a bone follows changes of its inherit rotation setting."""
+        self.assert_matrix(self.pose_matrix('Child'), Matrix((
+            (0.0, -1.0, 0.0, -1.0),
+            (1.0, 0.0, 0.0, 0.0),
+            (0.0, 0.0, 1.0, 0.0),
+            (0.0, 0.0, 0.0, 1.0),
+        )))
+
+        self.ob.data.bones['Child'].use_inherit_rotation = False
+        self.assert_matrix(self.pose_matrix('Child'), Matrix((
+            (1.0, 0.0, 0.0, -1.0),
+            (0.0, 1.0, 0.0, 0.0),
+            (0.0, 0.0, 1.0, 0.0),
+            (0.0, 0.0, 0.0, 1.0),
+        )))
+
+    def test_rest_pose(self):
+        """Pose matrix of a bone follows changes of the rest pose."""
+        self.pose_matrix('Child')
+
+        bpy.ops.object.mode_set(mode='EDIT')
+        self.ob.data.edit_bones['Child'].tail = (0.0, 1.0, 1.0)
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+        # The child now points up along Z in the rest pose, which the parent rotation does not
+        # change, and its head is still at the rotated tail of the parent.
+        self.assert_matrix(self.pose_matrix('Child'), Matrix((
+            (0.0, 0.0, 1.0, -1.0),
+            (1.0, 0.0, 0.0, 0.0),
+            (0.0, 1.0, 0.0, 0.0),
+            (0.0, 0.0, 0.0, 1.0),
+        )))
+
+
+class SolverChainPoseTest(unittest.TestCase):
+    """Bones parented to the middle of an IK or Spline IK chain follow the pose computed by the
+    solver, also when the forward kinematics of the chain did not change."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+
+        armature = bpy.data.armatures.new('Armature')
+        self.ob = bpy.data.objects.new('Armature', armature)
+        bpy.context.scene.collection.objects.link(self.ob)
+        bpy.context.view_layer.objects.active = self.ob
+
+        bpy.ops.object.mode_set(mode='EDIT')
+        parent = None
+        for i, name in enumerate(('Root', 'Mid', 'Tip')):
+            bone = armature.edit_bones.new(name)
+            bone.head = (0.0, float(i), 0.0)
+            bone.tail = (0.0, float(i + 1), 0.0)
+            bone.parent = parent
+            bone.use_connect = parent is not None
+            parent = bone
+        helper = armature.edit_bones.new('Helper')
+        helper.head = (1.0, 1.5, 0.0)
+        helper.tail = (1.0, 2.5, 0.0)
+        helper.parent = armature.edit_bones['Mid']
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+    def pose_bone_eval(self, bone_name: str):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        ob_eval = self.ob.evaluated_get(depsgraph)
+        return ob_eval.pose.bones[bone_name]
+
+    def assert_helper_follows_mid(self):
+        mid = self.pose_bone_eval('Mid')
+        helper = self.pose_bone_eval('Helper')
+        expect = mid.matrix @ mid.bone.matrix_local.inverted() @ helper.bone.matrix_local
+        for act_row, exp_row in zip(helper.matrix, expect):
+            for act, exp in zip(act_row, exp_row):
+                self.assertAlmostEqual(act, exp, places=4, msg=f'{helper.matrix} != {expect}')
+
+    def check_influence_change(self, constraint):
+        constraint.influence = 0.0
+        mid_fk = self.pose_bone_eval('Mid').matrix.copy()
+        self.assert_helper_follows_mid()
+
+        # The chain channels did not change, only the solver moves the middle bone.
+        constraint.influence = 1.0
+        mid_solved = self.pose_bone_eval('Mid').matrix.copy()
+        self.assertNotEqual(mid_fk, mid_solved)
+        self.assert_helper_follows_mid()
+
+    def test_ik(self):
+        target = bpy.data.objects.new('Target', None)
+        target.location = (2.0, 1.0, 0.0)
+        bpy.context.scene.collection.objects.link(target)
+
+        constraint = self.ob.pose.bones['Tip'].constraints.new('IK')
+        constraint.target = target
+        constraint.chain_count = 3
+        self.check_influence_change(constraint)
+
+    def test_spline_ik(self):
+        curve = bpy.data.curves.new('Curve', 'CURVE')
+        curve.dimensions = '3D'
+        spline = curve.splines.new('POLY')
+        spline.points.add(2)
+        spline.points[0].co = (0.0, 0.0, 0.0, 1.0)
+        spline.points[1].co = (1.5, 1.5, 0.0, 1.0)
+        spline.points[2].co = (3.0, 1.5, 0.0, 1.0)
+        curve_ob = bpy.data.objects.new('Curve', curve)
+        bpy.context.scene.collection.objects.link(curve_ob)
+
+        constraint = self.ob.pose.bones['Tip'].constraints.new('SPLINE_IK')
+        constraint.target = curve_ob
+        constraint.chain_count = 3
+        self.check_influence_change(constraint)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
@@ -0,0 +1,125 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+blender -b -noaudio --factory-startup --python tests/python/cycles_light_tree.py -- --output-dir /tmp
+"""
+
+import os
+import sys
+import unittest
+
+import bpy
+
+
+OUTPUT_DIR = None
+
+
+class LightTreeRenderTest(unittest.TestCase):
+    """Rendering with the light tree converges to the same image as sampling the lights uniformly,
+    also for distributions of lights that build a deep tree."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+
+        scene = bpy.context.scene
+        scene.render.engine = 'CYCLES'
+        scene.render.resolution_x = 32
+        scene.render.resolution_y = 32
+        scene.render.resolution_percentage = 100
+        scene.render.image_settings.file_format = 'OPEN_EXR'
+        scene.cycles.samples = 256
+        scene.cycles.use_denoising = False
+        scene.cycles.light_sampling_threshold = 0.0
+        scene.cycles.max_bounces = 0
+
+        camera = bpy.data.objects.new('Camera', bpy.data.cameras.new('Camera'))
+        camera.data.type = 'ORTHO'
+        camera.data.ortho_scale = 8.0
+        camera.location = (0.0, 0.0, 10.0)
+        scene.collection.objects.link(camera)
+        scene.camera = camera
+
+        bpy.ops.mesh.primitive_plane_add(size=8.0)
+
+    def add_point_light(self, index: int, location, energy: float):
+        light = bpy.data.lights.new('Light%d' % index, 'POINT')
+        light.energy = energy
+        light.shadow_soft_size = 0.0
+        ob = bpy.data.objects.new('Light%d' % index, light)
+        ob.location = location
+        bpy.context.scene.collection.objects.link(ob)
+
+    def render_mean(self, use_light_tree: bool) -> float:
+        scene = bpy.context.scene
+        scene.cycles.use_light_tree = use_light_tree
+        scene.render.filepath = os.path.join(
+            OUTPUT_DIR, 'cycles_light_tree_%s.exr' % ('on' if use_light_tree else 'off'))
+        bpy.ops.render.render(write_still=True)
+
+        image = bpy.data.images.load(scene.render.filepath)
+        pixels = image.pixels[:]
+        bpy.data.images.remove(image)
+
+        num_pixels = len(pixels) // 4
+        return sum(pixels[i * 4] for i in range(num_pixels)) / num_pixels
+
+    def assert_light_tree_matches(self):
+        mean_off = self.render_mean(False)
+        mean_on = self.render_mean(True)
+        self.assertGreater(mean_off, 0.0)
+        self.assertAlmostEqual(mean_on / mean_off, 1.0, delta=0.05)
+
+    def test_grid(self):
+        index = 0
+        for x in range(-4, 4):
+            for y in range(-4, 4):
+                self.add_point_light(index, (x + 0.5, y + 0.5, 1.0), 10.0)
+                index += 1
+        self.assert_light_tree_matches()
+
+    def test_skewed(self):
+        # Exponentially spaced lights only peel off a few lights per split of the tree.
+        for i in range(64):
+            self.add_point_light(i, (-3.0 + 2.0 ** (i - 60), 0.0, 1.0 + i * 0.01), 10.0)
+        self.assert_light_tree_matches()
+
+
+def main():
+    global OUTPUT_DIR
+
+    import argparse
+
+    argv = [sys.argv[0]]
+    if '--' in sys.argv:
+        argv += sys.argv[sys.argv.index('--') + 1:]
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--output-dir', dest='output_dir', type=str, required=True)
+    args, remaining = parser.parse_known_args(argv)
+
+    OUTPUT_DIR = args.output_dir
+    os.makedirs(OUTPUT_DIR, exist_ok=True)
+
+    unittest.main(argv=remaining)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,163 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+blender -b -noaudio --factory-startup --python tests/python/cycles_wavefront.py -- --output-dir /tmp
+"""
+
+import os
+import sys
+import unittest
+
+import bpy
+
+
+OUTPUT_DIR = None
+
+
+class WavefrontRenderTest(unittest.TestCase):
+    """Rendering on the CPU in wavefront mode gives the same image as the megakernel, also when a
+    path is split by the shadow catcher and when adaptive sampling stops pixels of a batch."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+
+        # The wavefront mode is a debug option, only used with the Cycles debug preferences.
+        prefs = bpy.context.preferences
+        prefs.view.show_developer_ui = True
+        prefs.experimental.use_cycles_debug = True
+
+        scene = bpy.context.scene
+        scene.render.engine = 'CYCLES'
+        scene.cycles.device = 'CPU'
+        # Not a multiple of the batch size of the wavefront mode, so the last batch is smaller.
+        scene.render.resolution_x = 40
+        scene.render.resolution_y = 40
+        scene.render.resolution_percentage = 100
+        scene.render.image_settings.file_format = 'OPEN_EXR'
+        scene.render.image_settings.color_depth = '32'
+        scene.cycles.samples = 64
+        scene.cycles.use_adaptive_sampling = False
+        scene.cycles.use_denoising = False
+
+        world = bpy.data.worlds.new('World')
+        world.color = (0.5, 0.5, 0.5)
+        scene.world = world
+
+        camera = bpy.data.objects.new('Camera', bpy.data.cameras.new('Camera'))
+        camera.location = (0.0, -6.0, 4.0)
+        camera.rotation_euler = (0.98, 0.0, 0.0)
+        scene.collection.objects.link(camera)
+        scene.camera = camera
+
+        light = bpy.data.lights.new('Light', 'AREA')
+        light.energy = 500.0
+        light.size = 2.0
+        light_ob = bpy.data.objects.new('Light', light)
+        light_ob.location = (2.0, -1.0, 4.0)
+        scene.collection.objects.link(light_ob)
+
+        bpy.ops.mesh.primitive_plane_add(size=20.0)
+        self.ground = bpy.context.active_object
+        bpy.ops.mesh.primitive_cube_add(size=1.5, location=(0.0, 0.0, 0.75))
+
+    def render_pass(self, use_wavefront: bool, pass_name: str) -> list:
+        scene = bpy.context.scene
+        scene.cycles.debug_use_cpu_wavefront = use_wavefront
+
+        # Write the pass through the compositor, to read it back from a single layer image.
+        scene.use_nodes = True
+        scene.render.use_compositing = True
+        tree = scene.node_tree
+        tree.nodes.clear()
+        render_layers = tree.nodes.new('CompositorNodeRLayers')
+        composite = tree.nodes.new('CompositorNodeComposite')
+        tree.links.new(render_layers.outputs[pass_name], composite.inputs['Image'])
+
+        scene.render.filepath = os.path.join(
+            OUTPUT_DIR, 'cycles_wavefront_%s_%s_%s.exr' % (
+                self.id().split('.')[-1],
+                pass_name.lower().replace(' ', '_'),
+                'on' if use_wavefront else 'off'))
+        bpy.ops.render.render(write_still=True)
+
+        image = bpy.data.images.load(scene.render.filepath)
+        pixels = image.pixels[:]
+        bpy.data.images.remove(image)
+        return pixels
+
+    def assert_wavefront_matches(self, pass_name: str) -> list:
+        pixels_off = self.render_pass(False, pass_name)
+        pixels_on = self.render_pass(True, pass_name)
+        self.assertEqual(len(pixels_off), len(pixels_on))
+        self.assertGreater(max(pixels_off), 0.0)
+
+        # Paths are traced with the same kernels and samples, only the order in which they
+        # accumulate into the same pixel may differ.
+        for i, (value_off, value_on) in enumerate(zip(pixels_off, pixels_on)):
+            self.assertAlmostEqual(value_on, value_off, delta=1e-4 * max(1.0, abs(value_off)),
+                                   msg="pixel %d, channel %d" % (i // 4, i % 4))
+        return pixels_off
+
+    def test_shadow_catcher(self):
+        # Camera rays hitting the shadow catcher continue as two paths per pixel.
+        scene = bpy.context.scene
+        scene.render.film_transparent = True
+        self.ground.is_shadow_catcher = True
+        scene.view_layers[0].cycles.use_pass_shadow_catcher = True
+
+        self.assert_wavefront_matches('Image')
+        self.assert_wavefront_matches('Shadow Catcher')
+
+    def test_adaptive_sampling(self):
+        # The uniform background converges early, so that pixels of the same batch stop sampling
+        # at different times.
+        scene = bpy.context.scene
+        scene.cycles.samples = 256
+        scene.cycles.use_adaptive_sampling = True
+        scene.cycles.adaptive_threshold = 0.05
+        scene.view_layers[0].cycles.pass_debug_sample_count = True
+
+        self.assert_wavefront_matches('Image')
+        sample_count = self.assert_wavefront_matches('Debug Sample Count')[0::4]
+        self.assertLess(min(sample_count), max(sample_count))
+
+
+def main():
+    global OUTPUT_DIR
+
+    import argparse
+
+    argv = [sys.argv[0]]
+    if '--' in sys.argv:
+        argv += sys.argv[sys.argv.index('--') + 1:]
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--output-dir', dest='output_dir', type=str, required=True)
+    args, remaining = parser.parse_known_args(argv)
+
+    OUTPUT_DIR = args.output_dir
+    os.makedirs(OUTPUT_DIR, exist_ok=True)
+
+    unittest.main(argv=remaining)
+
+
+if __name__ == '__main__':
+    main()